@@ -0,0 +1,86 @@
+#include <cinttypes>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "cista/containers/hash_map.h"
+
+using map_t = cista::raw::hash_map<std::uint64_t, std::uint64_t>;
+
+// Hash flooding check: the fuzzer chooses the keys, the map uses a seed
+// the input cannot control. The number of groups probed to find any key
+// must stay small.
+constexpr auto const MAX_PROBE_LENGTH = map_t::size_type{32U};
+
+map_t::size_type probe_length(map_t const& m, std::uint64_t const key) {
+  auto const hash = m.compute_hash(key);
+  auto length = map_t::size_type{1U};
+  for (auto seq = map_t::probe_seq{map_t::h1(hash), m.capacity_}; true;
+       seq.next(), ++length) {
+    auto const g = map_t::group{m.ctrl_ + seq.offset_};
+    for (auto const i : g.match(map_t::h2(hash))) {
+      if (m.entries_[seq.offset(i)].first == key) {
+        return length;
+      }
+    }
+    if (g.match_empty()) {
+      abort();  // inserted key not found
+    }
+  }
+}
+
+#if defined(GENERATE_SEED)
+int main() {}
+#else
+#if defined(MAIN)
+int main(int argc, char const** argv) {
+  if (argc != 2) {
+    std::cout << "usage: " << argv[0] << " INPUT\n";
+    return 1;
+  }
+
+  auto in = std::ifstream{};
+  in.exceptions(std::ios::failbit | std::ios::badbit);
+  in.open(argv[1], std::ios_base::binary);
+  auto str = std::string{};
+
+  in.seekg(0, std::ios::end);
+  str.reserve(in.tellg());
+  in.seekg(0, std::ios::beg);
+
+  str.assign((std::istreambuf_iterator<char>(in)),
+             std::istreambuf_iterator<char>());
+  auto data = reinterpret_cast<std::uint8_t const*>(str.data());
+  auto const size = str.size();
+#else
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+#endif
+  auto uut = map_t{};
+  uut.set_seed(0x9E3779B97F4A7C15ULL);
+
+  for (auto i = std::size_t{0U}; i + sizeof(std::uint64_t) <= size;
+       i += sizeof(std::uint64_t)) {
+    auto key = std::uint64_t{0U};
+    std::memcpy(&key, data + i, sizeof(key));
+    uut.emplace(key, i);
+  }
+
+  auto max_probe_length = map_t::size_type{0U};
+  for (auto const& [key, value] : uut) {
+    max_probe_length = std::max(max_probe_length, probe_length(uut, key));
+  }
+
+#if defined(MAIN)
+  std::cout << "size=" << uut.size() << ", capacity=" << uut.capacity()
+            << ", max probe length=" << max_probe_length << "\n";
+#endif
+
+  if (max_probe_length > MAX_PROBE_LENGTH) {
+    abort();
+  }
+
+  return 0;
+}
+#endif
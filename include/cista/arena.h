@@ -0,0 +1,192 @@
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "cista/aligned_alloc.h"
+#include "cista/containers/offset_ptr.h"
+#include "cista/unused_param.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Contiguous block of reserved address space for data structures with
+// narrow offset pointers (`cista::offset32`). A 32 bit offset can only reach
+// targets within +/-2 GiB of the pointer itself, which heap and stack
+// memory do not guarantee. Inside one arena, every offset fits.
+//
+// Usage (build, then serialize as usual):
+//   auto a = cista::arena{};
+//   auto& g = a.create<graph>();  // root object has to live in the arena
+//   g.edges_.push_back(...);      // container memory comes from the arena
+//   auto const buf = cista::serialize(g);
+//
+// While alive, the arena is the allocation target for all narrow offset
+// containers of the creating thread (arenas nest; destroy in reverse
+// order). Memory is only committed when used and only released when the
+// arena is destroyed: freeing (e.g. vector growth) does not reuse space.
+// Containers in an arena must not be used after the arena is destroyed.
+// Objects holding narrow offset pointers into the arena can not be moved
+// outside of it (this includes temporaries on the stack, e.g. `std::swap`):
+// assigning such a pointer throws.
+struct arena {
+  static constexpr auto const MAX_CAPACITY =
+      static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+#ifdef _WIN32
+  static constexpr auto const COMMIT_SIZE = std::size_t{1U} << 20U;
+#endif
+
+  explicit arena(std::size_t const capacity = MAX_CAPACITY)
+      : capacity_{capacity}, prev_{current()} {
+    verify(capacity_ <= MAX_CAPACITY, "arena: capacity too large");
+#ifdef _WIN32
+    mem_ = static_cast<std::uint8_t*>(
+        VirtualAlloc(nullptr, capacity_, MEM_RESERVE, PAGE_READWRITE));
+    verify(mem_ != nullptr, "arena: reserve failed");
+#else
+    auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    auto const mem =
+        ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, flags, -1, 0);
+    verify(mem != MAP_FAILED, "arena: reserve failed");
+    mem_ = static_cast<std::uint8_t*>(mem);
+#endif
+    current() = this;
+  }
+
+  ~arena() {
+    current() = prev_;
+#ifdef _WIN32
+    VirtualFree(mem_, 0U, MEM_RELEASE);
+#else
+    ::munmap(mem_, capacity_);
+#endif
+  }
+
+  arena(arena const&) = delete;
+  arena(arena&&) = delete;
+  arena& operator=(arena const&) = delete;
+  arena& operator=(arena&&) = delete;
+
+  static arena*& current() noexcept {
+    thread_local arena* a = nullptr;
+    return a;
+  }
+
+  void* allocate(std::size_t const size, std::size_t const alignment) {
+    auto const start = (used_ + alignment - 1U) / alignment * alignment;
+    verify(start <= capacity_ && size <= capacity_ - start,
+           "arena: out of memory");
+#ifdef _WIN32
+    if (start + size > committed_) {
+      auto const commit_to = std::min(
+          capacity_, (start + size + COMMIT_SIZE - 1U) / COMMIT_SIZE *
+                         COMMIT_SIZE);
+      verify(VirtualAlloc(mem_ + committed_, commit_to - committed_,
+                          MEM_COMMIT, PAGE_READWRITE) != nullptr,
+             "arena: commit failed");
+      committed_ = commit_to;
+    }
+#endif
+    used_ = start + size;
+    return mem_ + start;
+  }
+
+  template <typename T, typename... Args>
+  T& create(Args&&... args) {
+    return *new (allocate(sizeof(T), alignof(T)))
+        T{std::forward<Args>(args)...};
+  }
+
+  // Gives back the most recent allocation (stack order). No-op otherwise.
+  void deallocate(void* p, std::size_t const size) noexcept {
+    auto const x = static_cast<std::uint8_t*>(p);
+    if (x + size == mem_ + used_) {
+      used_ = static_cast<std::size_t>(x - mem_);
+    }
+  }
+
+  bool contains(void const* p) const noexcept {
+    auto const x = reinterpret_cast<std::uintptr_t>(p);
+    auto const from = reinterpret_cast<std::uintptr_t>(mem_);
+    return x >= from && x < from + used_;
+  }
+
+  std::size_t size() const noexcept { return used_; }
+  std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+  std::uint8_t* mem_{nullptr};
+  std::size_t capacity_{0U}, used_{0U};
+#ifdef _WIN32
+  std::size_t committed_{0U};
+#endif
+  arena* prev_{nullptr};
+};
+
+// Allocation for containers with pointer type `Ptr`: memory for narrow
+// offset pointers comes from the current arena, everything else from the
+// heap (as before).
+template <typename Ptr>
+void* container_malloc(std::size_t const size) {
+  if constexpr (is_narrow_ptr_v<Ptr>) {
+    auto const a = arena::current();
+    verify(a != nullptr, "offset32: no arena");
+    return a->allocate(size, alignof(std::max_align_t));
+  } else {
+    return std::malloc(size);  // NOLINT
+  }
+}
+
+template <typename Ptr>
+void container_free(void* p) noexcept {
+  if constexpr (!is_narrow_ptr_v<Ptr>) {
+    std::free(p);  // NOLINT
+  } else {
+    CISTA_UNUSED_PARAM(p)
+  }
+}
+
+template <typename Ptr>
+void* container_aligned_alloc(std::size_t const alignment,
+                              std::size_t const size) {
+  if constexpr (is_narrow_ptr_v<Ptr>) {
+    auto const a = arena::current();
+    verify(a != nullptr, "offset32: no arena");
+    return a->allocate(size, alignment);
+  } else {
+    return CISTA_ALIGNED_ALLOC(alignment, size);
+  }
+}
+
+template <typename Ptr>
+void container_aligned_free(std::size_t const alignment, void* p) noexcept {
+  CISTA_UNUSED_PARAM(alignment)
+  if constexpr (!is_narrow_ptr_v<Ptr>) {
+    CISTA_ALIGNED_FREE(alignment, p);
+  } else {
+    CISTA_UNUSED_PARAM(p)
+  }
+}
+
+}  // namespace cista
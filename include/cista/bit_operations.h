@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "cista/bit_counting.h"
+
+namespace cista {
+
+// Calls `fn(offset + i)` for every set bit `i` of `word` in ascending order.
+template <typename Fn>
+inline void for_each_set_bit_in_word(std::uint64_t word,
+                                     std::size_t const offset, Fn&& fn) {
+  for (; word != 0U; word &= word - 1U) {
+    fn(offset + trailing_zeros(word));
+  }
+}
+
+// Bulk operations on `n` 64 bit words (used by `bitset` and `basic_bitvec`).
+// The in-place operations are plain loops the compiler vectorizes (AVX2 with
+// -mavx2). The popcount loops use the AVX2 nibble lookup (Mula) if enabled.
+
+inline void words_and(std::uint64_t* a, std::uint64_t const* b,
+                      std::size_t const n) noexcept {
+  for (auto i = std::size_t{0U}; i != n; ++i) {
+    a[i] &= b[i];
+  }
+}
+
+inline void words_or(std::uint64_t* a, std::uint64_t const* b,
+                     std::size_t const n) noexcept {
+  for (auto i = std::size_t{0U}; i != n; ++i) {
+    a[i] |= b[i];
+  }
+}
+
+inline void words_xor(std::uint64_t* a, std::uint64_t const* b,
+                      std::size_t const n) noexcept {
+  for (auto i = std::size_t{0U}; i != n; ++i) {
+    a[i] ^= b[i];
+  }
+}
+
+// a &= ~b
+inline void words_andnot(std::uint64_t* a, std::uint64_t const* b,
+                         std::size_t const n) noexcept {
+  for (auto i = std::size_t{0U}; i != n; ++i) {
+    a[i] &= ~b[i];
+  }
+}
+
+inline bool words_intersect(std::uint64_t const* a, std::uint64_t const* b,
+                            std::size_t const n) noexcept {
+  auto i = std::size_t{0U};
+  for (; i + 4U <= n; i += 4U) {  // branch once per 4 words
+    if (((a[i] & b[i]) | (a[i + 1U] & b[i + 1U]) | (a[i + 2U] & b[i + 2U]) |
+         (a[i + 3U] & b[i + 3U])) != 0U) {
+      return true;
+    }
+  }
+  for (; i != n; ++i) {
+    if ((a[i] & b[i]) != 0U) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#if defined(__AVX2__)
+
+namespace detail {
+
+inline __m256i popcount_bytes(__m256i const v) noexcept {
+  auto const lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  //
+                       0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  auto const low_mask = _mm256_set1_epi8(0x0F);
+  auto const lo = _mm256_and_si256(v, low_mask);
+  auto const hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                         _mm256_shuffle_epi8(lookup, hi));
+}
+
+inline __m256i load_words(std::uint64_t const* a) noexcept {
+  return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a));
+}
+
+// Sum of the popcounts of `get(i)` (words [i, i + 4) as one vector) for all
+// full groups of 4 words. Advances `i` to the first word not counted.
+template <typename Get>
+std::size_t popcount_avx2(std::size_t const n, std::size_t& i, Get&& get) {
+  // Byte counters hold at most 8 per iteration: flush every 31 iterations.
+  auto const zero = _mm256_setzero_si256();
+  auto acc = _mm256_setzero_si256();
+  while (i + 4U <= n) {
+    auto bytes = _mm256_setzero_si256();
+    for (auto k = 0U; k != 31U && i + 4U <= n; ++k, i += 4U) {
+      bytes = _mm256_add_epi8(bytes, popcount_bytes(get(i)));
+    }
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, zero));
+  }
+  return static_cast<std::size_t>(_mm256_extract_epi64(acc, 0)) +
+         static_cast<std::size_t>(_mm256_extract_epi64(acc, 1)) +
+         static_cast<std::size_t>(_mm256_extract_epi64(acc, 2)) +
+         static_cast<std::size_t>(_mm256_extract_epi64(acc, 3));
+}
+
+}  // namespace detail
+
+#endif
+
+inline std::size_t words_count(std::uint64_t const* a,
+                               std::size_t const n) noexcept {
+  auto sum = std::size_t{0U};
+  auto i = std::size_t{0U};
+#if defined(__AVX2__)
+  sum += detail::popcount_avx2(n, i, [&](std::size_t const j) {
+    return detail::load_words(a + j);
+  });
+#endif
+  for (; i != n; ++i) {
+    sum += popcount(a[i]);
+  }
+  return sum;
+}
+
+// popcount(a & b)
+inline std::size_t words_and_count(std::uint64_t const* a,
+                                   std::uint64_t const* b,
+                                   std::size_t const n) noexcept {
+  auto sum = std::size_t{0U};
+  auto i = std::size_t{0U};
+#if defined(__AVX2__)
+  sum += detail::popcount_avx2(n, i, [&](std::size_t const j) {
+    return _mm256_and_si256(detail::load_words(a + j),
+                            detail::load_words(b + j));
+  });
+#endif
+  for (; i != n; ++i) {
+    sum += popcount(a[i] & b[i]);
+  }
+  return sum;
+}
+
+}  // namespace cista
@@ -3,19 +3,36 @@
 #include "cista/containers/array.h"
 #include "cista/containers/bitset.h"
 #include "cista/containers/bitvec.h"
+#include "cista/containers/bloom_filter.h"
+#include "cista/containers/btree.h"
+#include "cista/containers/compressed_index.h"
+#include "cista/containers/concurrent_paged_vecvec.h"
+#include "cista/containers/counting_sort.h"
 #include "cista/containers/cstring.h"
+#include "cista/containers/filtered_hash_map.h"
 #include "cista/containers/fws_multimap.h"
 #include "cista/containers/hash_map.h"
 #include "cista/containers/hash_set.h"
+#include "cista/containers/hash_storage_stats.h"
+#include "cista/containers/mmap_hash_map.h"
 #include "cista/containers/mmap_vec.h"
 #include "cista/containers/mutable_fws_multimap.h"
 #include "cista/containers/nvec.h"
 #include "cista/containers/optional.h"
+#include "cista/containers/packed_vector.h"
 #include "cista/containers/paged.h"
 #include "cista/containers/paged_vecvec.h"
+#include "cista/containers/perfect_hash_map.h"
+#include "cista/containers/rank_select.h"
+#include "cista/containers/roaring.h"
+#include "cista/containers/soa_vector.h"
+#include "cista/containers/split_vector.h"
+#include "cista/containers/static_search_vector.h"
 #include "cista/containers/string.h"
 #include "cista/containers/tuple.h"
 #include "cista/containers/unique_ptr.h"
 #include "cista/containers/variant.h"
 #include "cista/containers/vector.h"
-#include "cista/containers/vecvec.h"
\ No newline at end of file
+#include "cista/containers/vecvec.h"
+#include "cista/containers/vecvec_builder.h"
+#include "cista/containers/xor_filter.h"
\ No newline at end of file
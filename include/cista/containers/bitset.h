@@ -11,6 +11,7 @@
 #include <type_traits>
 
 #include "cista/bit_counting.h"
+#include "cista/bit_operations.h"
 #include "cista/containers/array.h"
 
 namespace cista {
@@ -57,11 +58,35 @@ struct bitset {
   bool operator[](std::size_t const i) const noexcept { return test(i); }
 
   std::size_t count() const noexcept {
-    std::size_t sum = 0U;
-    for (std::size_t i = 0U; i != num_blocks - 1U; ++i) {
-      sum += popcount(blocks_[i]);
+    return words_count(blocks_.data(), num_blocks - 1U) +
+           popcount(sanitized_last_block());
+  }
+
+  // Number of bits set in both `*this` and `o`.
+  std::size_t and_count(bitset const& o) const noexcept {
+    return words_and_count(blocks_.data(), o.blocks_.data(), num_blocks - 1U) +
+           popcount(sanitized_last_block() & o.sanitized_last_block());
+  }
+
+  // Whether `*this` and `o` have a common set bit.
+  bool any_intersection(bitset const& o) const noexcept {
+    return words_intersect(blocks_.data(), o.blocks_.data(), num_blocks - 1U) ||
+           (sanitized_last_block() & o.sanitized_last_block()) != 0U;
+  }
+
+  // *this &= ~o
+  bitset& andnot_inplace(bitset const& o) noexcept {
+    words_andnot(blocks_.data(), o.blocks_.data(), num_blocks);
+    return *this;
+  }
+
+  template <typename Fn>
+  void for_each_set_bit(Fn&& f) const {
+    for (auto i = std::size_t{0U}; i != num_blocks - 1U; ++i) {
+      for_each_set_bit_in_word(blocks_[i], i * bits_per_block, f);
     }
-    return sum + popcount(sanitized_last_block());
+    for_each_set_bit_in_word(sanitized_last_block(),
+                             (num_blocks - 1U) * bits_per_block, f);
   }
 
   constexpr bool test(std::size_t const i) const noexcept {
@@ -153,23 +178,17 @@ struct bitset {
   }
 
   bitset& operator&=(bitset const& o) noexcept {
-    for (auto i = 0U; i < num_blocks; ++i) {
-      blocks_[i] &= o.blocks_[i];
-    }
+    words_and(blocks_.data(), o.blocks_.data(), num_blocks);
     return *this;
   }
 
   bitset& operator|=(bitset const& o) noexcept {
-    for (auto i = 0U; i < num_blocks; ++i) {
-      blocks_[i] |= o.blocks_[i];
-    }
+    words_or(blocks_.data(), o.blocks_.data(), num_blocks);
     return *this;
   }
 
   bitset& operator^=(bitset const& o) noexcept {
-    for (auto i = 0U; i < num_blocks; ++i) {
-      blocks_[i] ^= o.blocks_[i];
-    }
+    words_xor(blocks_.data(), o.blocks_.data(), num_blocks);
     return *this;
   }
 
@@ -11,6 +11,7 @@
 #include <type_traits>
 
 #include "cista/bit_counting.h"
+#include "cista/bit_operations.h"
 #include "cista/containers/vector.h"
 #include "cista/strong.h"
 
@@ -83,11 +84,40 @@ struct basic_bitvec {
   bool operator[](Key const i) const noexcept { return test(i); }
 
   std::size_t count() const noexcept {
-    auto sum = std::size_t{0U};
-    for (auto i = size_type{0U}; i != blocks_.size() - 1; ++i) {
-      sum += popcount(blocks_[i]);
+    if (empty()) {
+      return 0U;
+    }
+    return words_count(blocks_.data(), blocks_.size() - 1U) +
+           popcount(sanitized_last_block());
+  }
+
+  // Number of bits set in both `*this` and `o`.
+  std::size_t and_count(basic_bitvec const& o) const noexcept {
+    assert(size() == o.size());
+    if (empty()) {
+      return 0U;
+    }
+    return words_and_count(blocks_.data(), o.blocks_.data(),
+                           blocks_.size() - 1U) +
+           popcount(sanitized_last_block() & o.sanitized_last_block());
+  }
+
+  // Whether `*this` and `o` have a common set bit.
+  bool any_intersection(basic_bitvec const& o) const noexcept {
+    assert(size() == o.size());
+    if (empty()) {
+      return false;
     }
-    return sum + popcount(sanitized_last_block());
+    return words_intersect(blocks_.data(), o.blocks_.data(),
+                           blocks_.size() - 1U) ||
+           (sanitized_last_block() & o.sanitized_last_block()) != 0U;
+  }
+
+  // *this &= ~o
+  basic_bitvec& andnot_inplace(basic_bitvec const& o) noexcept {
+    assert(size() == o.size());
+    words_andnot(blocks_.data(), o.blocks_.data(), blocks_.size());
+    return *this;
   }
 
   constexpr bool test(Key const i) const noexcept {
@@ -107,13 +137,10 @@ struct basic_bitvec {
       return;
     }
     auto const check_block = [&](size_type const i, block_t const block) {
-      if (block != 0U) {
-        for (auto bit = size_type{0U}; bit != bits_per_block; ++bit) {
-          if ((block & (block_t{1U} << bit)) != 0U) {
-            f(Key{i * bits_per_block + bit});
-          }
-        }
-      }
+      for_each_set_bit_in_word(
+          block, std::size_t{i} * bits_per_block, [&](std::size_t const bit) {
+            f(Key{static_cast<size_type>(bit)});
+          });
     };
     for (auto i = size_type{0U}; i != blocks_.size() - 1; ++i) {
       check_block(i, blocks_[i]);
@@ -217,28 +244,19 @@ struct basic_bitvec {
 
   basic_bitvec& operator&=(basic_bitvec const& o) noexcept {
     assert(size() == o.size());
-
-    for (auto i = 0U; i < blocks_.size(); ++i) {
-      blocks_[i] &= o.blocks_[i];
-    }
+    words_and(blocks_.data(), o.blocks_.data(), blocks_.size());
     return *this;
   }
 
   basic_bitvec& operator|=(basic_bitvec const& o) noexcept {
     assert(size() == o.size());
-
-    for (auto i = 0U; i < blocks_.size(); ++i) {
-      blocks_[i] |= o.blocks_[i];
-    }
+    words_or(blocks_.data(), o.blocks_.data(), blocks_.size());
     return *this;
   }
 
   basic_bitvec& operator^=(basic_bitvec const& o) noexcept {
     assert(size() == o.size());
-
-    for (auto i = 0U; i < blocks_.size(); ++i) {
-      blocks_[i] ^= o.blocks_[i];
-    }
+    words_xor(blocks_.data(), o.blocks_.data(), blocks_.size());
     return *this;
   }
 
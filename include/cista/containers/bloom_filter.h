@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <iterator>
+#include <limits>
+
+#include "cista/containers/vector.h"
+#include "cista/hash.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Split block Bloom filter over 64 bit key hashes: every key sets one bit
+// in each of the 8 words of one 512 bit block, so a lookup reads exactly
+// one block (64 bytes). With the default of 10 bits per key, ~1% of the
+// absent keys are false positives.
+//
+// A default constructed (not built) filter answers `contains` with true.
+//
+// Blocked Bloom filters: Putze, Sanders, Singler - "Cache-, Hash- and
+// Space-Efficient Bloom Filters" (2007)
+template <template <typename> typename Vec>
+struct basic_bloom_filter {
+  static constexpr auto const block_words = 8U;
+  static constexpr auto const block_bits = block_words * 64U;
+
+  // Sets the size for `n` keys and removes all keys.
+  void reserve(std::size_t const n, unsigned const bits_per_key = 10U) {
+    auto const num_blocks =
+        std::max(std::size_t{1U}, (n * bits_per_key + block_bits - 1U) /
+                                      block_bits);
+    verify(num_blocks <= std::numeric_limits<std::uint32_t>::max(),
+           "bloom_filter: too many keys");
+    words_.clear();
+    words_.resize(static_cast<typename Vec<std::uint64_t>::size_type>(
+        num_blocks * block_words));
+  }
+
+  // Replaces the contents with the keys in [first, last) (`get_hash(*it)`).
+  template <typename It, typename GetHash>
+  void build(It first, It last, GetHash&& get_hash,
+             unsigned const bits_per_key = 10U) {
+    reserve(static_cast<std::size_t>(std::distance(first, last)),
+            bits_per_key);
+    for (auto it = first; it != last; ++it) {
+      insert(get_hash(*it));
+    }
+  }
+
+  // Requires a sized filter (`reserve` / `build`).
+  void insert(hash_t const h) {
+    verify(!words_.empty(), "bloom_filter::insert: reserve first");
+    auto const x = hash_mix(h);
+    auto const block = words_.data() + block_start(x);
+    for (auto i = 0U; i != block_words; ++i) {
+      block[i] |= bit(x, i);
+    }
+  }
+
+  bool contains(hash_t const h) const noexcept {
+    if (words_.empty()) {
+      return true;
+    }
+    auto const x = hash_mix(h);
+    auto const block = words_.data() + block_start(x);
+    auto missing = std::uint64_t{0U};
+    for (auto i = 0U; i != block_words; ++i) {
+      missing |= bit(x, i) & ~block[i];
+    }
+    return missing == 0U;
+  }
+
+  std::size_t num_blocks() const noexcept {
+    return words_.size() / block_words;
+  }
+
+  std::size_t size_in_bytes() const noexcept {
+    return words_.size() * sizeof(std::uint64_t);
+  }
+
+  void clear() { words_.clear(); }
+
+  Vec<std::uint64_t> words_;
+
+private:
+  std::size_t block_start(std::uint64_t const x) const noexcept {
+    return static_cast<std::size_t>(((x >> 32U) * num_blocks()) >> 32U) *
+           block_words;
+  }
+
+  // Bit of word `i`: 6 bits of the lower hash half times an odd salt.
+  static constexpr std::uint64_t bit(std::uint64_t const x,
+                                     unsigned const i) noexcept {
+    constexpr std::uint32_t const salts[] = {
+        0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+        0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U};
+    return std::uint64_t{1U}
+           << ((static_cast<std::uint32_t>(x) * salts[i]) >> 26U);
+  }
+};
+
+namespace raw {
+
+using bloom_filter = basic_bloom_filter<vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+using bloom_filter = basic_bloom_filter<vector>;
+
+}  // namespace offset
+
+}  // namespace cista
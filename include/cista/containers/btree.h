@@ -0,0 +1,712 @@
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cista/containers/array.h"
+#include "cista/containers/hash_map.h"
+#include "cista/containers/hash_set.h"
+#include "cista/containers/pair.h"
+#include "cista/containers/vector.h"
+#include "cista/decay.h"
+#include "cista/exception.h"
+#include "cista/reflection/comparable.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Entry of a `btree_map` as seen through a mutable iterator: like
+// `std::flat_map`, the key is read only (changing it would break the
+// order), the value can be modified.
+template <typename Key, typename Value>
+struct btree_map_entry {
+  CISTA_COMPARABLE()
+  auto cista_members() { return std::tie(first, second); }
+  Key const& first;
+  Value& second;
+};
+
+// How mutable iterators expose entries. Default (sets, custom `GetKey`):
+// read only, the whole entry is the key or contains it.
+template <typename T, typename GetKey>
+struct btree_entry_access {
+  using reference = T const&;
+  using pointer = T const*;
+  static reference get(T& e) noexcept { return e; }
+  static pointer address(T& e) noexcept { return &e; }
+};
+
+template <typename Key, typename Value>
+struct btree_entry_access<pair<Key, Value>, get_first> {
+  using reference = btree_map_entry<Key, Value>;
+  struct pointer {
+    reference const* operator->() const noexcept { return &ref_; }
+    reference ref_;
+  };
+  static reference get(pair<Key, Value>& e) noexcept {
+    return {e.first, e.second};
+  }
+  static pointer address(pair<Key, Value>& e) noexcept { return {get(e)}; }
+};
+
+// Ordered container (B+-tree) with nodes stored in two flat vectors
+// (`inner_`, `leaves_`) that reference each other by index. This makes the
+// tree serializable like any other vector based container.
+//   - map: `T` = `pair<Key, Value>`, GetKey = `get_first`
+//   - set: `T` = `Key`, GetKey = `identity`
+//
+// Inner nodes hold `inner_keys` separator keys (~256 bytes of keys) and
+// one child more. Leaves hold up to `leaf_entries` entries and are linked
+// in key order starting at `leaves_[0]`. For arithmetic keys, nodes are
+// searched with a branch free linear scan the compiler can vectorize,
+// otherwise with binary search.
+//
+// Mutable iterators do not allow changing keys: `*it` is `T const&` for
+// sets and a `btree_map_entry` (const key, mutable value) for maps.
+//
+// `erase` does not rebalance: leaves can become underfull. Leaves that
+// become empty are unlinked (together with inner nodes left without
+// children) and put on a free list, later splits reuse them. `bulk_load`
+// rebuilds a compact tree.
+template <typename T, typename GetKey, template <typename> typename Vec,
+          typename Less>
+struct basic_btree {
+  using entry_t = T;
+  using value_type = T;
+  using key_type =
+      decay_t<decltype(std::declval<GetKey>().operator()(std::declval<T>()))>;
+  using size_type = std::uint32_t;
+
+  static constexpr auto const invalid = std::numeric_limits<size_type>::max();
+  static constexpr auto const max_height = 32U;
+
+  static constexpr size_type const inner_keys =
+      std::max(std::size_t{4U}, 256U / sizeof(key_type));
+  static constexpr size_type const leaf_entries =
+      std::max(std::size_t{4U}, 256U / sizeof(T));
+
+  struct inner_node {
+    size_type size_;  // number of keys, children: size_ + 1
+    array<key_type, inner_keys> keys_;
+    array<size_type, inner_keys + 1U> children_;
+  };
+
+  struct leaf_node {
+    size_type size_;
+    size_type next_;
+    array<T, leaf_entries> entries_;
+  };
+
+  template <bool Const>
+  struct iterator_base {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using tree_t = std::conditional_t<Const, basic_btree const, basic_btree>;
+    using access = btree_entry_access<T, GetKey>;
+    using reference =
+        std::conditional_t<Const, T const&, typename access::reference>;
+    using pointer =
+        std::conditional_t<Const, T const*, typename access::pointer>;
+
+    iterator_base() = default;
+    iterator_base(tree_t* t, size_type const leaf, size_type const pos)
+        : tree_{t}, leaf_{leaf}, pos_{pos} {
+      skip_empty();
+    }
+
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    iterator_base(iterator_base<false> const& o)  // NOLINT
+        : tree_{o.tree_}, leaf_{o.leaf_}, pos_{o.pos_} {}
+
+    reference operator*() const {
+      if constexpr (Const) {
+        return entry();
+      } else {
+        return access::get(entry());
+      }
+    }
+
+    pointer operator->() const {
+      if constexpr (Const) {
+        return &entry();
+      } else {
+        return access::address(entry());
+      }
+    }
+
+    iterator_base& operator++() {
+      ++pos_;
+      skip_empty();
+      return *this;
+    }
+
+    iterator_base operator++(int) {
+      auto const tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(iterator_base const& a, iterator_base const& b) {
+      return a.leaf_ == b.leaf_ && a.pos_ == b.pos_;
+    }
+    friend bool operator!=(iterator_base const& a, iterator_base const& b) {
+      return !(a == b);
+    }
+
+    auto& entry() const { return tree_->leaves_[leaf_].entries_[pos_]; }
+
+    // Moves to the next entry if the position is behind the end of a leaf.
+    void skip_empty() {
+      while (leaf_ != invalid && pos_ == tree_->leaves_[leaf_].size_) {
+        leaf_ = tree_->leaves_[leaf_].next_;
+        pos_ = 0U;
+      }
+      if (leaf_ == invalid) {
+        pos_ = 0U;
+      }
+    }
+
+    tree_t* tree_{nullptr};
+    size_type leaf_{invalid};
+    size_type pos_{0U};
+  };
+
+  using iterator = iterator_base<false>;
+  using const_iterator = iterator_base<true>;
+
+  // --- lookup
+
+  template <typename Key>
+  iterator lower_bound(Key const& k) {
+    auto const [leaf, pos] = find_leaf_pos(k);
+    return {this, leaf, pos};
+  }
+
+  template <typename Key>
+  const_iterator lower_bound(Key const& k) const {
+    auto const [leaf, pos] = find_leaf_pos(k);
+    return {this, leaf, pos};
+  }
+
+  template <typename Key>
+  iterator upper_bound(Key const& k) {
+    auto it = lower_bound(k);
+    return it != end() && !Less{}(k, GetKey{}(*it)) ? ++it : it;
+  }
+
+  template <typename Key>
+  const_iterator upper_bound(Key const& k) const {
+    auto it = lower_bound(k);
+    return it != end() && !Less{}(k, GetKey{}(*it)) ? ++it : it;
+  }
+
+  template <typename Key>
+  iterator find(Key const& k) {
+    auto const it = lower_bound(k);
+    return it != end() && !Less{}(k, GetKey{}(*it)) ? it : end();
+  }
+
+  template <typename Key>
+  const_iterator find(Key const& k) const {
+    auto const it = lower_bound(k);
+    return it != end() && !Less{}(k, GetKey{}(*it)) ? it : end();
+  }
+
+  template <typename Key>
+  bool contains(Key const& k) const {
+    return find(k) != end();
+  }
+
+  // Entries with `from <= key < to`.
+  template <typename Key>
+  std::pair<const_iterator, const_iterator> range(Key const& from,
+                                                  Key const& to) const {
+    return {lower_bound(from), lower_bound(to)};
+  }
+
+  template <typename Key>
+  auto& at(Key const& k) {
+    auto const it = find(k);
+    if (it == end()) {
+      throw_exception(std::out_of_range{"btree::at() key not found"});
+    }
+    return it->second;
+  }
+
+  template <typename Key>
+  auto const& at(Key const& k) const {
+    auto const it = find(k);
+    if (it == end()) {
+      throw_exception(std::out_of_range{"btree::at() key not found"});
+    }
+    return it->second;
+  }
+
+  template <typename Key>
+  auto& operator[](Key&& k) {
+    return emplace(T{key_type{std::forward<Key>(k)}, {}}).first->second;
+  }
+
+  // --- modification
+
+  std::pair<iterator, bool> insert(T const& entry) { return emplace(entry); }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return emplace_entry(T{std::forward<Args>(args)...});
+  }
+
+  // Removes the entry with key `k`. Returns the number of removed entries.
+  template <typename Key>
+  std::size_t erase(Key const& k) {
+    if (leaves_.empty()) {
+      return 0U;
+    }
+
+    // Descend, remember the path for unlinking an empty leaf.
+    size_type path[max_height] = {};
+    size_type child[max_height] = {};
+    auto node = root_;
+    for (auto h = size_type{0U}; h != height_; ++h) {
+      auto const& inner = inner_[node];
+      path[h] = node;
+      child[h] = upper_bound_keys(inner.keys_.data(), inner.size_, k);
+      node = inner.children_[child[h]];
+    }
+
+    auto& leaf = leaves_[node];
+    auto const entries = leaf.entries_.data();
+    auto const pos = lower_bound_entries(entries, leaf.size_, k);
+    if (pos == leaf.size_ || Less{}(k, GetKey{}(entries[pos]))) {
+      return 0U;
+    }
+    std::move(entries + pos + 1U, entries + leaf.size_, entries + pos);
+    --leaf.size_;
+    --size_;
+
+    if (size_ == 0U) {
+      clear();
+    } else if (leaf.size_ == 0U) {
+      unlink_leaf(path, child, node);
+    }
+    return 1U;
+  }
+
+  // Replaces the contents with the entries in [first, last), which have to
+  // be sorted by key without duplicates. Entries (and children of inner
+  // nodes) are distributed evenly over the minimal number of nodes.
+  template <typename It>
+  void bulk_load(It first, It last) {
+    clear();
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    if (n == 0U) {
+      return;
+    }
+    verify(n < invalid, "btree::bulk_load: too many entries");
+
+    // Leaves.
+    auto const num_leaves = static_cast<size_type>(
+        (n + leaf_entries - 1U) / leaf_entries);
+    leaves_.resize(num_leaves);
+    auto it = first;
+    T const* prev = nullptr;
+    for (auto l = size_type{0U}; l != num_leaves; ++l) {
+      auto& leaf = leaves_[l];
+      leaf.size_ = share(static_cast<size_type>(n), num_leaves, l);
+      leaf.next_ = l + 1U == num_leaves ? invalid : l + 1U;
+      for (auto i = size_type{0U}; i != leaf.size_; ++i, ++it) {
+        leaf.entries_[i] = *it;
+        verify(prev == nullptr ||
+                   Less{}(GetKey{}(*prev), GetKey{}(leaf.entries_[i])),
+               "btree::bulk_load: input not sorted / not unique");
+        prev = leaf.entries_.data() + i;
+      }
+    }
+    size_ = static_cast<size_type>(n);
+
+    // Inner levels bottom-up: each node groups up to `inner_keys + 1`
+    // nodes of the level below.
+    auto const min_key = [&](size_type node, size_type const height) {
+      for (auto h = height; h != 0U; --h) {
+        node = inner_[node].children_[0U];
+      }
+      return GetKey{}(leaves_[node].entries_[0U]);
+    };
+    auto level_start = size_type{0U};
+    auto level_size = num_leaves;
+    while (level_size > 1U) {
+      auto const next_start = static_cast<size_type>(inner_.size());
+      auto const num_nodes = (level_size + inner_keys) / (inner_keys + 1U);
+      auto child = level_start;
+      for (auto i = size_type{0U}; i != num_nodes; ++i) {
+        auto node = inner_node{};
+        node.size_ = share(level_size, num_nodes, i) - 1U;
+        node.children_[0U] = child++;
+        for (auto k = size_type{0U}; k != node.size_; ++k, ++child) {
+          node.keys_[k] = min_key(child, height_);
+          node.children_[k + 1U] = child;
+        }
+        inner_.emplace_back(std::move(node));
+      }
+      level_start = next_start;
+      level_size = num_nodes;
+      ++height_;
+    }
+    root_ = level_start;
+  }
+
+  void clear() {
+    inner_.clear();
+    leaves_.clear();
+    root_ = 0U;
+    height_ = 0U;
+    size_ = 0U;
+    free_leaves_ = invalid;
+    free_inner_ = invalid;
+  }
+
+  // --- iteration
+
+  iterator begin() { return {this, leaves_.empty() ? invalid : 0U, 0U}; }
+  iterator end() { return {this, invalid, 0U}; }
+  const_iterator begin() const {
+    return {this, leaves_.empty() ? invalid : 0U, 0U};
+  }
+  const_iterator end() const { return {this, invalid, 0U}; }
+
+  friend iterator begin(basic_btree& t) { return t.begin(); }
+  friend iterator end(basic_btree& t) { return t.end(); }
+  friend const_iterator begin(basic_btree const& t) { return t.begin(); }
+  friend const_iterator end(basic_btree const& t) { return t.end(); }
+
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0U; }
+  size_type height() const noexcept { return height_; }
+
+  // Number of keys in `keys[0..n)` that are <= `k`.
+  template <typename Key>
+  static size_type upper_bound_keys(key_type const* keys, size_type const n,
+                                    Key const& k) {
+    if constexpr (is_linear_searchable<Key>()) {
+      auto count = size_type{0U};
+      for (auto i = size_type{0U}; i != n; ++i) {
+        count += keys[i] <= k ? 1U : 0U;
+      }
+      return count;
+    } else {
+      return static_cast<size_type>(
+          std::upper_bound(keys, keys + n, k, Less{}) - keys);
+    }
+  }
+
+  // Number of entries in `entries[0..n)` with a key < `k`.
+  template <typename Key>
+  static size_type lower_bound_entries(T const* entries, size_type const n,
+                                       Key const& k) {
+    if constexpr (is_linear_searchable<Key>()) {
+      auto count = size_type{0U};
+      for (auto i = size_type{0U}; i != n; ++i) {
+        count += GetKey{}(entries[i]) < k ? 1U : 0U;
+      }
+      return count;
+    } else {
+      return static_cast<size_type>(
+          std::lower_bound(entries, entries + n, k,
+                           [](T const& e, Key const& x) {
+                             return Less{}(GetKey{}(e), x);
+                           }) -
+          entries);
+    }
+  }
+
+  Vec<inner_node> inner_;
+  Vec<leaf_node> leaves_;
+  size_type root_{0U};  // `inner_` if height_ != 0, else `leaves_`
+  size_type height_{0U};  // number of inner levels
+  size_type size_{0U};
+  size_type free_leaves_{invalid};  // unused leaves, linked by `next_`
+  size_type free_inner_{invalid};  // unused inner nodes, by `children_[0]`
+
+private:
+  template <typename Key>
+  static constexpr bool is_linear_searchable() {
+    return std::is_arithmetic_v<key_type> && std::is_arithmetic_v<Key> &&
+           std::is_same_v<Less, std::less<key_type>>;
+  }
+
+  // Size of part `i` when splitting `n` into `parts` (almost) equal parts.
+  static size_type share(size_type const n, size_type const parts,
+                         size_type const i) {
+    return n / parts + (i < n % parts ? 1U : 0U);
+  }
+
+  // Leaf and position of the first entry with key >= `k`. The position
+  // can be `size_` of the leaf (=> first entry of the next non-empty leaf).
+  template <typename Key>
+  std::pair<size_type, size_type> find_leaf_pos(Key const& k) const {
+    if (leaves_.empty()) {
+      return {invalid, 0U};
+    }
+    auto node = root_;
+    for (auto h = height_; h != 0U; --h) {
+      auto const& inner = inner_[node];
+      node = inner.children_[upper_bound_keys(inner.keys_.data(),
+                                              inner.size_, k)];
+    }
+    auto const& leaf = leaves_[node];
+    return {node, lower_bound_entries(leaf.entries_.data(), leaf.size_, k)};
+  }
+
+  std::pair<iterator, bool> emplace_entry(T&& entry) {
+    if (leaves_.empty()) {
+      leaves_.emplace_back(leaf_node{0U, invalid, {}});
+      root_ = 0U;
+      height_ = 0U;
+    }
+
+    auto const& k = GetKey{}(entry);
+
+    // Descend, remember the path for splits.
+    size_type path[max_height] = {};
+    size_type node = root_;
+    for (auto h = size_type{0U}; h != height_; ++h) {
+      path[h] = node;
+      auto const& inner = inner_[node];
+      node = inner.children_[upper_bound_keys(inner.keys_.data(),
+                                              inner.size_, k)];
+    }
+
+    auto leaf = node;
+    auto pos =
+        lower_bound_entries(leaves_[leaf].entries_.data(), leaves_[leaf].size_,
+                            k);
+    if (pos != leaves_[leaf].size_ &&
+        !Less{}(k, GetKey{}(leaves_[leaf].entries_[pos]))) {
+      return {iterator{this, leaf, pos}, false};
+    }
+
+    if (leaves_[leaf].size_ == leaf_entries) {
+      // Split: upper half to a new leaf behind `leaf`.
+      auto const right = new_leaf();
+      auto& l = leaves_[leaf];
+      auto& r = leaves_[right];
+      auto const half = leaf_entries / 2U;
+      std::move(l.entries_.data() + half, l.entries_.data() + leaf_entries,
+                r.entries_.data());
+      r.size_ = leaf_entries - half;
+      l.size_ = half;
+      r.next_ = l.next_;
+      l.next_ = right;
+      if (pos > half) {
+        leaf = right;
+        pos -= half;
+      }
+      insert_separator(path, GetKey{}(r.entries_[0]), right);
+    }
+
+    auto& l = leaves_[leaf];
+    std::move_backward(l.entries_.data() + pos, l.entries_.data() + l.size_,
+                       l.entries_.data() + l.size_ + 1U);
+    l.entries_[pos] = std::move(entry);
+    ++l.size_;
+    ++size_;
+    return {iterator{this, leaf, pos}, true};
+  }
+
+  // Inserts separator `key` for the new right sibling `child` of a split
+  // leaf into its parent (`path` = inner nodes from the root), splitting
+  // full inner nodes up to the root.
+  void insert_separator(size_type const* path, key_type key,
+                        size_type child) {
+    for (auto h = height_; h != 0U; --h) {
+      auto const parent = path[h - 1U];
+      auto pos = upper_bound_keys(inner_[parent].keys_.data(),
+                                  inner_[parent].size_, key);
+      if (inner_[parent].size_ != inner_keys) {
+        insert_into(inner_[parent], pos, std::move(key), child);
+        return;
+      }
+
+      // Split: keys [0, half) stay, key half moves up, rest to the right.
+      auto const right = new_inner();
+      auto& p = inner_[parent];
+      auto& r = inner_[right];
+      auto const half = inner_keys / 2U;
+      auto up = std::move(p.keys_[half]);
+      std::move(p.keys_.data() + half + 1U, p.keys_.data() + inner_keys,
+                r.keys_.data());
+      std::copy(p.children_.data() + half + 1U,
+                p.children_.data() + inner_keys + 1U, r.children_.data());
+      r.size_ = inner_keys - half - 1U;
+      p.size_ = half;
+      if (pos <= half) {
+        insert_into(p, pos, std::move(key), child);
+      } else {
+        insert_into(r, pos - half - 1U, std::move(key), child);
+      }
+      key = std::move(up);
+      child = right;
+    }
+
+    // Root split: new root above.
+    auto root = inner_node{};
+    root.size_ = 1U;
+    root.keys_[0] = std::move(key);
+    root.children_[0] = root_;
+    root.children_[1] = child;
+    verify(height_ + 1U < max_height, "btree: too high");
+    root_ = new_inner();
+    inner_[root_] = std::move(root);
+    ++height_;
+  }
+
+  // Removes the empty leaf `leaf` (reached through the inner nodes `path`
+  // taking children `child`) from the tree. Requires another non-empty
+  // leaf, so `height_ != 0`.
+  void unlink_leaf(size_type const* path, size_type const* child,
+                   size_type const leaf) {
+    // Deepest level at which the path has a left sibling.
+    auto left = height_;
+    while (left != 0U && child[left - 1U] == 0U) {
+      --left;
+    }
+
+    if (left != 0U) {
+      // Predecessor: rightmost leaf of the left sibling.
+      auto prev = inner_[path[left - 1U]].children_[child[left - 1U] - 1U];
+      for (auto h = left; h != height_; ++h) {
+        prev = inner_[prev].children_[inner_[prev].size_];
+      }
+      leaves_[prev].next_ = leaves_[leaf].next_;
+      remove_child(path, child);
+      free_leaf(leaf);
+      return;
+    }
+
+    // First leaf: has to stay at index 0 (head of the leaf chain). Move its
+    // successor (leftmost leaf of the deepest right sibling) there.
+    auto right = height_;
+    while (inner_[path[right - 1U]].size_ == 0U) {
+      --right;
+    }
+    auto parent = path[right - 1U];
+    auto pos = size_type{1U};
+    for (auto h = right; h != height_; ++h) {
+      parent = inner_[parent].children_[pos];
+      pos = 0U;
+    }
+    auto const next = inner_[parent].children_[pos];
+    leaves_[leaf] = std::move(leaves_[next]);
+    inner_[parent].children_[pos] = leaf;
+    remove_child(path, child);
+    free_leaf(next);
+  }
+
+  // Removes the child at the end of `path` / `child` and inner nodes left
+  // without children. Shrinks the tree while the root has a single child.
+  void remove_child(size_type const* path, size_type const* child) {
+    for (auto h = height_; h != 0U; --h) {
+      auto& n = inner_[path[h - 1U]];
+      if (n.size_ == 0U) {
+        free_inner(path[h - 1U]);
+        continue;
+      }
+      auto const c = child[h - 1U];
+      auto const key = c == 0U ? 0U : c - 1U;
+      std::move(n.keys_.data() + key + 1U, n.keys_.data() + n.size_,
+                n.keys_.data() + key);
+      std::copy(n.children_.data() + c + 1U, n.children_.data() + n.size_ + 1U,
+                n.children_.data() + c);
+      --n.size_;
+      break;
+    }
+
+    while (height_ != 0U && inner_[root_].size_ == 0U) {
+      auto const root = root_;
+      root_ = inner_[root].children_[0U];
+      free_inner(root);
+      --height_;
+    }
+  }
+
+  size_type new_leaf() {
+    if (free_leaves_ != invalid) {
+      auto const l = free_leaves_;
+      free_leaves_ = leaves_[l].next_;
+      leaves_[l].size_ = 0U;
+      leaves_[l].next_ = invalid;
+      return l;
+    }
+    auto const l = static_cast<size_type>(leaves_.size());
+    verify(l != invalid, "btree: too many leaves");
+    leaves_.emplace_back(leaf_node{0U, invalid, {}});
+    return l;
+  }
+
+  size_type new_inner() {
+    if (free_inner_ != invalid) {
+      auto const n = free_inner_;
+      free_inner_ = inner_[n].children_[0U];
+      inner_[n].size_ = 0U;
+      return n;
+    }
+    auto const n = static_cast<size_type>(inner_.size());
+    verify(n != invalid, "btree: too many inner nodes");
+    inner_.emplace_back(inner_node{});
+    return n;
+  }
+
+  void free_leaf(size_type const l) {
+    leaves_[l].size_ = 0U;
+    leaves_[l].next_ = free_leaves_;
+    free_leaves_ = l;
+  }
+
+  void free_inner(size_type const n) {
+    inner_[n].size_ = 0U;
+    inner_[n].children_[0U] = free_inner_;
+    free_inner_ = n;
+  }
+
+  static void insert_into(inner_node& n, size_type const pos, key_type&& key,
+                          size_type const child) {
+    std::move_backward(n.keys_.data() + pos, n.keys_.data() + n.size_,
+                       n.keys_.data() + n.size_ + 1U);
+    std::copy_backward(n.children_.data() + pos + 1U,
+                       n.children_.data() + n.size_ + 1U,
+                       n.children_.data() + n.size_ + 2U);
+    n.keys_[pos] = std::move(key);
+    n.children_[pos + 1U] = child;
+    ++n.size_;
+  }
+};
+
+namespace raw {
+
+template <typename Key, typename Value, typename Less = std::less<Key>>
+using btree_map = basic_btree<pair<Key, Value>, get_first, vector, Less>;
+
+template <typename Key, typename Less = std::less<Key>>
+using btree_set = basic_btree<Key, identity, vector, Less>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename Key, typename Value, typename Less = std::less<Key>>
+using btree_map = basic_btree<pair<Key, Value>, get_first, vector, Less>;
+
+template <typename Key, typename Less = std::less<Key>>
+using btree_set = basic_btree<Key, identity, vector, Less>;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+#include "cista/containers/packed_vector.h"
+#include "cista/containers/vector.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Append-only vector of monotonically increasing unsigned integers `T`
+// (e.g. bucket start offsets) compressed with frame-of-reference blocks:
+// every block of `block_size` values stores its first value (anchor) and
+// the distances of its values to the anchor with the minimal bit width
+// of the block. Access is O(1): one anchor, one frame, two data words.
+//
+// `frames_[b]` holds the bit offset of block `b` in `deltas_` (upper 56
+// bits) and the bit width of its values (lower 8 bits). `deltas_` has one
+// padding word behind the word of the last bit (see `basic_packed_vector`).
+//
+// Usable as the index vector of `basic_vecvec` (without `bucket::push_back`
+// and `resize`, which modify existing entries) and `basic_nvec`:
+//
+//   cista::basic_vecvec<key, data::vector<V>, data::compressed_index<>>
+template <typename T, template <typename> typename Vec>
+struct basic_compressed_index {
+  using size_type = typename Vec<T>::size_type;
+  using value_type = T;
+
+  static_assert(std::is_unsigned_v<T> && sizeof(T) <= sizeof(std::uint64_t),
+                "compressed_index: value type has to be unsigned");
+
+  static constexpr auto const block_size = 64U;
+
+  struct const_iterator {
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    T operator*() const { return v_->get(i_); }
+    T operator[](difference_type const n) const {
+      return v_->get(static_cast<size_type>(i_ + n));
+    }
+
+    const_iterator& operator++() {
+      ++i_;
+      return *this;
+    }
+    const_iterator& operator--() {
+      --i_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto const tmp = *this;
+      ++i_;
+      return tmp;
+    }
+    const_iterator& operator+=(difference_type const n) {
+      i_ = static_cast<size_type>(i_ + n);
+      return *this;
+    }
+    const_iterator& operator-=(difference_type const n) {
+      i_ = static_cast<size_type>(i_ - n);
+      return *this;
+    }
+    const_iterator operator+(difference_type const n) const {
+      return {v_, static_cast<size_type>(i_ + n)};
+    }
+    const_iterator operator-(difference_type const n) const {
+      return {v_, static_cast<size_type>(i_ - n)};
+    }
+    difference_type operator-(const_iterator const& o) const {
+      return static_cast<difference_type>(i_) -
+             static_cast<difference_type>(o.i_);
+    }
+
+    friend bool operator==(const_iterator const& a, const_iterator const& b) {
+      return a.i_ == b.i_;
+    }
+    friend bool operator!=(const_iterator const& a, const_iterator const& b) {
+      return a.i_ != b.i_;
+    }
+    friend bool operator<(const_iterator const& a, const_iterator const& b) {
+      return a.i_ < b.i_;
+    }
+
+    basic_compressed_index const* v_;
+    size_type i_;
+  };
+
+  using iterator = const_iterator;
+
+  static constexpr unsigned frame_width(std::uint64_t const frame) noexcept {
+    return static_cast<unsigned>(frame & 0xFFU);
+  }
+
+  static constexpr std::uint64_t frame_offset(
+      std::uint64_t const frame) noexcept {
+    return frame >> 8U;
+  }
+
+  static constexpr std::uint64_t make_frame(std::uint64_t const offset,
+                                            unsigned const width) noexcept {
+    return (offset << 8U) | width;
+  }
+
+  // Words required for values up to bit `end` (incl. the padding word).
+  static constexpr std::uint64_t num_words(std::uint64_t const end) noexcept {
+    return end / 64U + 2U;
+  }
+
+  T get(size_type const i) const noexcept {
+    assert(i < size_);
+    auto const frame = frames_[i / block_size];
+    auto const width = frame_width(frame);
+    return static_cast<T>(
+        anchors_[i / block_size] +
+        detail::packed_extract(
+            deltas_.data(),
+            frame_offset(frame) + std::uint64_t{i % block_size} * width,
+            width));
+  }
+
+  T operator[](size_type const i) const noexcept { return get(i); }
+
+  T at(size_type const i) const {
+    verify(i < size_, "compressed_index::at: index out of range");
+    return get(i);
+  }
+
+  T front() const noexcept { return get(0U); }
+  T back() const noexcept { return get(static_cast<size_type>(size_ - 1U)); }
+
+  void push_back(T const x) {
+    verify(empty() || x >= back(), "compressed_index: values not monotone");
+
+    auto const j = static_cast<unsigned>(size_ % block_size);
+    if (j == 0U) {
+      auto const end = frames_.empty()
+                           ? std::uint64_t{0U}
+                           : frame_offset(frames_.back()) +
+                                 block_size * frame_width(frames_.back());
+      anchors_.push_back(x);
+      frames_.push_back(make_frame(end, 0U));
+    } else {
+      auto const width = detail::required_bits(x - anchors_.back());
+      if (width > frame_width(frames_.back())) {
+        widen_last_block(j, width);
+      }
+    }
+
+    auto const frame = frames_.back();
+    auto const bit =
+        frame_offset(frame) + std::uint64_t{j} * frame_width(frame);
+    deltas_.resize(static_cast<size_type>(
+        num_words(bit + frame_width(frame))));
+    detail::packed_insert(deltas_.data(), bit, frame_width(frame),
+                          x - anchors_.back());
+    ++size_;
+  }
+
+  void emplace_back(T const x) { push_back(x); }
+
+  void reserve(size_type const n) {
+    anchors_.reserve(static_cast<size_type>((n + block_size - 1U) /
+                                            block_size));
+    frames_.reserve(static_cast<size_type>((n + block_size - 1U) /
+                                           block_size));
+  }
+
+  void clear() {
+    anchors_.clear();
+    frames_.clear();
+    deltas_.clear();
+    size_ = 0U;
+  }
+
+  // Replaces the contents with the (monotone) values of `c`.
+  template <typename Container>
+  void encode(Container const& c) {
+    clear();
+    for (auto const& x : c) {
+      push_back(static_cast<T>(x));
+    }
+  }
+
+  // Decodes the values [from, from + n) to `out[0..n)`.
+  void decode(size_type const from, size_type const n, T* out) const {
+    assert(std::uint64_t{from} + n <= size_);
+    auto i = std::uint64_t{from};
+    auto const to = std::uint64_t{from} + n;
+    while (i != to) {
+      auto const b = i / block_size;
+      auto const anchor = anchors_[static_cast<size_type>(b)];
+      auto const frame = frames_[static_cast<size_type>(b)];
+      auto const width = frame_width(frame);
+      auto const block_end = std::min(to, (b + 1U) * block_size);
+      for (; i != block_end; ++i) {
+        *out++ = static_cast<T>(
+            anchor + detail::packed_extract(
+                         deltas_.data(),
+                         frame_offset(frame) + (i % block_size) * width,
+                         width));
+      }
+    }
+  }
+
+  const_iterator begin() const noexcept { return {this, 0U}; }
+  const_iterator end() const noexcept { return {this, size_}; }
+
+  friend const_iterator begin(basic_compressed_index const& v) {
+    return v.begin();
+  }
+  friend const_iterator end(basic_compressed_index const& v) {
+    return v.end();
+  }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0U; }
+
+  // Memory used by anchors, frames and values.
+  std::size_t size_in_bytes() const noexcept {
+    return anchors_.size() * sizeof(T) +
+           (frames_.size() + deltas_.size()) * sizeof(std::uint64_t);
+  }
+
+  friend bool operator==(basic_compressed_index const& a,
+                         basic_compressed_index const& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+  friend bool operator!=(basic_compressed_index const& a,
+                         basic_compressed_index const& b) {
+    return !(a == b);
+  }
+
+  Vec<T> anchors_;
+  Vec<std::uint64_t> frames_;
+  Vec<std::uint64_t> deltas_;
+  size_type size_{0U};
+
+private:
+  // Repacks the first `n` values of the last block with `width` bits.
+  void widen_last_block(unsigned const n, unsigned const width) {
+    auto const frame = frames_.back();
+    auto const offset = frame_offset(frame);
+    auto const old_width = frame_width(frame);
+
+    std::uint64_t values[block_size];
+    for (auto k = 0U; k != n; ++k) {
+      values[k] = detail::packed_extract(
+          deltas_.data(), offset + std::uint64_t{k} * old_width, old_width);
+    }
+
+    deltas_.resize(static_cast<size_type>(num_words(offset + n * width)));
+    for (auto k = 0U; k != n; ++k) {
+      detail::packed_insert(deltas_.data(), offset + std::uint64_t{k} * width,
+                            width, values[k]);
+    }
+    frames_.back() = make_frame(offset, width);
+  }
+};
+
+namespace raw {
+
+template <typename T = std::uint32_t>
+using compressed_index = basic_compressed_index<T, vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename T = std::uint32_t>
+using compressed_index = basic_compressed_index<T, vector>;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "cista/containers/paged.h"
+#include "cista/containers/paged_vecvec.h"
+#include "cista/parallel_for.h"
+#include "cista/strong.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Builds a `paged_vecvec<Index, Paged, Key>` with a fixed number of buckets
+// from many threads. Every thread appends through its own `writer` which
+// allocates pages from its own `Paged` storage (own data vector, own free
+// lists), so appends do not synchronize. Index entries are updated without
+// locks: each bucket may only be written by one writer. The first writer
+// claims a bucket with a compare-and-swap on its owner.
+//
+//   auto c = concurrent_paged_vecvec<idx_t, paged_t, key>{num_keys};
+//   // per thread:
+//   auto& w = c.add_writer();
+//   w.push_back(key{i}, x);
+//   // after all threads are done:
+//   auto pv = paged_vecvec<idx_t, paged_t, key>{};
+//   c.merge(pv);
+template <typename Index, typename Paged, typename Key>
+struct concurrent_paged_vecvec {
+  using target_t = paged_vecvec<Index, Paged, Key>;
+  using page_t = typename Paged::page_t;
+  using page_size_type = typename Paged::page_size_type;
+  using size_type = typename Paged::size_type;
+  using data_value_type = typename Paged::value_type;
+  using writer_id_t = std::uint32_t;
+
+  static constexpr auto const no_writer =
+      std::numeric_limits<writer_id_t>::max();
+
+  struct entry {
+    page_t page_{};
+    std::atomic<writer_id_t> writer_{no_writer};
+  };
+
+  struct writer {
+    void push_back(Key const k, data_value_type const& x) {
+      auto& e = claim(k);
+      e.page_ = e.page_.valid() ? paged_.resize_page(
+                                      e.page_, static_cast<page_size_type>(
+                                                   e.page_.size_ + 1U))
+                                : paged_.create_page(1U);
+      paged_.data(e.page_)[e.page_.size_ - 1U] = x;
+    }
+
+    template <typename Container>
+    void append(Key const k, Container const& c) {
+      using std::begin;
+      using std::end;
+
+      auto const n = static_cast<std::size_t>(std::distance(begin(c), end(c)));
+      if (n == 0U) {
+        claim(k);
+        return;
+      }
+
+      auto& e = claim(k);
+      auto const old_size = e.page_.size_;
+      e.page_ = e.page_.valid()
+                    ? paged_.resize_page(
+                          e.page_, static_cast<page_size_type>(old_size + n))
+                    : paged_.create_page(static_cast<page_size_type>(n));
+      std::copy(begin(c), end(c), paged_.data(e.page_) + old_size);
+    }
+
+    page_size_type size(Key const k) const {
+      return pv_->idx_[to_idx(k)].page_.size_;
+    }
+
+    entry& claim(Key const k) {
+      verify(to_idx(k) < pv_->idx_.size(),
+             "concurrent_paged_vecvec: key out of range");
+      auto& e = pv_->idx_[to_idx(k)];
+      auto owner = e.writer_.load(std::memory_order_relaxed);
+      if (owner == no_writer && e.writer_.compare_exchange_strong(
+                                    owner, id_, std::memory_order_relaxed)) {
+        return e;
+      }
+      verify(owner == id_,
+             "concurrent_paged_vecvec: bucket owned by other writer");
+      return e;
+    }
+
+    concurrent_paged_vecvec* pv_;
+    writer_id_t id_;
+    Paged paged_;
+  };
+
+  explicit concurrent_paged_vecvec(std::size_t const num_buckets)
+      : idx_(num_buckets) {}
+
+  // Thread-safe. The returned writer must only be used by one thread.
+  writer& add_writer() {
+    auto const lock = std::lock_guard{mutex_};
+    verify(writers_.size() < no_writer,
+           "concurrent_paged_vecvec: too many writers");
+    return writers_.emplace_back(
+        writer{this, static_cast<writer_id_t>(writers_.size()), Paged{}});
+  }
+
+  std::size_t size() const noexcept { return idx_.size(); }
+
+  // Appends all buckets to `out` (after all writers are done). Pages are
+  // allocated with `out.paged_.create_page`: for an empty `out`, the
+  // buckets are laid out back to back in key order, otherwise free pages
+  // of `out` are reused first.
+  void merge(target_t& out) const {
+    auto const offset = out.size();
+    for (auto const& e : idx_) {
+      out.idx_.emplace_back(out.paged_.create_page(e.page_.size_));
+    }
+
+    parallel_for(idx_.size(), [&](std::size_t const i) {
+      auto const& e = idx_[i];
+      auto const owner = e.writer_.load(std::memory_order_relaxed);
+      if (owner != no_writer && e.page_.size_ != 0U) {
+        auto const& from = writers_[owner].paged_;
+        auto const to = out.page(Key{static_cast<base_t<Key>>(offset + i)});
+        std::copy(from.data(e.page_), from.data(e.page_) + e.page_.size_,
+                  out.paged_.data(to));
+      }
+    });
+  }
+
+  std::vector<entry> idx_;
+  std::deque<writer> writers_;
+  std::mutex mutex_;
+};
+
+}  // namespace cista
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "cista/containers/fws_multimap.h"
+#include "cista/containers/vecvec.h"
+#include "cista/parallel_for.h"
+#include "cista/strong.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+namespace detail {
+
+// Stable parallel counting sort of `n` entries into `num_buckets` buckets:
+// per-chunk histograms, prefix sums, per-chunk scatter. Writes the values
+// (`get_value(i)`) ordered by bucket (`get_key(i)`) to `data` and calls
+// `add_start(start)` for the `num_buckets + 1` bucket starts.
+//
+// Besides `data`, the histograms use heap memory: one array of
+// `num_buckets` 64 bit counters per chunk (= thread). The number of chunks
+// is limited to `n / num_buckets` (at least one), so the histograms hold
+// at most `max(n, num_buckets)` counters. They are not memory mapped:
+// sorting needs `8 * max(n, num_buckets)` bytes of main memory, even if
+// the input and `data` are mmap backed.
+template <typename DataVec, typename GetKey, typename GetValue,
+          typename AddStart>
+void counting_sort(std::size_t const n, std::size_t const num_buckets,
+                   GetKey&& get_key, GetValue&& get_value, DataVec& data,
+                   AddStart&& add_start) {
+  auto const num_chunks = std::clamp(
+      n / std::max(num_buckets, std::size_t{1U}), std::size_t{1U},
+      parallel_num_chunks(n));
+
+  // Histograms: entries of chunk c in bucket k.
+  auto hist = std::vector<std::vector<std::uint64_t>>(num_chunks);
+  auto invalid_key = std::vector<std::uint8_t>(num_chunks, 0U);
+  parallel_for_chunks(
+      n, num_chunks,
+      [&](std::size_t const c, std::size_t const from, std::size_t const to) {
+        auto& h = hist[c];
+        h.resize(num_buckets, 0U);
+        for (auto i = from; i != to; ++i) {
+          auto const k = static_cast<std::size_t>(to_idx(get_key(i)));
+          if (k >= num_buckets) {
+            invalid_key[c] = 1U;
+            return;
+          }
+          ++h[k];
+        }
+      });
+  verify(std::none_of(begin(invalid_key), end(invalid_key),
+                      [](std::uint8_t const x) { return x != 0U; }),
+         "counting_sort: key out of range");
+
+  // Histograms -> write positions: bucket k, chunk c starts behind all
+  // entries of smaller buckets and of bucket k in chunks before c.
+  auto const num_key_chunks = parallel_num_chunks(num_buckets);
+  auto key_chunk_sizes = std::vector<std::uint64_t>(num_key_chunks + 1U, 0U);
+  parallel_for_chunks(
+      num_buckets, num_key_chunks,
+      [&](std::size_t const kc, std::size_t const from, std::size_t const to) {
+        auto pos = std::uint64_t{0U};
+        for (auto k = from; k != to; ++k) {
+          for (auto& h : hist) {
+            pos += std::exchange(h[k], pos);
+          }
+        }
+        key_chunk_sizes[kc + 1U] = pos;
+      });
+  std::partial_sum(begin(key_chunk_sizes), end(key_chunk_sizes),
+                   begin(key_chunk_sizes));
+  parallel_for_chunks(
+      num_buckets, num_key_chunks,
+      [&](std::size_t const kc, std::size_t const from, std::size_t const to) {
+        for (auto k = from; k != to; ++k) {
+          for (auto& h : hist) {
+            h[k] += key_chunk_sizes[kc];
+          }
+        }
+      });
+
+  for (auto k = std::size_t{0U}; k != num_buckets; ++k) {
+    add_start(hist[0][k]);
+  }
+  add_start(std::uint64_t{n});
+
+  data.resize(static_cast<typename DataVec::size_type>(n));
+  auto const out = data.data();
+  parallel_for_chunks(
+      n, num_chunks,
+      [&](std::size_t const c, std::size_t const from, std::size_t const to) {
+        auto& h = hist[c];
+        for (auto i = from; i != to; ++i) {
+          out[h[static_cast<std::size_t>(to_idx(get_key(i)))]++] =
+              get_value(i);
+        }
+      });
+}
+
+}  // namespace detail
+
+// Builds `out` (has to be empty) from the unsorted `entries` with a
+// parallel stable counting sort: `get_key(entry)` is the bucket,
+// `get_value(entry)` the value. `entries` has to be random access (e.g.
+// `vector`, `mmap_vec`). `mmap_vec` inputs and `basic_vecvec` members keep
+// the entries and the result out of the main memory, the histograms (see
+// `detail::counting_sort`) still need `8 * max(n, num_buckets)` bytes.
+template <typename Key, typename DataVec, typename IndexVec,
+          typename Entries, typename GetKey, typename GetValue>
+void build_vecvec(basic_vecvec<Key, DataVec, IndexVec>& out,
+                  Entries const& entries, std::size_t const num_buckets,
+                  GetKey&& get_key, GetValue&& get_value) {
+  using std::begin;
+  using std::end;
+  using index_value_type = typename IndexVec::value_type;
+
+  verify(out.empty() && out.data_.size() == 0U,
+         "build_vecvec: target not empty");
+  auto const first = begin(entries);
+  auto const n = static_cast<std::size_t>(std::distance(first, end(entries)));
+  detail::counting_sort(
+      n, num_buckets,
+      [&](std::size_t const i) {
+        return get_key(first[static_cast<std::ptrdiff_t>(i)]);
+      },
+      [&](std::size_t const i) {
+        return get_value(first[static_cast<std::ptrdiff_t>(i)]);
+      },
+      out.data_,
+      [&](std::uint64_t const start) {
+        out.bucket_starts_.emplace_back(static_cast<index_value_type>(start));
+      });
+}
+
+// `entries` are pairs of (bucket, value).
+template <typename Key, typename DataVec, typename IndexVec,
+          typename Entries>
+void build_vecvec(basic_vecvec<Key, DataVec, IndexVec>& out,
+                  Entries const& entries, std::size_t const num_buckets) {
+  build_vecvec(
+      out, entries, num_buckets, [](auto const& e) { return e.first; },
+      [](auto const& e) { return e.second; });
+}
+
+// Same as `build_vecvec` for a (not yet used) `fws_multimap`.
+template <typename DataVec, typename IndexVec, typename Entries,
+          typename GetKey, typename GetValue>
+void build_fws_multimap(fws_multimap<DataVec, IndexVec>& out,
+                        Entries const& entries, std::size_t const num_keys,
+                        GetKey&& get_key, GetValue&& get_value) {
+  using std::begin;
+  using std::end;
+  using index_t = typename IndexVec::value_type;
+
+  verify(out.index_size() == 0U && out.data_size() == 0U && !out.finished(),
+         "build_fws_multimap: target not empty");
+  auto const first = begin(entries);
+  auto const n = static_cast<std::size_t>(std::distance(first, end(entries)));
+  detail::counting_sort(
+      n, num_keys,
+      [&](std::size_t const i) {
+        return get_key(first[static_cast<std::ptrdiff_t>(i)]);
+      },
+      [&](std::size_t const i) {
+        return get_value(first[static_cast<std::ptrdiff_t>(i)]);
+      },
+      out.data_,
+      [&](std::uint64_t const start) {
+        out.index_.push_back(static_cast<index_t>(start));
+      });
+  out.current_start_ = static_cast<index_t>(n);
+  out.complete_ = true;
+}
+
+template <typename DataVec, typename IndexVec, typename Entries>
+void build_fws_multimap(fws_multimap<DataVec, IndexVec>& out,
+                        Entries const& entries, std::size_t const num_keys) {
+  build_fws_multimap(
+      out, entries, num_keys, [](auto const& e) { return e.first; },
+      [](auto const& e) { return e.second; });
+}
+
+}  // namespace cista
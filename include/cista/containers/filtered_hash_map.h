@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "cista/containers/bloom_filter.h"
+#include "cista/containers/hash_map.h"
+#include "cista/containers/xor_filter.h"
+#include "cista/exception.h"
+
+namespace cista {
+
+// Read-only view of a `hash_map` (`hash_storage`) with an approximate
+// membership filter in front: most lookups of absent keys are rejected by
+// the filter (one 64 byte block for `bloom_filter`, three bytes for
+// `xor_filter`) without touching the ctrl bytes and entries of the map.
+// Useful for miss-heavy lookups in cold / mmap'd maps.
+//
+// Fill `map_`, then call `build_filter()`. Changes to `map_` require
+// another `build_filter()`.
+template <typename Map, typename Filter>
+struct basic_filtered_hash_map {
+  using key_type = typename Map::key_type;
+  using mapped_type = typename Map::mapped_type;
+  using const_iterator = typename Map::const_iterator;
+
+  void build_filter() {
+    filter_.build(map_.begin(), map_.end(), [&](auto const& entry) {
+      return map_.compute_hash(typename Map::get_key_t{}(entry));
+    });
+  }
+
+  template <typename Key>
+  const_iterator find(Key const& key) const {
+    return filter_.contains(map_.compute_hash(key)) ? map_.find(key)
+                                                    : map_.end();
+  }
+
+  template <typename Key>
+  bool contains(Key const& key) const {
+    return find(key) != map_.end();
+  }
+
+  template <typename Key>
+  mapped_type const& at(Key const& key) const {
+    auto const it = find(key);
+    if (it == map_.end()) {
+      throw_exception(std::out_of_range{"filtered_hash_map::at() not found"});
+    }
+    return it->second;
+  }
+
+  const_iterator begin() const { return map_.begin(); }
+  const_iterator end() const { return map_.end(); }
+  friend const_iterator begin(basic_filtered_hash_map const& m) {
+    return m.begin();
+  }
+  friend const_iterator end(basic_filtered_hash_map const& m) {
+    return m.end();
+  }
+
+  auto size() const noexcept { return map_.size(); }
+  bool empty() const noexcept { return map_.empty(); }
+
+  Map map_;
+  Filter filter_;
+};
+
+namespace raw {
+
+template <typename Key, typename Value, typename Filter = bloom_filter,
+          typename Hash = hashing<Key>, typename Eq = equal_to<Key>>
+using filtered_hash_map =
+    basic_filtered_hash_map<hash_map<Key, Value, Hash, Eq>, Filter>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename Key, typename Value, typename Filter = bloom_filter,
+          typename Hash = hashing<Key>, typename Eq = equal_to<Key>>
+using filtered_hash_map =
+    basic_filtered_hash_map<hash_map<Key, Value, Hash, Eq>, Filter>;
+
+}  // namespace offset
+
+}  // namespace cista
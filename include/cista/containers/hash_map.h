@@ -37,4 +37,11 @@ using hash_map =
     hash_storage<pair<Key, Value>, ptr, get_first, get_second, Hash, Eq>;
 }  // namespace offset
 
+namespace offset32 {
+template <typename Key, typename Value, typename Hash = hashing<Key>,
+          typename Eq = equal_to<Key>>
+using hash_map =
+    hash_storage<pair<Key, Value>, ptr, get_first, get_second, Hash, Eq>;
+}  // namespace offset32
+
 }  // namespace cista
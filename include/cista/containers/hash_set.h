@@ -25,4 +25,9 @@ template <typename T, typename Hash = hashing<T>, typename Eq = equal_to<T>>
 using hash_set = hash_storage<T, ptr, identity, identity, Hash, Eq>;
 }  // namespace offset
 
+namespace offset32 {
+template <typename T, typename Hash = hashing<T>, typename Eq = equal_to<T>>
+using hash_set = hash_storage<T, ptr, identity, identity, Hash, Eq>;
+}  // namespace offset32
+
 }  // namespace cista
@@ -2,21 +2,40 @@
 
 #include <cinttypes>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <iterator>
 #include <optional>
+#include <random>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include "cista/aligned_alloc.h"
+#include "cista/arena.h"
 #include "cista/bit_counting.h"
 #include "cista/containers/ptr.h"
 #include "cista/decay.h"
 #include "cista/exception.h"
 #include "cista/hash.h"
+#include "cista/parallel_for.h"
+
+// Live lookup counters (see `hash_storage::counters()`), off by default.
+#if defined(CISTA_HASH_STORAGE_STATS)
+#define CISTA_HASH_STORAGE_COUNT(counter, n) \
+  counters().counter.fetch_add((n), std::memory_order_relaxed)
+#else
+#define CISTA_HASH_STORAGE_COUNT(counter, n)
+#endif
 
 namespace cista {
 
+struct hash_storage_counters {
+  std::atomic<std::uint64_t> lookups_{0U}, hits_{0U}, groups_probed_{0U},
+      key_compares_{0U}, rehashes_{0U};
+};
+
 // This class is a generic hash-based container.
 // It can be used e.g. as hash set or hash map.
 //   - hash map: `T` = `std::pair<Key, Value>`, GetKey = `return entry.first;`
@@ -33,10 +52,16 @@ namespace cista {
 //   - sanitizer support (Sanitizer[Un]PoisonMemoryRegion)
 //   - overloads (conveniance as well to reduce copying) in the interface
 //   - allocator support
+//
+// Hash flooding: by default, the key hash is used as is (deterministic
+// serialized output). `set_seed()` / `randomize_seed()` mix a per-map seed
+// into every hash via `hash_combine`. The seed is part of the serialized
+// layout, so a loaded map probes with the seed it was built with.
 template <typename T, template <typename> typename Ptr, typename GetKey,
           typename GetValue, typename Hash, typename Eq>
 struct hash_storage {
   using entry_t = T;
+  using get_key_t = GetKey;
   using difference_type = ptrdiff_t;
   using size_type = hash_t;
   using key_type =
@@ -48,12 +73,25 @@ struct hash_storage {
   static constexpr size_type const WIDTH = 8U;
   static constexpr std::size_t const ALIGNMENT = alignof(T);
 
+  // Seeded hashes get a final `hash_mix`: the unseeded scalar hash leaves
+  // high key bits out of the low hash bits used by h1/h2.
   template <typename Key>
-  hash_t compute_hash(Key const& k) {
+  hash_t compute_hash(Key const& k) const {
+    auto const seeded = [&](auto&& hasher) {
+      if (seed_ == 0U) {
+        return static_cast<size_type>(hasher(k));
+      } else if constexpr (std::is_invocable_v<decltype(hasher), Key const&,
+                                               hash_t>) {
+        return static_cast<size_type>(
+            hash_mix(hash_combine(seed_, hasher(k, seed_))));
+      } else {
+        return static_cast<size_type>(hash_mix(hash_combine(seed_, hasher(k))));
+      }
+    };
     if constexpr (std::is_same_v<decay_t<Key>, key_type>) {
-      return static_cast<size_type>(Hash{}(k));
+      return seeded(Hash{});
     } else {
-      return static_cast<size_type>(Hash::template create<Key>()(k));
+      return seeded(Hash::template create<Key>());
     }
   }
 
@@ -223,6 +261,13 @@ struct hash_storage {
     iterator inner_;
   };
 
+  // Counters are per container type, not per instance: this keeps the
+  // layout unchanged and works for maps in read-only (mmap'd) memory.
+  static hash_storage_counters& counters() noexcept {
+    static auto c = hash_storage_counters{};
+    return c;
+  }
+
   static ctrl_t* empty_group() noexcept {
     alignas(16) static constexpr ctrl_t empty_group[] = {
         END,   EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
@@ -230,6 +275,16 @@ struct hash_storage {
     return const_cast<ctrl_t*>(empty_group);
   }
 
+  // Narrow offset pointers (`offset32`) cannot reach the static empty group:
+  // their empty tables have no ctrl bytes (checked in `find` / `insert`).
+  static ctrl_t* empty_ctrl() noexcept {
+    if constexpr (is_narrow_ptr_v<Ptr<ctrl_t>>) {
+      return nullptr;
+    } else {
+      return empty_group();
+    }
+  }
+
   static constexpr bool is_empty(ctrl_t const c) noexcept { return c == EMPTY; }
   static constexpr bool is_full(ctrl_t const c) noexcept { return c >= 0; }
   static constexpr bool is_deleted(ctrl_t const c) noexcept {
@@ -268,11 +323,12 @@ struct hash_storage {
         size_{other.size_},
         capacity_{other.capacity_},
         growth_left_{other.growth_left_},
+        seed_{other.seed_},
         self_allocated_{other.self_allocated_} {
     other.reset();
   }
 
-  hash_storage(hash_storage const& other) {
+  hash_storage(hash_storage const& other) : seed_{other.seed_} {
     if (other.size() != 0U) {
       for (const auto& v : other) {
         emplace(v);
@@ -286,6 +342,7 @@ struct hash_storage {
     size_ = other.size_;
     capacity_ = other.capacity_;
     growth_left_ = other.growth_left_;
+    seed_ = other.seed_;
     self_allocated_ = other.self_allocated_;
     other.reset();
     return *this;
@@ -293,6 +350,7 @@ struct hash_storage {
 
   hash_storage& operator=(hash_storage const& other) {
     clear();
+    seed_ = other.seed_;
     if (other.size() == 0U) {
       return *this;
     }
@@ -370,11 +428,20 @@ struct hash_storage {
   // --- find()
   template <typename Key>
   iterator find_impl(Key&& key) {
+    CISTA_HASH_STORAGE_COUNT(lookups_, 1U);
+    if constexpr (is_narrow_ptr_v<Ptr<ctrl_t>>) {
+      if (capacity_ == 0U) {
+        return end();
+      }
+    }
     auto const hash = compute_hash(key);
     for (auto seq = probe_seq{h1(hash), capacity_}; true; seq.next()) {
+      CISTA_HASH_STORAGE_COUNT(groups_probed_, 1U);
       group g{ctrl_ + seq.offset_};
       for (auto const i : g.match(h2(hash))) {
+        CISTA_HASH_STORAGE_COUNT(key_compares_, 1U);
         if (Eq{}(GetKey()(entries_[seq.offset(i)]), key)) {
+          CISTA_HASH_STORAGE_COUNT(hits_, 1U);
           return iterator_at(seq.offset(i));
         }
       }
@@ -407,6 +474,84 @@ struct hash_storage {
     }
   }
 
+  // Bulk insertion of [first, last):
+  //   - all hashes are computed up front (in parallel for large ranges)
+  //   - the table is grown at most once to its final capacity
+  //   - entries are inserted ordered by their probe start position, so
+  //     ctrl bytes and entries are written front to back
+  // With `unique_keys_hint = true`, the caller guarantees that the range
+  // contains no duplicate keys and no keys that are already stored. This
+  // skips the key comparisons. Otherwise, the first occurrence of a key
+  // wins (same as calling `emplace` for each entry). Duplicates are dropped
+  // before the table is sized.
+  // The resulting table has the same capacity, ctrl encoding and growth
+  // bookkeeping as one built by calling `emplace` for each entry. Entries
+  // can be placed in different slots (insertion order differs).
+  template <typename It>
+  void build(It first, It last, bool const unique_keys_hint = false) {
+    struct prehashed {
+      size_type hash_;
+      It it_;
+    };
+
+    static_assert(
+        std::is_base_of_v<std::forward_iterator_tag,
+                          typename std::iterator_traits<It>::iterator_category>,
+        "hash_storage::build requires forward iterators");
+
+    auto prehashed_entries = std::vector<prehashed>{};
+    prehashed_entries.reserve(
+        static_cast<std::size_t>(std::distance(first, last)));
+    for (; first != last; ++first) {
+      prehashed_entries.push_back(prehashed{0U, first});
+    }
+    if (prehashed_entries.empty()) {
+      return;
+    }
+
+    parallel_for(prehashed_entries.size(), [&](std::size_t const i) {
+      auto& e = prehashed_entries[i];
+      e.hash_ = compute_hash(GetKey()(*e.it_));
+    });
+
+    if (!unique_keys_hint) {
+      // Equal keys have equal hashes: compare keys within equal hash runs.
+      std::stable_sort(prehashed_entries.begin(), prehashed_entries.end(),
+                       [](prehashed const& a, prehashed const& b) {
+                         return a.hash_ < b.hash_;
+                       });
+      auto kept = std::size_t{0U}, run = std::size_t{0U};
+      for (auto const& e : prehashed_entries) {
+        if (kept == 0U || prehashed_entries[kept - 1U].hash_ != e.hash_) {
+          run = kept;
+        }
+        auto const& key = GetKey()(*e.it_);
+        auto const is_duplicate = std::any_of(
+            prehashed_entries.begin() + static_cast<std::ptrdiff_t>(run),
+            prehashed_entries.begin() + static_cast<std::ptrdiff_t>(kept),
+            [&](prehashed const& p) { return Eq{}(GetKey()(*p.it_), key); });
+        if (!is_duplicate && (size_ == 0U || find(key) == end())) {
+          prehashed_entries[kept++] = e;
+        }
+      }
+      prehashed_entries.erase(
+          prehashed_entries.begin() + static_cast<std::ptrdiff_t>(kept),
+          prehashed_entries.end());
+    }
+
+    reserve(static_cast<size_type>(size_ + prehashed_entries.size()));
+
+    std::stable_sort(
+        prehashed_entries.begin(), prehashed_entries.end(),
+        [&](prehashed const& a, prehashed const& b) {
+          return (h1(a.hash_) & capacity_) < (h1(b.hash_) & capacity_);
+        });
+
+    for (auto const& e : prehashed_entries) {
+      new (entries_ + prepare_insert(e.hash_)) T{*e.it_};
+    }
+  }
+
   // --- erase()
   template <typename Key>
   std::size_t erase_impl(Key&& key) {
@@ -434,7 +579,23 @@ struct hash_storage {
 
   template <typename... Args>
   std::pair<iterator, bool> emplace(Args&&... args) {
-    auto entry = T{std::forward<Args>(args)...};
+    if constexpr (is_narrow_ptr_v<Ptr<T>>) {
+      // A temporary on the stack can not point into the arena.
+      auto const a = arena::current();
+      verify(a != nullptr, "offset32: no arena");
+      auto const mem = a->allocate(sizeof(T), alignof(T));
+      auto& entry = *new (mem) T{std::forward<Args>(args)...};
+      auto const res = emplace_entry(entry);
+      entry.~T();
+      a->deallocate(mem, sizeof(T));
+      return res;
+    } else {
+      auto entry = T{std::forward<Args>(args)...};
+      return emplace_entry(entry);
+    }
+  }
+
+  std::pair<iterator, bool> emplace_entry(T& entry) {
     auto res = find_or_prepare_insert(GetKey()(entry));
     if (res.second) {
       new (entries_ + res.first) T{std::move(entry)};
@@ -520,7 +681,7 @@ struct hash_storage {
     }
 
     if (self_allocated_) {
-      CISTA_ALIGNED_FREE(ALIGNMENT, entries_);
+      container_aligned_free<Ptr<T>>(ALIGNMENT, entries_);
     }
 
     partial_reset();
@@ -529,10 +690,25 @@ struct hash_storage {
   template <typename Key>
   std::pair<size_type, bool> find_or_prepare_insert(Key&& key) {
     auto const hash = compute_hash(key);
+    return find_or_prepare_insert(std::forward<Key>(key), hash);
+  }
+
+  template <typename Key>
+  std::pair<size_type, bool> find_or_prepare_insert(Key&& key,
+                                                    size_type const hash) {
+    CISTA_HASH_STORAGE_COUNT(lookups_, 1U);
+    if constexpr (is_narrow_ptr_v<Ptr<ctrl_t>>) {
+      if (capacity_ == 0U) {
+        return {prepare_insert(hash), true};
+      }
+    }
     for (auto seq = probe_seq{h1(hash), capacity_}; true; seq.next()) {
+      CISTA_HASH_STORAGE_COUNT(groups_probed_, 1U);
       group g{ctrl_ + seq.offset_};
       for (auto const i : g.match(h2(hash))) {
+        CISTA_HASH_STORAGE_COUNT(key_compares_, 1U);
         if (Eq{}(GetKey()(entries_[seq.offset(i)]), key)) {
+          CISTA_HASH_STORAGE_COUNT(hits_, 1U);
           return {seq.offset(i), false};
         }
       }
@@ -553,6 +729,11 @@ struct hash_storage {
   }
 
   size_type prepare_insert(size_type const hash) {
+    if constexpr (is_narrow_ptr_v<Ptr<ctrl_t>>) {
+      if (capacity_ == 0U) {
+        rehash_and_grow_if_necessary();
+      }
+    }
     auto target = find_first_non_full(hash);
     if (growth_left_ == 0U && !is_deleted(ctrl_[target.offset_])) {
       rehash_and_grow_if_necessary();
@@ -583,33 +764,52 @@ struct hash_storage {
     ctrl_[capacity_] = END;
   }
 
+  static constexpr std::size_t storage_size(size_type const capacity) noexcept {
+    return static_cast<std::size_t>(capacity * sizeof(T) +
+                                    (capacity + 1U + WIDTH) * sizeof(ctrl_t));
+  }
+
   void initialize_entries() {
-    self_allocated_ = true;
-    auto const size = static_cast<size_type>(
-        capacity_ * sizeof(T) + (capacity_ + 1U + WIDTH) * sizeof(ctrl_t));
-    entries_ = reinterpret_cast<T*>(
-        CISTA_ALIGNED_ALLOC(ALIGNMENT, static_cast<std::size_t>(size)));
-    if (entries_ == nullptr) {
+    auto const size = storage_size(capacity_);
+    auto const mem = container_aligned_alloc<Ptr<T>>(ALIGNMENT, size);
+    if (mem == nullptr) {
       throw_exception(std::bad_alloc{});
     }
 #if defined(CISTA_ZERO_OUT)
-    std::memset(entries_, 0, size);
+    std::memset(mem, 0, size);
 #endif
-    ctrl_ = reinterpret_cast<ctrl_t*>(
-        reinterpret_cast<std::uint8_t*>(ptr_cast(entries_)) +
-        capacity_ * sizeof(T));
+    self_allocated_ = true;
+    initialize_entries(mem);
+  }
+
+  // Uses `mem` (at least `storage_size(capacity_)` bytes, aligned for `T`)
+  // for entries and ctrl bytes. The memory is not owned by this container.
+  void initialize_entries(void* const mem) noexcept {
+    entries_ = static_cast<T*>(mem);
+    ctrl_ = reinterpret_cast<ctrl_t*>(static_cast<std::uint8_t*>(mem) +
+                                      capacity_ * sizeof(T));
     reset_ctrl();
     reset_growth_left();
   }
 
-  void resize(size_type const new_capacity) {
-    auto const old_ctrl = ctrl_;
-    auto const old_entries = entries_;
+  void resize(size_type const new_capacity) { resize(new_capacity, nullptr); }
+
+  // Rehashes into `mem` if given (see `initialize_entries(void*)`),
+  // otherwise into self-allocated memory.
+  void resize(size_type const new_capacity, void* const mem) {
+    CISTA_HASH_STORAGE_COUNT(rehashes_, 1U);
+    ctrl_t* const old_ctrl = ctrl_;
+    T* const old_entries = entries_;
     auto const old_capacity = capacity_;
     auto const old_self_allocated = self_allocated_;
 
     capacity_ = new_capacity;
-    initialize_entries();
+    if (mem == nullptr) {
+      initialize_entries();
+    } else {
+      self_allocated_ = false;
+      initialize_entries(mem);
+    }
 
     for (size_type i = 0U; i != old_capacity; ++i) {
       if (is_full(old_ctrl[i])) {
@@ -623,13 +823,13 @@ struct hash_storage {
     }
 
     if (old_capacity != 0U && old_self_allocated) {
-      CISTA_ALIGNED_FREE(ALIGNMENT, old_entries);
+      container_aligned_free<Ptr<T>>(ALIGNMENT, old_entries);
     }
   }
 
   void partial_reset() noexcept {
     entries_ = nullptr;
-    ctrl_ = empty_group();
+    ctrl_ = empty_ctrl();
     size_ = 0U;
     capacity_ = 0U;
     growth_left_ = 0U;
@@ -642,6 +842,46 @@ struct hash_storage {
 
   void rehash() { resize(capacity_); }
 
+  // Changes the hash seed (0 = unseeded) and rehashes all entries.
+  void set_seed(hash_t const seed) {
+    seed_ = seed;
+    if (capacity_ != 0U) {
+      rehash();
+    }
+  }
+
+  void randomize_seed() {
+    auto rd = std::random_device{};
+    auto seed = hash_t{0U};
+    while (seed == 0U) {
+      seed = static_cast<hash_t>((std::uint64_t{rd()} << 32U) ^ rd());
+    }
+    set_seed(seed);
+  }
+
+  hash_t seed() const noexcept { return seed_; }
+
+  // Smallest capacity the incremental insertion path ends up with for `n`
+  // entries (the growth sequence is 1, 3, 7, 15, ...).
+  static constexpr size_type capacity_for(size_type const n) noexcept {
+    if (n == 0U) {
+      return 0U;
+    }
+    auto capacity = static_cast<size_type>(normalize_capacity(n));
+    while (capacity_to_growth(capacity) < n) {
+      capacity = capacity * 2U + 1U;
+    }
+    return capacity;
+  }
+
+  // Grows the table (at most once) so that `n` entries fit without rehashing.
+  void reserve(size_type const n) {
+    auto const new_capacity = capacity_for(n);
+    if (new_capacity > capacity_) {
+      resize(new_capacity);
+    }
+  }
+
   iterator iterator_at(size_type const i) noexcept {
     return {ctrl_ + i, entries_ + i};
   }
@@ -663,8 +903,9 @@ struct hash_storage {
   }
 
   Ptr<T> entries_{nullptr};
-  Ptr<ctrl_t> ctrl_{empty_group()};
+  Ptr<ctrl_t> ctrl_{empty_ctrl()};
   size_type size_{0U}, capacity_{0U}, growth_left_{0U};
+  hash_t seed_{0U};
   bool self_allocated_{false};
 };
 
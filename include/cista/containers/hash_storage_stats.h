@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cinttypes>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "cista/bit_counting.h"
+#include "cista/containers/hash_storage.h"
+
+namespace cista {
+
+// Snapshot of the internal state of a `hash_storage`.
+// Probe lengths are counted in groups (1 = found in the first group).
+struct hash_storage_stats {
+  static double avg(std::vector<std::size_t> const& histogram) {
+    auto sum = std::size_t{0U}, count = std::size_t{0U};
+    for (auto i = std::size_t{0U}; i != histogram.size(); ++i) {
+      sum += i * histogram[i];
+      count += histogram[i];
+    }
+    return count == 0U ? 0.0
+                       : static_cast<double>(sum) / static_cast<double>(count);
+  }
+
+  static std::size_t max(std::vector<std::size_t> const& histogram) {
+    auto const it = std::find_if(rbegin(histogram), rend(histogram),
+                                 [](std::size_t const x) { return x != 0U; });
+    return it == rend(histogram)
+               ? 0U
+               : static_cast<std::size_t>(std::distance(it, rend(histogram))) -
+                     1U;
+  }
+
+  double load_factor() const noexcept {
+    return capacity_ == 0U ? 0.0
+                           : static_cast<double>(full_) /
+                                 static_cast<double>(capacity_);
+  }
+
+  double avg_present_probe_length() const { return avg(present_probe_); }
+  double avg_absent_probe_length() const { return avg(absent_probe_); }
+  std::size_t max_present_probe_length() const { return max(present_probe_); }
+  std::size_t max_absent_probe_length() const { return max(absent_probe_); }
+
+  // Key comparisons that fail because of equal h2 bits, per present lookup.
+  double h2_false_matches_per_lookup() const noexcept {
+    return full_ == 0U ? 0.0
+                       : static_cast<double>(h2_false_matches_) /
+                             static_cast<double>(full_);
+  }
+
+  std::size_t size_{0U}, capacity_{0U}, growth_left_{0U};
+  std::size_t empty_{0U}, deleted_{0U}, full_{0U};
+
+  // log2(capacity + 1): capacities are 2^n - 1. The number of rehashes
+  // that actually happened is counted by `hash_storage::counters()`.
+  std::size_t capacity_log2_{0U};
+
+  // probe length -> number of present keys
+  std::vector<std::size_t> present_probe_;
+
+  // probe length -> number of probe start positions (= absent keys with
+  // uniformly distributed hashes)
+  std::vector<std::size_t> absent_probe_;
+
+  // number of full slots -> number of groups
+  std::vector<std::size_t> group_occupancy_;
+
+  std::size_t h2_false_matches_{0U};
+};
+
+// Computes the statistics without modifying the map (safe for maps in
+// read-only memory, e.g. mmap'd deserialized data).
+// Costs O(capacity * probe length) and hashes every key once.
+template <typename T, template <typename> typename Ptr, typename GetKey,
+          typename GetValue, typename Hash, typename Eq>
+hash_storage_stats get_stats(
+    hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq> const& m) {
+  using Type = hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq>;
+  using size_type = typename Type::size_type;
+  using group = typename Type::group;
+  using probe_seq = typename Type::probe_seq;
+
+  auto const add = [](std::vector<std::size_t>& histogram,
+                      std::size_t const i) {
+    if (histogram.size() <= i) {
+      histogram.resize(i + 1U);
+    }
+    ++histogram[i];
+  };
+
+  auto s = hash_storage_stats{};
+  s.size_ = m.size_;
+  s.capacity_ = m.capacity_;
+  s.growth_left_ = m.growth_left_;
+  s.capacity_log2_ =
+      m.capacity_ == 0U ? 0U : trailing_zeros(~std::uint64_t{m.capacity_});
+
+  for (auto i = size_type{0U}; i != m.capacity_; ++i) {
+    auto const c = m.ctrl_[i];
+    s.empty_ += Type::is_empty(c) ? 1U : 0U;
+    s.deleted_ += Type::is_deleted(c) ? 1U : 0U;
+    s.full_ += Type::is_full(c) ? 1U : 0U;
+  }
+
+  s.group_occupancy_.resize(Type::WIDTH + 1U);
+  for (auto g = size_type{0U}; g < m.capacity_; g += Type::WIDTH) {
+    auto const to = std::min(static_cast<size_type>(g + Type::WIDTH),
+                             static_cast<size_type>(m.capacity_));
+    ++s.group_occupancy_[static_cast<std::size_t>(
+        std::count_if(m.ctrl_ + g, m.ctrl_ + to, Type::is_full))];
+  }
+
+  for (auto i = size_type{0U}; i != m.capacity_; ++i) {
+    if (!Type::is_full(m.ctrl_[i])) {
+      continue;
+    }
+    auto const hash = m.compute_hash(GetKey{}(m.entries_[i]));
+    auto length = std::size_t{1U};
+    for (auto seq = probe_seq{Type::h1(hash), m.capacity_}; true;
+         seq.next(), ++length) {
+      auto found = false;
+      for (auto const j : group{m.ctrl_ + seq.offset_}.match(Type::h2(hash))) {
+        if (seq.offset(j) == i) {
+          found = true;
+          break;
+        }
+        ++s.h2_false_matches_;
+      }
+      if (found || length > m.capacity_) {
+        break;
+      }
+    }
+    add(s.present_probe_, length);
+  }
+
+  if (m.ctrl_ == nullptr) {  // empty narrow offset table: no ctrl bytes
+    add(s.absent_probe_, 1U);
+    return s;
+  }
+
+  for (auto start = size_type{0U}; start <= m.capacity_; ++start) {
+    auto length = std::size_t{1U};
+    for (auto seq = probe_seq{start, m.capacity_};
+         !group{m.ctrl_ + seq.offset_}.match_empty() && length <= m.capacity_;
+         seq.next()) {
+      ++length;
+    }
+    add(s.absent_probe_, length);
+  }
+
+  return s;
+}
+
+}  // namespace cista
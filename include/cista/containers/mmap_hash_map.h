@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "cista/aligned_alloc.h"
+#include "cista/containers/hash_map.h"
+#include "cista/containers/hash_set.h"
+#include "cista/mmap.h"
+#include "cista/hash.h"
+#include "cista/type_hash/type_name.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Hash container (`offset::hash_map` / `offset::hash_set`) that lives
+// entirely inside a memory mapped file. The file starts with a magic
+// number and a fingerprint of `Storage` (type name and sizes), followed by
+// a valid serialized `Storage` (mode::NONE): the container header at
+// `STORAGE_START` followed by entries and ctrl bytes. This means:
+//   - no serialize step: the file can be reopened and used directly
+//   - the bytes from `STORAGE_START` can be loaded read-only with
+//     `cista::deserialize<Storage>`
+//   - the working set is bounded by the OS page cache, not by RAM
+// Reopening checks magic number and fingerprint, and that the file size
+// matches the capacity in the container header.
+//
+// Growing rehashes into a fresh region appended to the file, moves it to
+// the front and drops the old region. Offset pointers are relative, so
+// remapping the file at a different address does not invalidate anything.
+// Only trivially copyable entries are supported (no heap pointers).
+// The file is not crash-safe while the container is being modified.
+template <typename Storage>
+struct basic_mmap_hash_storage {
+  using storage_t = Storage;
+  using entry_t = typename Storage::entry_t;
+  using key_type = typename Storage::key_type;
+  using mapped_type = typename Storage::mapped_type;
+  using size_type = typename Storage::size_type;
+  using iterator = typename Storage::iterator;
+  using const_iterator = typename Storage::const_iterator;
+
+  static_assert(std::is_trivially_copyable_v<entry_t>,
+                "mmap hash storage: entries must be trivially copyable");
+
+  static_assert(alignof(Storage) <= sizeof(hash_t));
+
+  // "CISTAHMP" (little-endian)
+  static constexpr auto const MAGIC = hash_t{0x504D484154534943ULL};
+  static constexpr auto const STORAGE_START = 2U * sizeof(hash_t);
+  static constexpr auto const DATA_ALIGNMENT =
+      std::max(alignof(entry_t), alignof(Storage));
+  static constexpr auto const DATA_START =
+      to_next_multiple(STORAGE_START + sizeof(Storage), DATA_ALIGNMENT);
+
+  explicit basic_mmap_hash_storage(cista::mmap mmap) : mmap_{std::move(mmap)} {
+    if (mmap_.size() == 0U) {
+      initialize();
+    } else {
+      check();
+    }
+  }
+
+  Storage& storage() noexcept {
+    return *reinterpret_cast<Storage*>(mmap_.data() + STORAGE_START);
+  }
+  Storage const& storage() const noexcept {
+    return *reinterpret_cast<Storage const*>(mmap_.data() + STORAGE_START);
+  }
+
+  template <typename Key>
+  iterator find(Key&& key) {
+    return storage().find(std::forward<Key>(key));
+  }
+
+  template <typename Key>
+  const_iterator find(Key&& key) const {
+    return storage().find(std::forward<Key>(key));
+  }
+
+  template <typename Key>
+  mapped_type& at(Key&& key) {
+    return storage().at(std::forward<Key>(key));
+  }
+
+  template <typename Key>
+  mapped_type const& at(Key&& key) const {
+    return storage().at(std::forward<Key>(key));
+  }
+
+  template <typename Key>
+  bool contains(Key&& key) const {
+    return find(std::forward<Key>(key)) != end();
+  }
+
+  template <typename Key>
+  mapped_type& operator[](Key&& key) {
+    if (storage().growth_left_ == 0U && !contains(key)) {
+      grow();
+    }
+    return storage()[std::forward<Key>(key)];
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto entry = entry_t{std::forward<Args>(args)...};
+    if (storage().growth_left_ == 0U) {
+      if (auto const it = find(typename Storage::get_key_t{}(entry));
+          it != end()) {
+        return {it, false};
+      }
+      grow();
+    }
+    return storage().emplace(std::move(entry));
+  }
+
+  std::pair<iterator, bool> insert(entry_t const& entry) {
+    return emplace(entry);
+  }
+
+  template <typename Key>
+  std::size_t erase(Key&& key) {
+    return storage().erase(std::forward<Key>(key));
+  }
+
+  void reserve(size_type const n) {
+    auto const new_capacity = Storage::capacity_for(n);
+    if (new_capacity > storage().capacity_) {
+      grow(new_capacity);
+    }
+  }
+
+  void clear() {
+    mmap_.resize(DATA_START);
+    initialize();
+  }
+
+  // Rehashes in-file (see `hash_storage::set_seed`).
+  void set_seed(hash_t const seed) {
+    storage().seed_ = seed;
+    if (storage().capacity_ != 0U) {
+      grow(storage().capacity_);
+    }
+  }
+
+  void sync() { mmap_.sync(); }
+
+  iterator begin() { return storage().begin(); }
+  iterator end() { return storage().end(); }
+  const_iterator begin() const { return storage().begin(); }
+  const_iterator end() const { return storage().end(); }
+
+  friend iterator begin(basic_mmap_hash_storage& m) { return m.begin(); }
+  friend iterator end(basic_mmap_hash_storage& m) { return m.end(); }
+  friend const_iterator begin(basic_mmap_hash_storage const& m) {
+    return m.begin();
+  }
+  friend const_iterator end(basic_mmap_hash_storage const& m) {
+    return m.end();
+  }
+
+  size_type size() const noexcept { return storage().size(); }
+  size_type capacity() const noexcept { return storage().capacity(); }
+  bool empty() const noexcept { return storage().empty(); }
+
+private:
+  void initialize() {
+    constexpr auto const empty_group_size =
+        16U * sizeof(typename Storage::ctrl_t);
+    mmap_.resize(DATA_START + Storage::storage_size(0U));
+    hash_t const header[] = {MAGIC, fingerprint()};
+    std::memcpy(mmap_.data(), header, sizeof(header));
+    auto& s = *new (mmap_.data() + STORAGE_START) Storage{};
+    std::memcpy(mmap_.data() + DATA_START, Storage::empty_group(),
+                empty_group_size);
+    s.ctrl_ = reinterpret_cast<typename Storage::ctrl_t*>(mmap_.data() +
+                                                          DATA_START);
+  }
+
+  static hash_t fingerprint() {
+    return hash_combine(hash(canonical_type_str<Storage>()), sizeof(Storage),
+                        sizeof(entry_t), alignof(entry_t));
+  }
+
+  // Existing file: written for `Storage`, header consistent with the size.
+  void check() const {
+    hash_t header[2U];
+    verify(mmap_.size() >= DATA_START, "mmap hash storage: invalid file");
+    std::memcpy(header, mmap_.data(), sizeof(header));
+    verify(header[0U] == MAGIC, "mmap hash storage: invalid file");
+    verify(header[1U] == fingerprint(), "mmap hash storage: invalid type");
+
+    auto const& s = storage();
+    auto const data = mmap_.data() + DATA_START;
+    verify(mmap_.size() == DATA_START + Storage::storage_size(s.capacity_),
+           "mmap hash storage: file size does not match capacity");
+    verify(s.size_ <= s.capacity_ &&
+               (s.capacity_ == 0U ||
+                reinterpret_cast<std::uint8_t const*>(s.entries_.get()) ==
+                    data) &&
+               reinterpret_cast<std::uint8_t const*>(s.ctrl_.get()) ==
+                   data + std::size_t{s.capacity_} * sizeof(entry_t),
+           "mmap hash storage: invalid header");
+  }
+
+  void grow() { grow(storage().capacity_ * 2U + 1U); }
+
+  void grow(size_type const new_capacity) {
+    auto const size = Storage::storage_size(new_capacity);
+    auto const tmp_start = to_next_multiple(mmap_.size(), DATA_ALIGNMENT);
+
+    mmap_.resize(tmp_start + size);
+    storage().resize(new_capacity, mmap_.data() + tmp_start);
+
+    std::memmove(mmap_.data() + DATA_START, mmap_.data() + tmp_start, size);
+    mmap_.resize(DATA_START + size);
+
+    auto& s = storage();
+    s.entries_ = reinterpret_cast<entry_t*>(mmap_.data() + DATA_START);
+    s.ctrl_ = reinterpret_cast<typename Storage::ctrl_t*>(
+        mmap_.data() + DATA_START + new_capacity * sizeof(entry_t));
+  }
+
+  cista::mmap mmap_;
+};
+
+template <typename Key, typename Value, typename Hash = hashing<Key>,
+          typename Eq = equal_to<Key>>
+using mmap_hash_map =
+    basic_mmap_hash_storage<offset::hash_map<Key, Value, Hash, Eq>>;
+
+template <typename T, typename Hash = hashing<T>, typename Eq = equal_to<T>>
+using mmap_hash_set = basic_mmap_hash_storage<offset::hash_set<T, Hash, Eq>>;
+
+}  // namespace cista
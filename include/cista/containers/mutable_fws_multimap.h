@@ -9,12 +9,15 @@
 #include <optional>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include "cista/bit_counting.h"
 #include "cista/containers/array.h"
 #include "cista/containers/vector.h"
+#include "cista/containers/vecvec.h"
 #include "cista/exception.h"
 #include "cista/next_power_of_2.h"
+#include "cista/parallel_for.h"
 #include "cista/verify.h"
 
 namespace cista {
@@ -36,6 +39,9 @@ struct dynamic_fws_multimap_base {
   };
   using index_vec_t = Vec<index_type>;
 
+  // Contiguous read-only form (see `freeze()`).
+  using frozen_t = basic_vecvec<SizeType, data_vec_t, Vec<size_type>>;
+
   template <bool Const>
   struct bucket {
     friend dynamic_fws_multimap_base;
@@ -493,6 +499,73 @@ struct dynamic_fws_multimap_base {
     element_count_ = 0U;
   }
 
+  // Copies all buckets back to back (without capacity slack and free
+  // buckets) to the empty `out`, e.g. to serialize a read-only version.
+  template <typename Key, typename DataVec, typename IndexVec>
+  void freeze(basic_vecvec<Key, DataVec, IndexVec>& out) const {
+    using index_value_type = typename IndexVec::value_type;
+
+    verify(out.empty() && out.data_.size() == 0U,
+           "dynamic_fws_multimap::freeze: target not empty");
+
+    auto starts = std::vector<std::size_t>(index_.size() + 1U, 0U);
+    for (auto i = std::size_t{0U}; i != index_.size(); ++i) {
+      starts[i + 1U] = starts[i] + index_[i].size_;
+    }
+
+    out.bucket_starts_.reserve(
+        static_cast<typename IndexVec::size_type>(starts.size()));
+    for (auto const start : starts) {
+      out.bucket_starts_.emplace_back(static_cast<index_value_type>(start));
+    }
+
+    out.data_.resize(static_cast<typename DataVec::size_type>(starts.back()));
+    auto const to = out.data_.data();
+    parallel_for_chunks(
+        index_.size(),
+        [&](std::size_t, std::size_t const from, std::size_t const until) {
+          for (auto i = from; i != until; ++i) {
+            auto const& idx = index_[static_cast<size_type>(i)];
+            std::copy(data_.begin() + idx.begin_,
+                      data_.begin() + idx.begin_ + idx.size_, to + starts[i]);
+          }
+        });
+  }
+
+  frozen_t freeze() const {
+    auto v = frozen_t{};
+    freeze(v);
+    return v;
+  }
+
+  // Replaces the contents with the buckets of `v` (e.g. a `freeze()`
+  // result) to continue updating. Buckets get power of two capacities.
+  template <typename Key, typename DataVec, typename IndexVec>
+  void thaw(basic_vecvec<Key, DataVec, IndexVec> const& v) {
+    relayout(
+        static_cast<size_type>(v.size()),
+        [&](size_type const i) {
+          return static_cast<size_type>(v[Key{i}].size());
+        },
+        [&](size_type const i, value_type* to) {
+          auto const b = v[Key{i}];
+          std::copy(b.begin(), b.end(), to);
+        });
+  }
+
+  // Moves all buckets back to back, each with the smallest power of two
+  // capacity that fits its entries, and drops all free buckets.
+  void shrink_to_fit() {
+    relayout(
+        static_cast<size_type>(index_.size()),
+        [&](size_type const i) { return index_[i].size_; },
+        [&](size_type const i, value_type* to) {
+          auto const& idx = index_[i];
+          std::copy(data_.begin() + idx.begin_,
+                    data_.begin() + idx.begin_ + idx.size_, to);
+        });
+  }
+
   size_type insert_new_entry(size_type const i) {
     auto const map_index = to_idx(i);
     assert(map_index < index_.size());
@@ -615,6 +688,42 @@ struct dynamic_fws_multimap_base {
     return data_index;
   }
 
+  template <typename GetSize, typename Copy>
+  void relayout(size_type const n, GetSize&& get_size, Copy&& copy) {
+    auto index = index_vec_t{};
+    index.resize(n);
+    auto data_size = std::size_t{0U};
+    auto count = std::size_t{0U};
+    for (auto i = size_type{0U}; i != n; ++i) {
+      auto const size = get_size(i);
+      auto const capacity =
+          size == 0U ? size_type{0U}
+                     : size_type{cista::next_power_of_two(to_idx(size))};
+      verify(capacity == 0U || get_order(capacity) <= Log2MaxEntriesPerBucket,
+             "dynamic_fws_multimap: too many entries in a bucket");
+      index[i] = index_type{static_cast<size_type>(data_size), size, capacity};
+      data_size += capacity;
+      count += size;
+    }
+
+    auto data = data_vec_t{};
+    data.resize(static_cast<size_type>(data_size));
+    parallel_for_chunks(
+        n, [&](std::size_t, std::size_t const from, std::size_t const to) {
+          for (auto i = from; i != to; ++i) {
+            auto const b = static_cast<size_type>(i);
+            copy(b, data.data() + index[b].begin_);
+          }
+        });
+
+    index_ = std::move(index);
+    data_ = std::move(data);
+    for (auto& f : free_buckets_) {
+      f.clear();
+    }
+    element_count_ = static_cast<size_type>(count);
+  }
+
   static size_type get_order(size_type const size) {
     return size_type{cista::trailing_zeros(to_idx(size))};
   }
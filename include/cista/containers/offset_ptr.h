@@ -6,10 +6,12 @@
 #endif
 #endif
 #include <cstring>
+#include <limits>
 #include <type_traits>
 
 #include "cista/offset_t.h"
 #include "cista/strong.h"
+#include "cista/verify.h"
 
 namespace cista {
 
@@ -25,13 +27,34 @@ inline offset_t to_offset(void const* ptr) noexcept {
 }
 #endif
 
-template <typename T, typename Enable = void>
+// Narrow offsets (`OffsetT` smaller than `offset_t`, e.g. `offset32::ptr`)
+// can only reach targets within their range: a pointer further away than
+// that (e.g. from a stack object into the heap) throws on assignment. Build
+// such data inside one `arena`.
+template <typename OffsetT>
+inline OffsetT narrow_offset(offset_t const offset) {
+  if constexpr (sizeof(OffsetT) < sizeof(offset_t)) {
+    verify(offset > static_cast<offset_t>(
+                        std::numeric_limits<OffsetT>::min()) &&
+               offset <= static_cast<offset_t>(
+                             std::numeric_limits<OffsetT>::max()),
+           "offset_ptr: target out of offset range");
+  }
+  return static_cast<OffsetT>(offset);
+}
+
+template <typename T, typename OffsetT = offset_t, typename Enable = void>
 struct offset_ptr {
+  static constexpr auto const NULLPTR_OFFSET =
+      std::numeric_limits<OffsetT>::min();
+  static constexpr auto const IS_NOEXCEPT =
+      sizeof(OffsetT) == sizeof(offset_t);
+
   constexpr offset_ptr() noexcept = default;
   constexpr offset_ptr(std::nullptr_t) noexcept : offset_{NULLPTR_OFFSET} {}
-  offset_ptr(T const* p) noexcept : offset_{ptr_to_offset(p)} {}
+  offset_ptr(T const* p) noexcept(IS_NOEXCEPT) : offset_{ptr_to_offset(p)} {}
 
-  offset_ptr& operator=(T const* p) noexcept {
+  offset_ptr& operator=(T const* p) noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(p);
     return *this;
   }
@@ -40,22 +63,25 @@ struct offset_ptr {
     return *this;
   }
 
-  offset_ptr(offset_ptr const& o) noexcept : offset_{ptr_to_offset(o.get())} {}
-  offset_ptr(offset_ptr&& o) noexcept : offset_{ptr_to_offset(o.get())} {}
-  offset_ptr& operator=(offset_ptr const& o) noexcept {
+  offset_ptr(offset_ptr const& o) noexcept(IS_NOEXCEPT)
+      : offset_{ptr_to_offset(o.get())} {}
+  offset_ptr(offset_ptr&& o) noexcept(IS_NOEXCEPT)
+      : offset_{ptr_to_offset(o.get())} {}
+  offset_ptr& operator=(offset_ptr const& o) noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(o.get());
     return *this;
   }
-  offset_ptr& operator=(offset_ptr&& o) noexcept {
+  offset_ptr& operator=(offset_ptr&& o) noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(o.get());
     return *this;
   }
 
   ~offset_ptr() noexcept = default;
 
-  offset_t ptr_to_offset(T const* p) const noexcept {
+  OffsetT ptr_to_offset(T const* p) const noexcept(IS_NOEXCEPT) {
     return p == nullptr ? NULLPTR_OFFSET
-                        : static_cast<offset_t>(to_offset(p) - to_offset(this));
+                        : narrow_offset<OffsetT>(static_cast<offset_t>(
+                              to_offset(p) - to_offset(this)));
   }
 
   explicit operator bool() const noexcept { return offset_ != NULLPTR_OFFSET; }
@@ -94,29 +120,38 @@ struct offset_ptr {
     return get() - s.v_;
   }
 
-  offset_ptr& operator++() noexcept {
+  offset_ptr& operator++() noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(get() + 1);
     return *this;
   }
 
-  offset_ptr& operator--() noexcept {
+  offset_ptr& operator--() noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(get() - 1);
     return *this;
   }
 
-  offset_ptr operator++(int) const noexcept { return offset_ptr{get() + 1}; }
-  offset_ptr operator--(int) const noexcept { return offset_ptr{get() - 1}; }
+  offset_ptr operator++(int) const noexcept(IS_NOEXCEPT) {
+    return offset_ptr{get() + 1};
+  }
+  offset_ptr operator--(int) const noexcept(IS_NOEXCEPT) {
+    return offset_ptr{get() - 1};
+  }
 
-  offset_t offset_{NULLPTR_OFFSET};
+  OffsetT offset_{NULLPTR_OFFSET};
 };
 
-template <typename T>
-struct offset_ptr<T, std::enable_if_t<std::is_same_v<void, T>>> {
+template <typename T, typename OffsetT>
+struct offset_ptr<T, OffsetT, std::enable_if_t<std::is_same_v<void, T>>> {
+  static constexpr auto const NULLPTR_OFFSET =
+      std::numeric_limits<OffsetT>::min();
+  static constexpr auto const IS_NOEXCEPT =
+      sizeof(OffsetT) == sizeof(offset_t);
+
   constexpr offset_ptr() noexcept = default;
   constexpr offset_ptr(std::nullptr_t) noexcept : offset_{NULLPTR_OFFSET} {}
-  offset_ptr(T const* p) noexcept : offset_{ptr_to_offset(p)} {}
+  offset_ptr(T const* p) noexcept(IS_NOEXCEPT) : offset_{ptr_to_offset(p)} {}
 
-  offset_ptr& operator=(T const* p) noexcept {
+  offset_ptr& operator=(T const* p) noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(p);
     return *this;
   }
@@ -125,20 +160,23 @@ struct offset_ptr<T, std::enable_if_t<std::is_same_v<void, T>>> {
     return *this;
   }
 
-  offset_ptr(offset_ptr const& o) noexcept : offset_{ptr_to_offset(o.get())} {}
-  offset_ptr(offset_ptr&& o) noexcept : offset_{ptr_to_offset(o.get())} {}
-  offset_ptr& operator=(offset_ptr const& o) noexcept {
+  offset_ptr(offset_ptr const& o) noexcept(IS_NOEXCEPT)
+      : offset_{ptr_to_offset(o.get())} {}
+  offset_ptr(offset_ptr&& o) noexcept(IS_NOEXCEPT)
+      : offset_{ptr_to_offset(o.get())} {}
+  offset_ptr& operator=(offset_ptr const& o) noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(o.get());
     return *this;
   }
-  offset_ptr& operator=(offset_ptr&& o) noexcept {
+  offset_ptr& operator=(offset_ptr&& o) noexcept(IS_NOEXCEPT) {
     offset_ = ptr_to_offset(o.get());
     return *this;
   }
 
-  offset_t ptr_to_offset(T const* p) const noexcept {
+  OffsetT ptr_to_offset(T const* p) const noexcept(IS_NOEXCEPT) {
     return p == nullptr ? NULLPTR_OFFSET
-                        : static_cast<offset_t>(to_offset(p) - to_offset(this));
+                        : narrow_offset<OffsetT>(static_cast<offset_t>(
+                              to_offset(p) - to_offset(this)));
   }
 
   operator bool() const noexcept { return offset_ != NULLPTR_OFFSET; }
@@ -165,7 +203,7 @@ struct offset_ptr<T, std::enable_if_t<std::is_same_v<void, T>>> {
     return o.offset_ != NULLPTR_OFFSET;
   }
 
-  offset_t offset_{NULLPTR_OFFSET};
+  OffsetT offset_{NULLPTR_OFFSET};
 };
 
 template <class T>
@@ -174,8 +212,8 @@ struct is_pointer_helper : std::false_type {};
 template <class T>
 struct is_pointer_helper<T*> : std::true_type {};
 
-template <class T>
-struct is_pointer_helper<offset_ptr<T>> : std::true_type {};
+template <class T, typename OffsetT>
+struct is_pointer_helper<offset_ptr<T, OffsetT>> : std::true_type {};
 
 template <class T>
 constexpr bool is_pointer_v = is_pointer_helper<std::remove_cv_t<T>>::value;
@@ -190,8 +228,8 @@ struct remove_pointer_helper<T*> {
   using type = T;
 };
 
-template <class T>
-struct remove_pointer_helper<offset_ptr<T>> {
+template <class T, typename OffsetT>
+struct remove_pointer_helper<offset_ptr<T, OffsetT>> {
   using type = T;
 };
 
@@ -201,4 +239,22 @@ struct remove_pointer : remove_pointer_helper<std::remove_cv_t<T>> {};
 template <typename T>
 using remove_pointer_t = typename remove_pointer<T>::type;
 
+// Type of the value stored for a pointer of type `Ptr` in serialized data.
+template <typename Ptr>
+struct ptr_offset {
+  using type = offset_t;
+};
+
+template <typename T, typename OffsetT>
+struct ptr_offset<offset_ptr<T, OffsetT>> {
+  using type = OffsetT;
+};
+
+template <typename Ptr>
+using ptr_offset_t = typename ptr_offset<std::remove_cv_t<Ptr>>::type;
+
+// Pointers with offsets narrower than `offset_t` (`offset32::ptr`).
+template <typename Ptr>
+constexpr bool is_narrow_ptr_v = sizeof(ptr_offset_t<Ptr>) < sizeof(offset_t);
+
 }  // namespace cista
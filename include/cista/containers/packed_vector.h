@@ -0,0 +1,466 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+#include "cista/bit_counting.h"
+#include "cista/containers/vector.h"
+#include "cista/unused_param.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+namespace detail {
+
+// Bits required to store `x`.
+constexpr unsigned required_bits(std::uint64_t const x) noexcept {
+  return x == 0U ? 0U : 64U - leading_zeros(x);
+}
+
+constexpr std::uint64_t bit_mask(unsigned const bits) noexcept {
+  return bits == 64U ? ~std::uint64_t{0U}
+                     : (std::uint64_t{1U} << bits) - std::uint64_t{1U};
+}
+
+// Reads the `bits` wide value starting at bit `bit` of `in`.
+// Requires the word behind the value's first word to be readable.
+inline std::uint64_t packed_extract(std::uint64_t const* in,
+                                    std::uint64_t const bit,
+                                    unsigned const bits) noexcept {
+  auto const word = bit / 64U;
+  auto const shift = static_cast<unsigned>(bit % 64U);
+  auto const lo = in[word] >> shift;
+  auto const hi = (in[word + 1U] << 1U) << (63U - shift);
+  return (lo | hi) & bit_mask(bits);
+}
+
+inline void packed_insert(std::uint64_t* in, std::uint64_t const bit,
+                          unsigned const bits, std::uint64_t const x) noexcept {
+  if (bits == 0U) {
+    return;
+  }
+  auto const word = bit / 64U;
+  auto const shift = static_cast<unsigned>(bit % 64U);
+  auto const m = bit_mask(bits);
+  auto const v = x & m;  // never touch the neighbouring values
+  in[word] = (in[word] & ~(m << shift)) | (v << shift);
+  if (shift + bits > 64U) {
+    auto const hi_shift = 64U - shift;
+    in[word + 1U] = (in[word + 1U] & ~(m >> hi_shift)) | (v >> hi_shift);
+  }
+}
+
+}  // namespace detail
+
+// Width parameter of `basic_packed_vector` for a width chosen at runtime.
+constexpr auto const dynamic_width = 0U;
+
+// Vector of unsigned integers `T` that stores every value with `Bits` bits,
+// back to back in 64 bit words (LSB first; values may span two words).
+// With `Bits == dynamic_width`, the width is stored in `bits_` and grows
+// automatically when a value does not fit (this repacks all values).
+//
+// The word vector always holds one padding word behind the last value, so
+// every value can be read with two loads and without branches.
+//
+//   auto v = data::packed_vector<20U>{};          // 20 bits per value
+//   v.encode(data::vector<std::uint32_t>{...});  // bulk encode
+//   v.decode(0U, v.size(), out);                  // bulk decode to out[]
+//
+// Usable as the index vector of `basic_vecvec` / `fws_multimap`:
+//
+//   cista::basic_vecvec<key, data::vector<V>, data::packed_vector<24U>>
+template <typename T, typename Vec, unsigned Bits>
+struct basic_packed_vector {
+  using block_t = typename Vec::value_type;
+  using size_type = typename Vec::size_type;
+  using value_type = T;
+
+  static_assert(std::is_same_v<block_t, std::uint64_t>,
+                "packed_vector: blocks have to be 64 bit");
+  static_assert(std::is_unsigned_v<T> && sizeof(T) <= sizeof(block_t),
+                "packed_vector: value type has to be unsigned");
+  static_assert(Bits <= sizeof(T) * 8U, "packed_vector: too many bits");
+
+  static constexpr auto const bits_per_block = 64U;
+  static constexpr auto const is_dynamic = Bits == dynamic_width;
+
+  struct reference {
+    reference(basic_packed_vector* v, size_type const i) : v_{v}, i_{i} {}
+    reference(reference const&) = default;
+
+    operator T() const { return v_->get(i_); }  // NOLINT
+
+    reference const& operator=(T const x) const {
+      v_->set(i_, x);
+      return *this;
+    }
+
+    reference const& operator=(reference const& o) const {
+      return *this = static_cast<T>(o);
+    }
+
+    reference const& operator+=(T const x) const {
+      return *this = static_cast<T>(v_->get(i_) + x);
+    }
+
+    reference const& operator-=(T const x) const {
+      return *this = static_cast<T>(v_->get(i_) - x);
+    }
+
+    reference const& operator++() const { return *this += T{1U}; }
+    reference const& operator--() const { return *this -= T{1U}; }
+
+    basic_packed_vector* v_;
+    size_type i_;
+  };
+
+  struct const_iterator {
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    T operator*() const { return v_->get(i_); }
+    T operator[](difference_type const n) const {
+      return v_->get(static_cast<size_type>(i_ + n));
+    }
+
+    const_iterator& operator++() {
+      ++i_;
+      return *this;
+    }
+    const_iterator& operator--() {
+      --i_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto const tmp = *this;
+      ++i_;
+      return tmp;
+    }
+    const_iterator& operator+=(difference_type const n) {
+      i_ = static_cast<size_type>(i_ + n);
+      return *this;
+    }
+    const_iterator& operator-=(difference_type const n) {
+      i_ = static_cast<size_type>(i_ - n);
+      return *this;
+    }
+    const_iterator operator+(difference_type const n) const {
+      return {v_, static_cast<size_type>(i_ + n)};
+    }
+    const_iterator operator-(difference_type const n) const {
+      return {v_, static_cast<size_type>(i_ - n)};
+    }
+    difference_type operator-(const_iterator const& o) const {
+      return static_cast<difference_type>(i_) -
+             static_cast<difference_type>(o.i_);
+    }
+
+    friend bool operator==(const_iterator const& a, const_iterator const& b) {
+      return a.i_ == b.i_;
+    }
+    friend bool operator!=(const_iterator const& a, const_iterator const& b) {
+      return a.i_ != b.i_;
+    }
+    friend bool operator<(const_iterator const& a, const_iterator const& b) {
+      return a.i_ < b.i_;
+    }
+
+    basic_packed_vector const* v_;
+    size_type i_;
+  };
+
+  // Values are proxies: iteration is read-only, use `operator[]` to write.
+  using iterator = const_iterator;
+
+  auto cista_members() noexcept { return std::tie(blocks_, size_, bits_); }
+
+  static constexpr unsigned required_bits(std::uint64_t const x) noexcept {
+    return detail::required_bits(x);
+  }
+
+  static constexpr block_t mask(unsigned const bits) noexcept {
+    return detail::bit_mask(bits);
+  }
+
+  // Blocks required for `n` values of `bits` bits (incl. the padding word).
+  static constexpr std::uint64_t num_blocks(std::uint64_t const n,
+                                            unsigned const bits) noexcept {
+    if (n == 0U) {
+      return 0U;
+    }
+    // At least one value word (also with `bits == 0`, values are read from
+    // it) followed by the padding word.
+    auto const value_bits = std::max(n * bits, std::uint64_t{1U});
+    return (value_bits + bits_per_block - 1U) / bits_per_block + 1U;
+  }
+
+  unsigned width() const noexcept {
+    if constexpr (is_dynamic) {
+      return bits_;
+    } else {
+      return Bits;
+    }
+  }
+
+  T get(size_type const i) const noexcept {
+    assert(i < size_);
+    return static_cast<T>(detail::packed_extract(
+        blocks_.data(), std::uint64_t{i} * width(), width()));
+  }
+
+  void set(size_type const i, T const x) {
+    assert(i < size_);
+    fit(x);
+    detail::packed_insert(blocks_.data(), std::uint64_t{i} * width(), width(),
+                          x);
+  }
+
+  T operator[](size_type const i) const noexcept { return get(i); }
+  reference operator[](size_type const i) noexcept { return {this, i}; }
+
+  T at(size_type const i) const {
+    verify(i < size_, "packed_vector::at: index out of range");
+    return get(i);
+  }
+
+  reference at(size_type const i) {
+    verify(i < size_, "packed_vector::at: index out of range");
+    return {this, i};
+  }
+
+  T front() const noexcept { return get(0U); }
+  T back() const noexcept { return get(static_cast<size_type>(size_ - 1U)); }
+  reference front() noexcept { return {this, 0U}; }
+  reference back() noexcept {
+    return {this, static_cast<size_type>(size_ - 1U)};
+  }
+
+  void push_back(T const x) {
+    fit(x);
+    resize(static_cast<size_type>(size_ + 1U));
+    detail::packed_insert(blocks_.data(), std::uint64_t{size_ - 1U} * width(),
+                          width(), x);
+  }
+
+  void emplace_back(T const x) { push_back(x); }
+
+  void pop_back() { resize(static_cast<size_type>(size_ - 1U)); }
+
+  void reserve(size_type const n) {
+    blocks_.reserve(static_cast<size_type>(num_blocks(n, width())));
+  }
+
+  // New values are zero.
+  void resize(size_type const n) {
+    if (n < size_) {  // Keep all bits behind the last value zero.
+      auto const bit = std::uint64_t{n} * width();
+      auto const word = static_cast<size_type>(bit / bits_per_block);
+      auto const last = static_cast<size_type>(num_blocks(n, width()));
+      if (word < last) {
+        blocks_[word] &= mask(static_cast<unsigned>(bit % bits_per_block));
+      }
+      for (auto i = static_cast<size_type>(word + 1U); i < last; ++i) {
+        blocks_[i] = 0U;
+      }
+    }
+    blocks_.resize(static_cast<size_type>(num_blocks(n, width())));
+    size_ = n;
+  }
+
+  void clear() {
+    blocks_.clear();
+    size_ = 0U;
+  }
+
+  // Repacks all values with the new width (dynamic width only).
+  void set_width(unsigned const bits) {
+    static_assert(is_dynamic, "packed_vector: width is fixed");
+    verify(bits <= sizeof(T) * 8U, "packed_vector::set_width: too many bits");
+    verify(bits >= required_bits(max()),
+           "packed_vector::set_width: values do not fit");
+    if (bits == bits_) {
+      return;
+    }
+
+    auto repacked = Vec{};
+    repacked.resize(static_cast<size_type>(num_blocks(size_, bits)));
+    auto const old_bits = bits_;
+    for (auto i = std::uint64_t{0U}; i != size_; ++i) {
+      detail::packed_insert(
+          repacked.data(), i * bits, bits,
+          detail::packed_extract(blocks_.data(), i * old_bits, old_bits));
+    }
+    blocks_ = std::move(repacked);
+    bits_ = static_cast<std::uint8_t>(bits);
+  }
+
+  // Replaces the contents with the values of `c`. With dynamic width, the
+  // width is chosen to fit the largest value.
+  template <typename Container>
+  void encode(Container const& c) {
+    using std::begin;
+    using std::end;
+
+    auto const n = static_cast<size_type>(std::distance(begin(c), end(c)));
+    if constexpr (is_dynamic) {
+      auto largest = std::uint64_t{0U};
+      for (auto const& x : c) {
+        largest = std::max(largest, static_cast<std::uint64_t>(x));
+      }
+      bits_ = static_cast<std::uint8_t>(required_bits(largest));
+    }
+
+    clear();
+    blocks_.resize(static_cast<size_type>(num_blocks(n, width())));
+    size_ = n;
+
+    auto const bits = width();
+    if (bits == 0U) {
+      return;
+    }
+
+    auto const m = mask(bits);
+    auto out = blocks_.data();
+    auto acc = block_t{0U};
+    auto fill = 0U;
+    for (auto const& x : c) {
+      auto const v = static_cast<block_t>(x);
+      verify((v & ~m) == 0U, "packed_vector::encode: value does not fit");
+      acc |= v << fill;
+      fill += bits;
+      if (fill >= bits_per_block) {
+        *out++ = acc;
+        fill -= bits_per_block;
+        acc = fill == 0U ? block_t{0U} : v >> (bits - fill);
+      }
+    }
+    if (fill != 0U) {
+      *out = acc;
+    }
+  }
+
+  // Decodes the values [from, from + n) to `out[0..n)`. Full groups of 64
+  // values start at a word boundary and are decoded with a loop without
+  // dependencies between iterations, which compilers vectorize.
+  void decode(size_type const from, size_type const n, T* out) const {
+    assert(std::uint64_t{from} + n <= size_);
+    auto const bits = width();
+    if (bits == 0U) {
+      std::fill(out, out + n, T{0U});
+      return;
+    }
+
+    auto i = std::uint64_t{from};
+    auto const to = std::uint64_t{from} + n;
+    auto const in = blocks_.data();
+    for (; i != to && i % bits_per_block != 0U; ++i) {
+      *out++ = static_cast<T>(detail::packed_extract(in, i * bits, bits));
+    }
+    for (; i + bits_per_block <= to; i += bits_per_block) {
+      decode_group(in + (i / bits_per_block) * bits, bits, out);
+      out += bits_per_block;
+    }
+    for (; i != to; ++i) {
+      *out++ = static_cast<T>(detail::packed_extract(in, i * bits, bits));
+    }
+  }
+
+  T max() const noexcept {
+    auto m = T{0U};
+    for (auto const x : *this) {
+      m = std::max(m, x);
+    }
+    return m;
+  }
+
+  const_iterator begin() const noexcept { return {this, 0U}; }
+  const_iterator end() const noexcept { return {this, size_}; }
+
+  friend const_iterator begin(basic_packed_vector const& v) {
+    return v.begin();
+  }
+  friend const_iterator end(basic_packed_vector const& v) { return v.end(); }
+
+  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0U; }
+
+  // Memory used by the values.
+  std::size_t size_in_bytes() const noexcept {
+    return blocks_.size() * sizeof(block_t);
+  }
+
+  friend bool operator==(basic_packed_vector const& a,
+                         basic_packed_vector const& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+  friend bool operator!=(basic_packed_vector const& a,
+                         basic_packed_vector const& b) {
+    return !(a == b);
+  }
+
+  Vec blocks_;
+  size_type size_{0U};
+  std::uint8_t bits_{static_cast<std::uint8_t>(Bits)};
+
+private:
+  void fit(T const x) {
+    if constexpr (is_dynamic) {
+      auto const bits = required_bits(x);
+      if (bits > bits_) {
+        set_width(bits);
+      }
+    } else {
+      verify(required_bits(x) <= Bits, "packed_vector: value does not fit");
+    }
+  }
+
+  static void decode_group(block_t const* in, unsigned const bits,
+                           T* out) noexcept {
+    if constexpr (is_dynamic) {
+      for (auto j = 0U; j != bits_per_block; ++j) {
+        out[j] = static_cast<T>(
+            detail::packed_extract(in, std::uint64_t{j} * bits, bits));
+      }
+    } else {
+      CISTA_UNUSED_PARAM(bits)
+      for (auto j = 0U; j != bits_per_block; ++j) {
+        out[j] = static_cast<T>(
+            detail::packed_extract(in, std::uint64_t{j} * Bits, Bits));
+      }
+    }
+  }
+};
+
+namespace raw {
+
+template <unsigned Bits, typename T = std::uint32_t>
+using packed_vector = basic_packed_vector<T, vector<std::uint64_t>, Bits>;
+
+template <typename T = std::uint32_t>
+using dynamic_packed_vector =
+    basic_packed_vector<T, vector<std::uint64_t>, dynamic_width>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <unsigned Bits, typename T = std::uint32_t>
+using packed_vector = basic_packed_vector<T, vector<std::uint64_t>, Bits>;
+
+template <typename T = std::uint32_t>
+using dynamic_packed_vector =
+    basic_packed_vector<T, vector<std::uint64_t>, dynamic_width>;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
+#include <iterator>
 #include <limits>
+#include <vector>
 
 #include "cista/bit_counting.h"
 #include "cista/containers/array.h"
@@ -116,6 +119,79 @@ struct paged {
     std::memcpy(data(to), &*begin, n * sizeof(value_type));
   }
 
+  // State of an incremental compaction (see `start_compaction`).
+  struct compaction {
+    std::vector<std::size_t> order_;  // live pages, sorted by start
+    std::size_t next_{0U};
+    size_type end_{0U};
+  };
+
+  // Starts to move the live pages `pages` (all pages not in a free list,
+  // e.g. the index of a `paged_vecvec`) back to back to the front of
+  // `data_`. Drops the free lists. Until `compact_step` returns true, the
+  // pages may be read but not created, resized or freed.
+  template <typename Pages>
+  compaction start_compaction(Pages const& pages) {
+    using std::begin;
+    using std::end;
+
+    auto c = compaction{};
+    auto const first = begin(pages);
+    auto const n = static_cast<std::size_t>(std::distance(first, end(pages)));
+    for (auto i = std::size_t{0U}; i != n; ++i) {
+      if (first[static_cast<std::ptrdiff_t>(i)].valid()) {
+        c.order_.push_back(i);
+      }
+    }
+    std::sort(c.order_.begin(), c.order_.end(),
+              [&](std::size_t const a, std::size_t const b) {
+                return first[static_cast<std::ptrdiff_t>(a)].start_ <
+                       first[static_cast<std::ptrdiff_t>(b)].start_;
+              });
+    for (auto& f : free_list_) {
+      f = node{};
+    }
+    return c;
+  }
+
+  // Moves pages (shrinking their capacity to the minimum) until at least
+  // `max_elements` values have been moved. Returns true and truncates
+  // `data_` when all pages are in place.
+  template <typename Pages>
+  bool compact_step(compaction& c, Pages& pages,
+                    std::size_t const max_elements) {
+    using std::begin;
+
+    auto const first = begin(pages);
+    auto moved = std::size_t{0U};
+    while (c.next_ != c.order_.size() && moved < max_elements) {
+      auto& p = first[static_cast<std::ptrdiff_t>(c.order_[c.next_++])];
+      auto const capacity = static_cast<PageSizeType>(
+          next_power_of_two(std::max(MinPageSize, p.size_)));
+      if (p.start_ != c.end_) {  // never moves up: c.end_ <= p.start_
+        std::memmove(&data_[c.end_], &data_[p.start_],
+                     p.size_ * sizeof(value_type));
+      }
+      p.start_ = c.end_;
+      p.capacity_ = capacity;
+      c.end_ += capacity;
+      moved += std::max(std::size_t{1U}, static_cast<std::size_t>(p.size_));
+    }
+
+    if (c.next_ != c.order_.size()) {
+      return false;
+    }
+    data_.resize(c.end_);
+    return true;
+  }
+
+  // Closes all holes of freed pages and truncates `data_`.
+  template <typename Pages>
+  void compact(Pages& pages) {
+    auto c = start_compaction(pages);
+    compact_step(c, pages, std::numeric_limits<std::size_t>::max());
+  }
+
   struct node {
     bool empty() const {
       return next_ == std::numeric_limits<size_type>::max();
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cassert>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
 #include "cista/strong.h"
 
 namespace cista {
@@ -292,6 +297,20 @@ struct paged_vecvec {
     idx_.resize(size);
   }
 
+  // Closes the holes left by freed pages and truncates the data storage.
+  void compact() { paged_.compact(idx_); }
+
+  // Incremental `compact()`: call `compact_step` with a work limit until
+  // it returns true. In between, buckets can be read but not modified.
+  typename Paged::compaction start_compaction() {
+    return paged_.start_compaction(idx_);
+  }
+
+  bool compact_step(typename Paged::compaction& c,
+                    std::size_t const max_elements) {
+    return paged_.compact_step(c, idx_, max_elements);
+  }
+
   Paged paged_;
   Index idx_;
 };
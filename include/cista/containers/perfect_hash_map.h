@@ -0,0 +1,443 @@
+#pragma once
+
+#include <cinttypes>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cista/containers/pair.h"
+#include "cista/containers/vector.h"
+#include "cista/decay.h"
+#include "cista/equal_to.h"
+#include "cista/exception.h"
+#include "cista/hash.h"
+#include "cista/hashing.h"
+#include "cista/parallel_for.h"
+
+namespace cista {
+
+// Static minimal perfect hash map for build-once, query-only data.
+//
+// Entries are stored densely (no empty slots, no ctrl bytes) in `entries_`.
+// The position of a key is computed PTHash-style:
+//   - hash -> shard (independent sub-tables, built in parallel)
+//   - hash -> bucket within the shard
+//   - bucket -> pilot (16bit, found at build time)
+//   - hash ^ hash(pilot) -> slot in a table slightly larger than the shard
+//   - slots beyond the shard size are remapped to the unused slots
+//     below it (`free_slots_`, ~3% of the keys)
+// A lookup touches exactly one entry. Keys that were not part of the build
+// map to an arbitrary entry and are rejected by the key comparison.
+//
+// PTHash: https://arxiv.org/abs/2104.10402
+template <typename Key, typename Value, template <typename> typename Vec,
+          typename Hash, typename Eq>
+struct basic_perfect_hash_map {
+  using key_type = Key;
+  using mapped_type = Value;
+  using entry_t = pair<Key, Value>;
+  using value_type = entry_t;
+  using size_type = std::uint32_t;
+  using pilot_t = std::uint16_t;
+  using iterator = typename Vec<entry_t>::const_iterator;
+  using const_iterator = iterator;
+
+  struct shard {
+    size_type entry_start_, bucket_start_, free_start_;
+  };
+
+  static constexpr auto const SHARD_SIZE = size_type{4096U};
+  static constexpr auto const AVG_BUCKET_SIZE = size_type{5U};
+  static constexpr auto const MAX_SEED_ATTEMPTS = 16U;
+
+  // Maps a uniformly distributed hash to [0, n) without division.
+  static constexpr size_type fast_range(std::uint64_t const h,
+                                        size_type const n) noexcept {
+    return static_cast<size_type>(((h >> 32U) * n) >> 32U);
+  }
+
+  static constexpr size_type num_buckets(size_type const shard_size) noexcept {
+    return std::max(size_type{1U},
+                    (shard_size + AVG_BUCKET_SIZE - 1U) / AVG_BUCKET_SIZE);
+  }
+
+  // Load factor ~0.97 keeps the pilot search for the last buckets short.
+  static constexpr size_type table_size(size_type const shard_size) noexcept {
+    return shard_size + shard_size / 32U;
+  }
+
+  static constexpr std::uint64_t bucket_hash(std::uint64_t const h) noexcept {
+    return hash_mix(h ^ 0x9E3779B97F4A7C15ULL);
+  }
+
+  static constexpr std::uint64_t position_hash(std::uint64_t const h,
+                                               pilot_t const pilot) noexcept {
+    return hash_mix(h ^ hash_mix(pilot + 0xC2B2AE3D27D4EB4FULL));
+  }
+
+  template <typename K>
+  hash_t compute_hash(K const& key) const {
+    auto const seeded = [&](auto&& hasher) {
+      if constexpr (std::is_invocable_v<decltype(hasher), K const&, hash_t>) {
+        return hash_mix(hash_combine(seed_, hasher(key, seed_)));
+      } else {
+        return hash_mix(hash_combine(seed_, hasher(key)));
+      }
+    };
+    if constexpr (std::is_same_v<decay_t<K>, key_type>) {
+      return static_cast<hash_t>(seeded(Hash{}));
+    } else {
+      return static_cast<hash_t>(seeded(Hash::template create<K>()));
+    }
+  }
+
+  size_type num_shards() const noexcept {
+    return shards_.empty() ? 0U : static_cast<size_type>(shards_.size() - 1U);
+  }
+
+  // Position of `key` in `entries_` if it is contained, `size()` otherwise.
+  template <typename K>
+  size_type position(K const& key) const {
+    if (empty()) {
+      return size();
+    }
+
+    auto const h = compute_hash(key);
+    auto const s = fast_range(h, num_shards());
+    auto const first = shards_[s];
+    auto const last = shards_[s + 1U];
+    auto const shard_size = last.entry_start_ - first.entry_start_;
+    if (shard_size == 0U) {
+      return size();
+    }
+
+    auto const b = fast_range(bucket_hash(h),
+                              last.bucket_start_ - first.bucket_start_);
+    auto const pilot = pilots_[first.bucket_start_ + b];
+    auto slot = fast_range(position_hash(h, pilot), table_size(shard_size));
+    if (slot >= shard_size) {
+      slot = free_slots_[first.free_start_ + slot - shard_size];
+    }
+
+    auto const pos = first.entry_start_ + slot;
+    return Eq{}(entries_[pos].first, key) ? pos : size();
+  }
+
+  template <typename K>
+  const_iterator find(K const& key) const {
+    return begin() + position(key);
+  }
+
+  template <typename K>
+  bool contains(K const& key) const {
+    return position(key) != size();
+  }
+
+  template <typename K>
+  mapped_type const& at(K const& key) const {
+    auto const pos = position(key);
+    if (pos == size()) {
+      throw_exception(std::out_of_range{"perfect_hash_map::at() not found"});
+    }
+    return entries_[pos].second;
+  }
+
+  template <typename K>
+  mapped_type const& operator[](K const& key) const {
+    return at(key);
+  }
+
+  // Replaces the contents with the entries in [first, last).
+  // Keys have to be unique. Throws `std::invalid_argument` otherwise.
+  template <typename It>
+  void build(It first, It last) {
+    static_assert(std::is_base_of_v<
+                      std::forward_iterator_tag,
+                      typename std::iterator_traits<It>::iterator_category>,
+                  "perfect_hash_map::build requires forward iterators");
+
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    if (n > std::numeric_limits<size_type>::max() / 2U) {
+      throw_exception(std::length_error{"perfect_hash_map: too many entries"});
+    }
+
+    auto its = std::vector<It>{};
+    its.reserve(n);
+    for (auto it = first; it != last; ++it) {
+      its.emplace_back(it);
+    }
+
+    for (auto attempt = 0U; attempt != MAX_SEED_ATTEMPTS; ++attempt) {
+      seed_ = hash_mix(BASE_HASH + attempt);
+      if (try_build(its)) {
+        return;
+      }
+    }
+    clear();
+    throw_exception(std::runtime_error{"perfect_hash_map: build failed"});
+  }
+
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  friend const_iterator begin(basic_perfect_hash_map const& m) {
+    return m.begin();
+  }
+  friend const_iterator end(basic_perfect_hash_map const& m) {
+    return m.end();
+  }
+
+  size_type size() const noexcept {
+    return static_cast<size_type>(entries_.size());
+  }
+  bool empty() const noexcept { return entries_.empty(); }
+
+  void clear() {
+    entries_.clear();
+    shards_.clear();
+    pilots_.clear();
+    free_slots_.clear();
+    seed_ = 0U;
+  }
+
+  template <typename It>
+  bool try_build(std::vector<It> const& its) {
+    struct item {
+      hash_t hash_;
+      size_type idx_;
+    };
+
+    auto const n = static_cast<size_type>(its.size());
+    auto const num_shards =
+        std::max(size_type{1U}, (n + SHARD_SIZE - 1U) / SHARD_SIZE);
+
+    // Hash all keys, then counting sort by shard.
+    auto hashes = std::vector<hash_t>(n);
+    parallel_for(n, [&](std::size_t const i) {
+      hashes[i] = compute_hash((*its[i]).first);
+    });
+
+    auto shard_starts = std::vector<size_type>(num_shards + 1U, 0U);
+    for (auto const h : hashes) {
+      ++shard_starts[fast_range(h, num_shards) + 1U];
+    }
+
+    shards_.resize(num_shards + 1U);
+    shards_[0U] = {0U, 0U, 0U};
+    for (auto s = size_type{0U}; s != num_shards; ++s) {
+      auto const shard_size = shard_starts[s + 1U];
+      shard_starts[s + 1U] += shard_starts[s];
+      shards_[s + 1U] = {
+          shard_starts[s + 1U],
+          shards_[s].bucket_start_ + num_buckets(shard_size),
+          shards_[s].free_start_ + table_size(shard_size) - shard_size};
+    }
+
+    auto items = std::vector<item>(n);
+    for (auto i = size_type{0U}; i != n; ++i) {
+      items[shard_starts[fast_range(hashes[i], num_shards)]++] = {hashes[i], i};
+    }
+
+    entries_.resize(n);
+    pilots_.resize(shards_[num_shards].bucket_start_);
+    free_slots_.resize(shards_[num_shards].free_start_);
+
+    // Scratch memory of each thread is allocated up front: the pilot search
+    // in the worker threads does not allocate or copy entries (must not
+    // throw). It only records the final position of every entry.
+    struct scratch {
+      std::vector<bool> taken_;
+      std::vector<size_type> slots_;
+      std::vector<std::pair<size_type, size_type>> buckets_;
+    };
+    auto max_shard_size = size_type{0U};
+    for (auto s = size_type{0U}; s != num_shards; ++s) {
+      max_shard_size =
+          std::max(max_shard_size,
+                   shards_[s + 1U].entry_start_ - shards_[s].entry_start_);
+    }
+    auto scratches = std::vector<scratch>(std::min(
+        static_cast<std::size_t>(num_shards), parallel_max_threads()));
+    for (auto& x : scratches) {
+      x.taken_.resize(table_size(max_shard_size));
+      x.slots_.resize(max_shard_size);
+      x.buckets_.reserve(max_shard_size);
+    }
+    auto positions = std::vector<size_type>(n);
+
+    // Shards are independent: find pilots for all of them in parallel.
+    // Every thread gets a contiguous range of whole shards.
+    auto duplicate = std::atomic_bool{false};
+    auto failed = std::atomic_bool{false};
+    auto const build_shard = [&](std::size_t const s, scratch& x) {
+      auto const first = shards_[s];
+      auto const last = shards_[s + 1U];
+      auto const shard_items =
+          items.data() + static_cast<std::size_t>(first.entry_start_);
+      auto const shard_size = last.entry_start_ - first.entry_start_;
+      auto const shard_buckets = last.bucket_start_ - first.bucket_start_;
+      auto const shard_table_size = table_size(shard_size);
+
+      // Equal hashes can not be separated by any pilot.
+      std::sort(shard_items, shard_items + shard_size,
+                [](item const& a, item const& b) { return a.hash_ < b.hash_; });
+      for (auto i = size_type{1U}; i < shard_size; ++i) {
+        if (shard_items[i - 1U].hash_ == shard_items[i].hash_) {
+          if (Eq{}((*its[shard_items[i - 1U].idx_]).first,
+                   (*its[shard_items[i].idx_]).first)) {
+            duplicate = true;
+          } else {
+            failed = true;
+          }
+          return;
+        }
+      }
+
+      // Group by bucket, largest buckets (most constrained) first.
+      auto const bucket_of = [&](item const& it) {
+        return fast_range(bucket_hash(it.hash_), shard_buckets);
+      };
+      std::stable_sort(shard_items, shard_items + shard_size,
+                       [&](item const& a, item const& b) {
+                         return bucket_of(a) < bucket_of(b);
+                       });
+      auto& buckets = x.buckets_;
+      buckets.clear();
+      for (auto i = size_type{0U}; i != shard_size;) {
+        auto j = i;
+        while (j != shard_size &&
+               bucket_of(shard_items[j]) == bucket_of(shard_items[i])) {
+          ++j;
+        }
+        buckets.emplace_back(i, j);
+        i = j;
+      }
+      std::stable_sort(std::begin(buckets), std::end(buckets),
+                       [](auto const& a, auto const& b) {
+                         return a.second - a.first > b.second - b.first;
+                       });
+
+      auto& taken = x.taken_;
+      auto& slots = x.slots_;
+      std::fill(std::begin(taken), std::begin(taken) + shard_table_size,
+                false);
+      auto const try_pilot = [&](size_type const from, size_type const to,
+                                 pilot_t const pilot) {
+        auto const slots_begin = std::begin(slots);
+        for (auto i = from; i != to; ++i) {
+          auto const slot = fast_range(
+              position_hash(shard_items[i].hash_, pilot), shard_table_size);
+          if (taken[slot] || std::find(slots_begin + from, slots_begin + i,
+                                       slot) != slots_begin + i) {
+            return false;
+          }
+          slots[i] = slot;
+        }
+        return true;
+      };
+
+      for (auto const& [from, to] : buckets) {
+        auto pilot = std::uint32_t{0U};
+        while (pilot <= std::numeric_limits<pilot_t>::max() &&
+               !try_pilot(from, to, static_cast<pilot_t>(pilot))) {
+          ++pilot;
+        }
+        if (pilot > std::numeric_limits<pilot_t>::max()) {
+          failed = true;
+          return;
+        }
+        pilots_[first.bucket_start_ + bucket_of(shard_items[from])] =
+            static_cast<pilot_t>(pilot);
+        for (auto i = from; i != to; ++i) {
+          taken[slots[i]] = true;
+        }
+      }
+
+      // Slots >= shard_size are redirected to the free slots < shard_size.
+      auto next_free = size_type{0U};
+      for (auto slot = shard_size; slot != shard_table_size; ++slot) {
+        auto& free_slot = free_slots_[first.free_start_ + slot - shard_size];
+        if (taken[slot]) {
+          while (taken[next_free]) {
+            ++next_free;
+          }
+          free_slot = next_free++;
+        } else {
+          free_slot = 0U;
+        }
+      }
+      for (auto i = size_type{0U}; i != shard_size; ++i) {
+        auto const slot =
+            slots[i] < shard_size
+                ? slots[i]
+                : free_slots_[first.free_start_ + slots[i] - shard_size];
+        positions[shard_items[i].idx_] = first.entry_start_ + slot;
+      }
+    };
+    parallel_for_chunks(
+        num_shards, scratches.size(),
+        [&](std::size_t const chunk, std::size_t const from,
+            std::size_t const to) {
+          for (auto s = from; s != to && !duplicate && !failed; ++s) {
+            build_shard(s, scratches[chunk]);
+          }
+        });
+
+    if (duplicate) {
+      clear();
+      throw_exception(std::invalid_argument{"perfect_hash_map: duplicate key"});
+    }
+    if (failed) {
+      return false;
+    }
+
+    for (auto i = size_type{0U}; i != n; ++i) {
+      entries_[positions[i]] = *its[i];
+    }
+    return true;
+  }
+
+  Vec<entry_t> entries_;
+  Vec<shard> shards_;
+  Vec<pilot_t> pilots_;
+  Vec<size_type> free_slots_;
+  hash_t seed_{0U};
+};
+
+namespace raw {
+
+template <typename K, typename V, typename Hash, typename Eq>
+struct perfect_hash_map_helper {
+  template <typename T>
+  using vec = vector<T>;
+  using type = basic_perfect_hash_map<K, V, vec, Hash, Eq>;
+};
+
+template <typename K, typename V, typename Hash = hashing<K>,
+          typename Eq = equal_to<K>>
+using perfect_hash_map =
+    typename perfect_hash_map_helper<K, V, Hash, Eq>::type;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename K, typename V, typename Hash, typename Eq>
+struct perfect_hash_map_helper {
+  template <typename T>
+  using vec = vector<T>;
+  using type = basic_perfect_hash_map<K, V, vec, Hash, Eq>;
+};
+
+template <typename K, typename V, typename Hash = hashing<K>,
+          typename Eq = equal_to<K>>
+using perfect_hash_map =
+    typename perfect_hash_map_helper<K, V, Hash, Eq>::type;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cinttypes>
+
 #include "cista/containers/offset_ptr.h"
 
 namespace cista {
@@ -18,13 +20,20 @@ using ptr = cista::offset_ptr<T>;
 
 }  // namespace offset
 
+namespace offset32 {
+
+template <typename T>
+using ptr = cista::offset_ptr<T, std::int32_t>;
+
+}  // namespace offset32
+
 template <typename T>
 T* ptr_cast(raw::ptr<T> const p) noexcept {
   return p;
 }
 
-template <typename T>
-T* ptr_cast(offset::ptr<T> const p) noexcept {
+template <typename T, typename OffsetT>
+T* ptr_cast(offset_ptr<T, OffsetT> const& p) noexcept {
   return p.get();
 }
 
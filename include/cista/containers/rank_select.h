@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <limits>
+#include <type_traits>
+
+#include "cista/bit_counting.h"
+#include "cista/containers/vector.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Rank/select directory for a `basic_bitvec` with 64 bit blocks. Built in
+// one pass, stored separately from the bit vector (queries take the bit
+// vector as argument), so it can be serialized next to it and used on
+// deserialized / mmap backed bit vectors.
+//
+// Layout (~3.5% of the bit vector):
+//   - `l0_`: number of ones before each 2^32 bit region,
+//   - `l1_`: per 2048 bit block: ones before the block within its region
+//     (lower 32 bits) and the ones in its first three 512 bit sub-blocks
+//     (3x10 bits),
+//   - `select1_` / `select0_`: block of every `sample_rate`-th one / zero.
+//
+// rank: two directory lookups + at most 8 popcounts.
+// select: sampled block range + binary search over `l1_` + in-block scan.
+//
+//   auto rs = data::rank_select{};
+//   rs.build(bv);
+//   rs.rank1(bv, i);  // ones in [0, i)
+//   rs.select1(bv, k);  // position of the k-th one (0-based)
+template <template <typename> typename Vec>
+struct basic_rank_select {
+  static constexpr auto const block_bits = std::uint64_t{2048U};
+  static constexpr auto const sub_block_bits = std::uint64_t{512U};
+  static constexpr auto const words_per_block = block_bits / 64U;
+  static constexpr auto const words_per_sub_block = sub_block_bits / 64U;
+  static constexpr auto const region_bits = std::uint64_t{1U} << 32U;
+  static constexpr auto const sample_rate = std::uint64_t{8192U};
+
+  template <typename BitVec>
+  void build(BitVec const& bv) {
+    static_assert(std::is_same_v<typename BitVec::block_t, std::uint64_t>);
+
+    clear();
+    size_ = bv.size();
+
+    auto const num_words = (size_ + 63U) / 64U;
+    auto const num_blocks = (size_ + block_bits - 1U) / block_bits;
+    verify(num_blocks <= std::numeric_limits<std::uint32_t>::max(),
+           "rank_select: bit vector too large");
+    l1_.reserve(static_cast<typename Vec<std::uint64_t>::size_type>(
+        num_blocks));
+
+    auto ones = std::uint64_t{0U};
+    for (auto b = std::uint64_t{0U}; b != num_blocks; ++b) {
+      if (b % (region_bits / block_bits) == 0U) {
+        l0_.push_back(ones);
+      }
+
+      auto entry = ones - l0_.back();
+      for (auto s = 0U; s != 4U; ++s) {
+        auto sub_block_ones = std::uint64_t{0U};
+        auto const from = b * words_per_block + s * words_per_sub_block;
+        auto const to = std::min(num_words, from + words_per_sub_block);
+        for (auto w = from; w < to; ++w) {
+          sub_block_ones += popcount(word(bv, w));
+        }
+        if (s != 3U) {
+          entry |= sub_block_ones << (32U + 10U * s);
+        }
+
+        // Blocks of every `sample_rate`-th one / zero.
+        auto const bits =
+            std::min(size_, (from + words_per_sub_block) * 64U) -
+            std::min(size_, from * 64U);
+        auto const zeros_before = std::min(size_, from * 64U) - ones;
+        add_samples(select1_, ones + sub_block_ones, b);
+        add_samples(select0_, zeros_before + (bits - sub_block_ones), b);
+        ones += sub_block_ones;
+      }
+      l1_.push_back(entry);
+    }
+    ones_ = ones;
+  }
+
+  // Number of ones in [0, i), i <= size.
+  template <typename BitVec>
+  std::size_t rank1(BitVec const& bv, std::size_t const i) const noexcept {
+    assert(bv.size() == size_ && i <= size_);
+    if (i == size_) {
+      return static_cast<std::size_t>(ones_);
+    }
+
+    auto const b = i / block_bits;
+    auto const entry = l1_[static_cast<l1_size_type>(b)];
+    auto r = block_rank1(b);
+    auto const s = (i % block_bits) / sub_block_bits;
+    for (auto k = 0U; k != s; ++k) {
+      r += (entry >> (32U + 10U * k)) & 0x3FFU;
+    }
+    auto w = b * words_per_block + s * words_per_sub_block;
+    for (; w != i / 64U; ++w) {
+      r += popcount(bv.blocks_[static_cast<word_size_type<BitVec>>(w)]);
+    }
+    if (i % 64U != 0U) {
+      r += popcount(bv.blocks_[static_cast<word_size_type<BitVec>>(w)] &
+                    ((std::uint64_t{1U} << (i % 64U)) - 1U));
+    }
+    return static_cast<std::size_t>(r);
+  }
+
+  // Number of zeros in [0, i), i <= size.
+  template <typename BitVec>
+  std::size_t rank0(BitVec const& bv, std::size_t const i) const noexcept {
+    return i - rank1(bv, i);
+  }
+
+  // Position of the k-th one (0-based), k < count(). size() if not found
+  // (only possible if the directory does not belong to `bv`).
+  template <typename BitVec>
+  std::size_t select1(BitVec const& bv, std::size_t const k) const noexcept {
+    return select<true>(bv, k);
+  }
+
+  // Position of the k-th zero (0-based), k < size() - count().
+  template <typename BitVec>
+  std::size_t select0(BitVec const& bv, std::size_t const k) const noexcept {
+    return select<false>(bv, k);
+  }
+
+  // Position of the first one in [from, size), size if there is none.
+  template <typename BitVec>
+  std::size_t next_set_bit(BitVec const& bv,
+                           std::size_t const from) const noexcept {
+    if (from >= size_) {
+      return static_cast<std::size_t>(size_);
+    }
+    auto const w = word(bv, from / 64U) >> (from % 64U);
+    if (w != 0U) {
+      return from + trailing_zeros(w);
+    }
+    auto const r = rank1(bv, from);
+    return r == ones_ ? static_cast<std::size_t>(size_) : select1(bv, r);
+  }
+
+  std::size_t count() const noexcept {
+    return static_cast<std::size_t>(ones_);
+  }
+
+  std::size_t size() const noexcept { return static_cast<std::size_t>(size_); }
+
+  std::size_t size_in_bytes() const noexcept {
+    return (l0_.size() + l1_.size()) * sizeof(std::uint64_t) +
+           (select1_.size() + select0_.size()) * sizeof(std::uint32_t);
+  }
+
+  void clear() {
+    l0_.clear();
+    l1_.clear();
+    select1_.clear();
+    select0_.clear();
+    size_ = 0U;
+    ones_ = 0U;
+  }
+
+  std::uint64_t block_rank1(std::uint64_t const b) const noexcept {
+    return l0_[static_cast<typename Vec<std::uint64_t>::size_type>(
+               b / (region_bits / block_bits))] +
+           (l1_[static_cast<l1_size_type>(b)] & 0xFFFFFFFFU);
+  }
+
+  std::uint64_t block_rank(bool const one,
+                           std::uint64_t const b) const noexcept {
+    return one ? block_rank1(b) : b * block_bits - block_rank1(b);
+  }
+
+  Vec<std::uint64_t> l0_;
+  Vec<std::uint64_t> l1_;
+  Vec<std::uint32_t> select1_;
+  Vec<std::uint32_t> select0_;
+  std::uint64_t size_{0U};
+  std::uint64_t ones_{0U};
+
+private:
+  using l1_size_type = typename Vec<std::uint64_t>::size_type;
+
+  template <typename BitVec>
+  using word_size_type = typename BitVec::size_type;
+
+  // Word `w` without the bits behind `size()`.
+  template <typename BitVec>
+  std::uint64_t word(BitVec const& bv, std::uint64_t const w) const noexcept {
+    auto const x = bv.blocks_[static_cast<word_size_type<BitVec>>(w)];
+    auto const end = size_ - w * 64U;
+    return end >= 64U ? x : x & ((std::uint64_t{1U} << end) - 1U);
+  }
+
+  void add_samples(Vec<std::uint32_t>& samples, std::uint64_t const to,
+                   std::uint64_t const b) {
+    for (auto i = samples.size() * sample_rate; i < to;
+         i += sample_rate) {
+      samples.push_back(static_cast<std::uint32_t>(b));
+    }
+  }
+
+  // Position of the r-th (0-based) one in `x`.
+  static unsigned select_in_word(std::uint64_t x, std::uint64_t r) noexcept {
+    auto pos = 0U;
+    for (auto c = popcount(x & 0xFFU); r >= c; c = popcount(x & 0xFFU)) {
+      r -= c;
+      x >>= 8U;
+      pos += 8U;
+    }
+    for (; r != 0U; --r) {
+      x &= x - 1U;
+    }
+    return pos + trailing_zeros(x);
+  }
+
+  template <bool One, typename BitVec>
+  std::size_t select(BitVec const& bv, std::size_t const k) const noexcept {
+    assert(bv.size() == size_);
+    assert(k < (One ? ones_ : size_ - ones_));
+
+    // Block: last block with block_rank <= k in the sampled range.
+    auto const& samples = One ? select1_ : select0_;
+    auto const sample = static_cast<std::uint32_t>(k / sample_rate);
+    auto lo = std::uint64_t{samples[sample]};
+    auto hi = sample + 1U < samples.size()
+                  ? std::uint64_t{samples[sample + 1U]} + 1U
+                  : std::uint64_t{l1_.size()};
+    while (hi - lo > 1U) {
+      auto const mid = lo + (hi - lo) / 2U;
+      if (block_rank(One, mid) <= k) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+
+    // Sub-block.
+    auto r = k - block_rank(One, lo);
+    auto const entry = l1_[static_cast<l1_size_type>(lo)];
+    auto s = 0U;
+    for (; s != 3U; ++s) {
+      auto const ones = (entry >> (32U + 10U * s)) & 0x3FFU;
+      auto const c = One ? ones : sub_block_bits - ones;
+      if (r < c) {
+        break;
+      }
+      r -= c;
+    }
+
+    // Word. Bounded by the bit vector: the directory may be corrupt or
+    // built for another bit vector.
+    auto const num_words = std::uint64_t{bv.blocks_.size()};
+    for (auto w = lo * words_per_block + s * words_per_sub_block;
+         w < num_words; ++w) {
+      auto const x = bv.blocks_[static_cast<word_size_type<BitVec>>(w)];
+      auto const y = One ? x : ~x;
+      auto const c = popcount(y);
+      if (r < c) {
+        return static_cast<std::size_t>(w * 64U + select_in_word(y, r));
+      }
+      r -= c;
+    }
+    return static_cast<std::size_t>(size_);
+  }
+};
+
+namespace raw {
+
+using rank_select = basic_rank_select<vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+using rank_select = basic_rank_select<vector>;
+
+}  // namespace offset
+
+}  // namespace cista
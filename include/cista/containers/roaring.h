@@ -0,0 +1,550 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cinttypes>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "cista/bit_operations.h"
+#include "cista/containers/vector.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Compressed set of 32 bit unsigned integers (Roaring bitmap). Values are
+// partitioned into chunks by their upper 16 bits. Every chunk is stored as
+//   - ARRAY: sorted lower 16 bits (at most `max_array_size` values),
+//   - BITMAP: 2^16 bits,
+//   - RUN: sorted runs as pairs (start, length - 1),
+// whichever is smaller. RUN containers are only created by `encode` and
+// `run_optimize` (set operations produce ARRAY and BITMAP containers).
+//
+// All containers are stored in flat vectors (`values_` for ARRAY / RUN,
+// `bitmaps_` for BITMAP) in key order, so the offset layout can be
+// queried in place from a mmap'd buffer.
+//
+//   auto r = data::roaring{};
+//   r.encode(ids);  // any order, duplicates allowed
+//   r.push_back(x);  // x > all values
+//   auto const common = r & other;
+template <template <typename> typename Vec>
+struct basic_roaring {
+  enum class container_type : std::uint16_t { ARRAY, BITMAP, RUN };
+
+  struct container {
+    std::uint32_t offset_;  // ARRAY/RUN: `values_`, BITMAP: `bitmaps_`
+    std::uint32_t size_;  // entries in `values_` / `bitmaps_`
+    std::uint32_t cardinality_;
+    std::uint16_t key_;
+    container_type type_;
+  };
+
+  static constexpr auto const max_array_size = 4096U;
+  static constexpr auto const bitmap_words = 1024U;
+
+  using bitmap_t = std::array<std::uint64_t, bitmap_words>;
+
+  bool contains(std::uint32_t const x) const noexcept {
+    auto const c = find(key(x));
+    return c != nullptr && test(*c, low(x));
+  }
+
+  // Appends `x` (has to be larger than all values).
+  void push_back(std::uint32_t const x) {
+    verify(empty() || x > back(), "roaring::push_back: not ascending");
+
+    if (containers_.empty() || containers_.back().key_ != key(x)) {
+      containers_.push_back(container{pool_offset(values_), 0U, 0U, key(x),
+                                      container_type::ARRAY});
+    }
+
+    auto& c = containers_.back();
+    switch (c.type_) {
+      case container_type::ARRAY:
+        if (c.size_ == max_array_size) {
+          array_to_bitmap(c);
+          set_bit(bitmaps_.data() + c.offset_, low(x));
+        } else {
+          values_.push_back(low(x));
+          ++c.size_;
+        }
+        break;
+
+      case container_type::BITMAP:
+        set_bit(bitmaps_.data() + c.offset_, low(x));
+        break;
+
+      case container_type::RUN: {
+        auto& length = values_[values_.size() - 1U];
+        if (values_[values_.size() - 2U] + length + 1U == low(x)) {
+          ++length;
+        } else {
+          values_.push_back(low(x));
+          values_.push_back(std::uint16_t{0U});
+          c.size_ += 2U;
+        }
+        break;
+      }
+    }
+    ++c.cardinality_;
+    ++cardinality_;
+  }
+
+  // Replaces the contents with the values of `c` (any order).
+  template <typename Container>
+  void encode(Container const& c) {
+    auto v = std::vector<std::uint32_t>(std::begin(c), std::end(c));
+    std::sort(begin(v), end(v));
+    v.erase(std::unique(begin(v), end(v)), end(v));
+
+    clear();
+    auto lows = std::vector<std::uint16_t>{};
+    for (auto it = begin(v); it != end(v);) {
+      auto const k = key(*it);
+      lows.clear();
+      for (; it != end(v) && key(*it) == k; ++it) {
+        lows.push_back(low(*it));
+      }
+      add_array(k, lows.data(), lows.size(), true);
+    }
+  }
+
+  // Converts containers to RUN containers where this saves memory.
+  void run_optimize() {
+    auto optimized = basic_roaring{};
+    auto lows = std::vector<std::uint16_t>{};
+    for (auto const& c : containers_) {
+      lows.clear();
+      for_each_low(c, [&](std::uint16_t const l) { lows.push_back(l); });
+      optimized.add_array(c.key_, lows.data(), lows.size(), true);
+    }
+    *this = std::move(optimized);
+  }
+
+  // Calls `fn(x)` for all values `x` in ascending order.
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (auto const& c : containers_) {
+      auto const high = std::uint32_t{c.key_} << 16U;
+      for_each_low(c, [&](std::uint16_t const l) { fn(high | l); });
+    }
+  }
+
+  std::uint32_t front() const noexcept {
+    assert(!empty());
+    auto x = std::uint32_t{0U};
+    auto const& c = containers_.front();
+    switch (c.type_) {
+      case container_type::ARRAY:
+      case container_type::RUN: x = values_[c.offset_]; break;
+      case container_type::BITMAP: {
+        auto w = c.offset_;
+        while (bitmaps_[w] == 0U) {
+          ++w;
+        }
+        x = (w - c.offset_) * 64U + trailing_zeros(bitmaps_[w]);
+        break;
+      }
+    }
+    return (std::uint32_t{c.key_} << 16U) | x;
+  }
+
+  std::uint32_t back() const noexcept {
+    assert(!empty());
+    auto x = std::uint32_t{0U};
+    auto const& c = containers_.back();
+    auto const end = c.offset_ + c.size_;
+    switch (c.type_) {
+      case container_type::ARRAY: x = values_[end - 1U]; break;
+      case container_type::RUN:
+        x = std::uint32_t{values_[end - 2U]} + values_[end - 1U];
+        break;
+      case container_type::BITMAP: {
+        auto w = end - 1U;
+        while (bitmaps_[w] == 0U) {
+          --w;
+        }
+        x = (w - c.offset_) * 64U + 63U - leading_zeros(bitmaps_[w]);
+        break;
+      }
+    }
+    return (std::uint32_t{c.key_} << 16U) | x;
+  }
+
+  std::size_t size() const noexcept {
+    return static_cast<std::size_t>(cardinality_);
+  }
+
+  bool empty() const noexcept { return cardinality_ == 0U; }
+
+  std::size_t size_in_bytes() const noexcept {
+    return containers_.size() * sizeof(container) +
+           values_.size() * sizeof(std::uint16_t) +
+           bitmaps_.size() * sizeof(std::uint64_t);
+  }
+
+  void clear() {
+    containers_.clear();
+    values_.clear();
+    bitmaps_.clear();
+    cardinality_ = 0U;
+  }
+
+  friend basic_roaring operator&(basic_roaring const& a,
+                                 basic_roaring const& b) {
+    auto out = basic_roaring{};
+    auto lows = std::vector<std::uint16_t>{};
+    auto x = bitmap_t{};
+    auto y = bitmap_t{};
+    join(a, b, [&](container const& ca, container const& cb) {
+      if (ca.type_ == container_type::ARRAY &&
+          cb.type_ == container_type::ARRAY) {
+        lows.clear();
+        auto const va = a.values_.data() + ca.offset_;
+        auto const vb = b.values_.data() + cb.offset_;
+        std::set_intersection(va, va + ca.size_, vb, vb + cb.size_,
+                              std::back_inserter(lows));
+        out.add_array(ca.key_, lows.data(), lows.size(), false);
+      } else if (ca.type_ == container_type::ARRAY ||
+                 cb.type_ == container_type::ARRAY) {
+        auto const first_is_array = ca.type_ == container_type::ARRAY;
+        auto const& arr_set = first_is_array ? a : b;
+        auto const& arr = first_is_array ? ca : cb;
+        auto const& other_set = first_is_array ? b : a;
+        auto const& other = first_is_array ? cb : ca;
+        lows.clear();
+        arr_set.for_each_low(arr, [&](std::uint16_t const l) {
+          if (other_set.test(other, l)) {
+            lows.push_back(l);
+          }
+        });
+        out.add_array(ca.key_, lows.data(), lows.size(), false);
+      } else {
+        auto const bx = a.bitmap(ca, x);
+        auto const by = b.bitmap(cb, y);
+        if (bx != x.data()) {
+          std::copy(bx, bx + bitmap_words, x.data());
+        }
+        words_and(x.data(), by, bitmap_words);
+        out.add_bitmap(ca.key_, x.data(), words_count(x.data(), bitmap_words));
+      }
+    });
+    return out;
+  }
+
+  friend basic_roaring operator|(basic_roaring const& a,
+                                 basic_roaring const& b) {
+    auto out = basic_roaring{};
+    auto lows = std::vector<std::uint16_t>{};
+    auto x = bitmap_t{};
+    auto y = bitmap_t{};
+    merge(
+        a, b, [&](basic_roaring const& r, container const& c) {
+          lows.clear();
+          r.for_each_low(c, [&](std::uint16_t const l) { lows.push_back(l); });
+          out.add_array(c.key_, lows.data(), lows.size(), false);
+        },
+        [&](container const& ca, container const& cb) {
+          if (ca.type_ == container_type::ARRAY &&
+              cb.type_ == container_type::ARRAY) {
+            lows.clear();
+            auto const va = a.values_.data() + ca.offset_;
+            auto const vb = b.values_.data() + cb.offset_;
+            std::set_union(va, va + ca.size_, vb, vb + cb.size_,
+                           std::back_inserter(lows));
+            out.add_array(ca.key_, lows.data(), lows.size(), false);
+          } else {
+            auto const bx = a.bitmap(ca, x);
+            auto const by = b.bitmap(cb, y);
+            if (bx != x.data()) {
+              std::copy(bx, bx + bitmap_words, x.data());
+            }
+            words_or(x.data(), by, bitmap_words);
+            out.add_bitmap(ca.key_, x.data(),
+                           words_count(x.data(), bitmap_words));
+          }
+        });
+    return out;
+  }
+
+  // Cardinality of the intersection of `*this` and `o`.
+  std::size_t and_count(basic_roaring const& o) const {
+    auto count = std::size_t{0U};
+    auto x = bitmap_t{};
+    auto y = bitmap_t{};
+    join(*this, o, [&](container const& ca, container const& cb) {
+      if (ca.type_ == container_type::ARRAY ||
+          cb.type_ == container_type::ARRAY) {
+        auto const first_is_array = ca.type_ == container_type::ARRAY;
+        auto const& arr_set = first_is_array ? *this : o;
+        auto const& arr = first_is_array ? ca : cb;
+        auto const& other_set = first_is_array ? o : *this;
+        auto const& other = first_is_array ? cb : ca;
+        arr_set.for_each_low(arr, [&](std::uint16_t const l) {
+          count += other_set.test(other, l) ? 1U : 0U;
+        });
+      } else {
+        count += words_and_count(bitmap(ca, x), o.bitmap(cb, y), bitmap_words);
+      }
+    });
+    return count;
+  }
+
+  friend bool operator==(basic_roaring const& a, basic_roaring const& b) {
+    return a.size() == b.size() && a.and_count(b) == a.size();
+  }
+
+  friend bool operator!=(basic_roaring const& a, basic_roaring const& b) {
+    return !(a == b);
+  }
+
+  Vec<container> containers_;
+  Vec<std::uint16_t> values_;
+  Vec<std::uint64_t> bitmaps_;
+  std::uint64_t cardinality_{0U};
+
+private:
+  static constexpr std::uint16_t key(std::uint32_t const x) noexcept {
+    return static_cast<std::uint16_t>(x >> 16U);
+  }
+
+  static constexpr std::uint16_t low(std::uint32_t const x) noexcept {
+    return static_cast<std::uint16_t>(x & 0xFFFFU);
+  }
+
+  template <typename V>
+  static std::uint32_t pool_offset(V const& v) {
+    verify(v.size() <= std::numeric_limits<std::uint32_t>::max(),
+           "roaring: too many values");
+    return static_cast<std::uint32_t>(v.size());
+  }
+
+  static void set_bit(std::uint64_t* words, std::uint16_t const i) noexcept {
+    words[i / 64U] |= std::uint64_t{1U} << (i % 64U);
+  }
+
+  container const* find(std::uint16_t const k) const noexcept {
+    auto const it = std::lower_bound(
+        begin(containers_), end(containers_), k,
+        [](container const& c, std::uint16_t const x) { return c.key_ < x; });
+    return it == end(containers_) || it->key_ != k ? nullptr : &*it;
+  }
+
+  bool test(container const& c, std::uint16_t const l) const noexcept {
+    auto const v = values_.data() + c.offset_;
+    switch (c.type_) {
+      case container_type::ARRAY:
+        return std::binary_search(v, v + c.size_, l);
+
+      case container_type::BITMAP:
+        return ((bitmaps_[c.offset_ + l / 64U] >> (l % 64U)) & 1U) != 0U;
+
+      case container_type::RUN: {
+        // First run starting behind `l`.
+        auto lo = 0U;
+        auto hi = c.size_ / 2U;
+        while (lo != hi) {
+          auto const mid = lo + (hi - lo) / 2U;
+          if (v[2U * mid] <= l) {
+            lo = mid + 1U;
+          } else {
+            hi = mid;
+          }
+        }
+        return lo != 0U &&
+               l - v[2U * (lo - 1U)] <= v[2U * (lo - 1U) + 1U];
+      }
+    }
+    return false;
+  }
+
+  template <typename Fn>
+  void for_each_low(container const& c, Fn&& fn) const {
+    auto const v = values_.data() + c.offset_;
+    switch (c.type_) {
+      case container_type::ARRAY:
+        std::for_each(v, v + c.size_, fn);
+        break;
+
+      case container_type::BITMAP:
+        for (auto w = 0U; w != bitmap_words; ++w) {
+          for_each_set_bit_in_word(
+              bitmaps_[c.offset_ + w], w * 64U, [&](std::size_t const i) {
+                fn(static_cast<std::uint16_t>(i));
+              });
+        }
+        break;
+
+      case container_type::RUN:
+        for (auto r = 0U; r != c.size_; r += 2U) {
+          for (auto i = 0U; i <= v[r + 1U]; ++i) {
+            fn(static_cast<std::uint16_t>(v[r] + i));
+          }
+        }
+        break;
+    }
+  }
+
+  // Returns the bitmap of `c`: a pointer into `bitmaps_` for BITMAP
+  // containers, otherwise `buf` filled with the values of `c`.
+  std::uint64_t const* bitmap(container const& c, bitmap_t& buf) const {
+    if (c.type_ == container_type::BITMAP) {
+      return bitmaps_.data() + c.offset_;
+    }
+    buf.fill(0U);
+    for_each_low(c, [&](std::uint16_t const l) { set_bit(buf.data(), l); });
+    return buf.data();
+  }
+
+  // Converts the last (ARRAY) container to a BITMAP container.
+  void array_to_bitmap(container& c) {
+    assert(&c == &containers_.back());
+    auto const offset = pool_offset(bitmaps_);
+    bitmaps_.resize(offset + bitmap_words);
+    for (auto i = c.offset_; i != c.offset_ + c.size_; ++i) {
+      set_bit(bitmaps_.data() + offset, values_[i]);
+    }
+    values_.resize(c.offset_);
+    c.offset_ = offset;
+    c.size_ = bitmap_words;
+    c.type_ = container_type::BITMAP;
+  }
+
+  // Appends a container with the sorted values `v[0..n)`.
+  void add_array(std::uint16_t const k, std::uint16_t const* v,
+                 std::size_t const n, bool const allow_runs) {
+    if (n == 0U) {
+      return;
+    }
+
+    auto runs = std::size_t{1U};
+    if (allow_runs) {
+      for (auto i = std::size_t{1U}; i != n; ++i) {
+        runs += v[i] != v[i - 1U] + 1U ? 1U : 0U;
+      }
+    }
+
+    auto const array_bytes = n <= max_array_size
+                                 ? n * sizeof(std::uint16_t)
+                                 : std::numeric_limits<std::size_t>::max();
+    auto const bitmap_bytes = bitmap_words * sizeof(std::uint64_t);
+    auto const run_bytes = 2U * runs * sizeof(std::uint16_t);
+    auto const offset = pool_offset(values_);
+    if (allow_runs && run_bytes < std::min(array_bytes, bitmap_bytes)) {
+      auto c = container{offset, 0U, static_cast<std::uint32_t>(n), k,
+                         container_type::RUN};
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        if (i == 0U || v[i] != v[i - 1U] + 1U) {
+          values_.push_back(v[i]);
+          values_.push_back(std::uint16_t{0U});
+          c.size_ += 2U;
+        } else {
+          ++values_[values_.size() - 1U];
+        }
+      }
+      containers_.push_back(c);
+    } else if (n <= max_array_size) {
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        values_.push_back(v[i]);
+      }
+      containers_.push_back(container{offset,
+                                      static_cast<std::uint32_t>(n),
+                                      static_cast<std::uint32_t>(n), k,
+                                      container_type::ARRAY});
+    } else {
+      auto const b = pool_offset(bitmaps_);
+      bitmaps_.resize(b + bitmap_words);
+      for (auto i = std::size_t{0U}; i != n; ++i) {
+        set_bit(bitmaps_.data() + b, v[i]);
+      }
+      containers_.push_back(container{b, bitmap_words,
+                                      static_cast<std::uint32_t>(n), k,
+                                      container_type::BITMAP});
+    }
+    cardinality_ += n;
+  }
+
+  // Appends a container with `cardinality` bits set in `words`.
+  void add_bitmap(std::uint16_t const k, std::uint64_t const* words,
+                  std::size_t const cardinality) {
+    if (cardinality == 0U) {
+      return;
+    } else if (cardinality <= max_array_size) {
+      auto const offset = pool_offset(values_);
+      for (auto w = 0U; w != bitmap_words; ++w) {
+        for_each_set_bit_in_word(words[w], w * 64U, [&](std::size_t const i) {
+          values_.push_back(static_cast<std::uint16_t>(i));
+        });
+      }
+      containers_.push_back(container{
+          offset, static_cast<std::uint32_t>(cardinality),
+          static_cast<std::uint32_t>(cardinality), k, container_type::ARRAY});
+    } else {
+      auto const offset = pool_offset(bitmaps_);
+      bitmaps_.resize(offset + bitmap_words);
+      std::copy(words, words + bitmap_words, bitmaps_.data() + offset);
+      containers_.push_back(container{offset, bitmap_words,
+                                      static_cast<std::uint32_t>(cardinality),
+                                      k, container_type::BITMAP});
+    }
+    cardinality_ += cardinality;
+  }
+
+  // Calls `fn(ca, cb)` for all containers with the same key.
+  template <typename Fn>
+  static void join(basic_roaring const& a, basic_roaring const& b, Fn&& fn) {
+    auto i = 0U;
+    auto j = 0U;
+    while (i != a.containers_.size() && j != b.containers_.size()) {
+      auto const& ca = a.containers_[i];
+      auto const& cb = b.containers_[j];
+      if (ca.key_ < cb.key_) {
+        ++i;
+      } else if (cb.key_ < ca.key_) {
+        ++j;
+      } else {
+        fn(ca, cb);
+        ++i;
+        ++j;
+      }
+    }
+  }
+
+  // Calls `single(set, c)` for containers with a key only in one set and
+  // `both(ca, cb)` for containers with the same key, in key order.
+  template <typename Single, typename Both>
+  static void merge(basic_roaring const& a, basic_roaring const& b,
+                    Single&& single, Both&& both) {
+    auto i = 0U;
+    auto j = 0U;
+    while (i != a.containers_.size() || j != b.containers_.size()) {
+      if (j == b.containers_.size() ||
+          (i != a.containers_.size() &&
+           a.containers_[i].key_ < b.containers_[j].key_)) {
+        single(a, a.containers_[i++]);
+      } else if (i == a.containers_.size() ||
+                 b.containers_[j].key_ < a.containers_[i].key_) {
+        single(b, b.containers_[j++]);
+      } else {
+        both(a.containers_[i++], b.containers_[j++]);
+      }
+    }
+  }
+};
+
+namespace raw {
+
+using roaring = basic_roaring<vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+using roaring = basic_roaring<vector>;
+
+}  // namespace offset
+
+}  // namespace cista
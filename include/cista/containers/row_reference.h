@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cinttypes>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cista/reflection/to_tuple.h"
+
+namespace cista {
+
+namespace detail {
+
+// Member types of a reflectable struct.
+template <typename T>
+using fields_t = decltype(to_tuple(std::declval<T&>()));
+
+template <typename T, std::size_t I>
+using field_t = std::remove_reference_t<std::tuple_element_t<I, fields_t<T>>>;
+
+}  // namespace detail
+
+// Reference to element `i_` of a container that stores the members of its
+// elements in separate arrays (`split_vector`, `soa_vector`). The container
+// provides `get<I>(i)` (member), `get(i)` (gather) and `set(i, value)`.
+template <typename Container, bool Const>
+struct row_reference {
+  using container_t = std::conditional_t<Const, Container const, Container>;
+  using size_type = typename Container::size_type;
+  using value_type = typename Container::value_type;
+
+  row_reference(container_t* v, size_type const i) : v_{v}, i_{i} {}
+  row_reference(row_reference const&) = default;
+
+  template <std::size_t I>
+  decltype(auto) get() const {
+    return v_->template get<I>(i_);
+  }
+
+  operator value_type() const { return v_->get(i_); }  // NOLINT
+
+  template <bool C = Const, typename = std::enable_if_t<!C>>
+  row_reference const& operator=(value_type const& t) const {
+    v_->set(i_, t);
+    return *this;
+  }
+
+  // Copies the referenced row (does not rebind).
+  row_reference const& operator=(row_reference const& o) const {
+    static_assert(!Const, "row_reference: cannot assign to const row");
+    v_->set(i_, o);
+    return *this;
+  }
+
+  friend void swap(row_reference const& a, row_reference const& b) {
+    value_type const tmp = a;
+    a = b;
+    b = tmp;
+  }
+
+  container_t* v_;
+  size_type i_;
+};
+
+template <typename Container, bool Const>
+struct row_iterator {
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename Container::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = row_reference<Container, Const>;
+  using size_type = typename Container::size_type;
+
+  reference operator*() const { return {v_, i_}; }
+  reference operator[](difference_type const n) const {
+    return {v_, static_cast<size_type>(i_ + n)};
+  }
+
+  row_iterator& operator++() {
+    ++i_;
+    return *this;
+  }
+  row_iterator& operator--() {
+    --i_;
+    return *this;
+  }
+  row_iterator operator++(int) {
+    auto const tmp = *this;
+    ++i_;
+    return tmp;
+  }
+  row_iterator operator--(int) {
+    auto const tmp = *this;
+    --i_;
+    return tmp;
+  }
+  row_iterator& operator+=(difference_type const n) {
+    i_ = static_cast<size_type>(i_ + n);
+    return *this;
+  }
+  row_iterator& operator-=(difference_type const n) {
+    i_ = static_cast<size_type>(i_ - n);
+    return *this;
+  }
+  row_iterator operator+(difference_type const n) const {
+    return {v_, static_cast<size_type>(i_ + n)};
+  }
+  row_iterator operator-(difference_type const n) const {
+    return {v_, static_cast<size_type>(i_ - n)};
+  }
+  friend row_iterator operator+(difference_type const n,
+                                row_iterator const& it) {
+    return it + n;
+  }
+  difference_type operator-(row_iterator const& o) const {
+    return static_cast<difference_type>(i_) -
+           static_cast<difference_type>(o.i_);
+  }
+
+  friend bool operator==(row_iterator const& a, row_iterator const& b) {
+    return a.i_ == b.i_;
+  }
+  friend bool operator!=(row_iterator const& a, row_iterator const& b) {
+    return a.i_ != b.i_;
+  }
+  friend bool operator<(row_iterator const& a, row_iterator const& b) {
+    return a.i_ < b.i_;
+  }
+  friend bool operator>(row_iterator const& a, row_iterator const& b) {
+    return a.i_ > b.i_;
+  }
+  friend bool operator<=(row_iterator const& a, row_iterator const& b) {
+    return a.i_ <= b.i_;
+  }
+  friend bool operator>=(row_iterator const& a, row_iterator const& b) {
+    return a.i_ >= b.i_;
+  }
+
+  typename reference::container_t* v_;
+  size_type i_;
+};
+
+}  // namespace cista
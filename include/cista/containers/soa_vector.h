@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cinttypes>
+#include <tuple>
+#include <utility>
+
+#include "cista/containers/row_reference.h"
+#include "cista/containers/tuple.h"
+#include "cista/containers/vector.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+namespace detail {
+
+template <typename T, template <typename> typename Vec, typename Seq>
+struct soa_columns;
+
+template <typename T, template <typename> typename Vec, std::size_t... I>
+struct soa_columns<T, Vec, std::index_sequence<I...>> {
+  using type = tuple<Vec<field_t<T, I>>...>;
+};
+
+}  // namespace detail
+
+// Struct-of-arrays vector of reflectable structs `T`: member `I` of all
+// elements is stored in the contiguous vector `column<I>()`.
+//
+//   struct pos { float lat_, lng_; std::uint32_t id_; };
+//   auto v = data::soa_vector<pos>{};
+//   v.push_back(pos{...});
+//   float const* lat = v.column<0U>().data();  // scan (SIMD) a single member
+//   v[i].get<2U>();                            // id_ of element i
+//   pos p = v[i];                              // gathers all members
+template <typename T, template <typename> typename Vec>
+struct basic_soa_vector {
+  static constexpr auto const NUM_FIELDS =
+      std::tuple_size_v<detail::fields_t<T>>;
+
+  static_assert(NUM_FIELDS != 0U, "soa_vector: no members");
+
+  using columns_t = typename detail::soa_columns<
+      T, Vec, std::make_index_sequence<NUM_FIELDS>>::type;
+  using size_type = typename Vec<detail::field_t<T, 0U>>::size_type;
+  using value_type = T;
+
+  using reference = row_reference<basic_soa_vector, false>;
+  using const_reference = row_reference<basic_soa_vector, true>;
+  using iterator = row_iterator<basic_soa_vector, false>;
+  using const_iterator = row_iterator<basic_soa_vector, true>;
+
+  template <std::size_t I>
+  auto& column() noexcept {
+    return cista::get<I>(columns_);
+  }
+
+  template <std::size_t I>
+  auto const& column() const noexcept {
+    return cista::get<I>(columns_);
+  }
+
+  // Member `I` of element `i`.
+  template <std::size_t I>
+  auto& get(size_type const i) {
+    return column<I>()[i];
+  }
+
+  template <std::size_t I>
+  auto const& get(size_type const i) const {
+    return column<I>()[i];
+  }
+
+  // Gathers all members of element `i`.
+  T get(size_type const i) const {
+    auto t = T{};
+    auto fields = to_tuple(t);
+    for_each_column([&](auto const idx) {
+      std::get<decltype(idx)::value>(fields) = get<decltype(idx)::value>(i);
+    });
+    return t;
+  }
+
+  void set(size_type const i, T const& t) {
+    auto const fields = to_tuple(t);
+    for_each_column([&](auto const idx) {
+      get<decltype(idx)::value>(i) = std::get<decltype(idx)::value>(fields);
+    });
+  }
+
+  void push_back(T const& t) {
+    auto const fields = to_tuple(t);
+    for_each_column([&](auto const idx) {
+      column<decltype(idx)::value>().push_back(
+          std::get<decltype(idx)::value>(fields));
+    });
+  }
+
+  void reserve(size_type const n) {
+    for_each_column(
+        [&](auto const idx) { column<decltype(idx)::value>().reserve(n); });
+  }
+
+  void resize(size_type const n) {
+    for_each_column(
+        [&](auto const idx) { column<decltype(idx)::value>().resize(n); });
+  }
+
+  void pop_back() {
+    for_each_column(
+        [&](auto const idx) { column<decltype(idx)::value>().pop_back(); });
+  }
+
+  void clear() {
+    for_each_column(
+        [&](auto const idx) { column<decltype(idx)::value>().clear(); });
+  }
+
+  reference operator[](size_type const i) { return {this, i}; }
+  const_reference operator[](size_type const i) const { return {this, i}; }
+
+  reference at(size_type const i) {
+    verify(i < size(), "soa_vector::at: index out of range");
+    return {this, i};
+  }
+
+  const_reference at(size_type const i) const {
+    verify(i < size(), "soa_vector::at: index out of range");
+    return {this, i};
+  }
+
+  reference front() { return {this, 0U}; }
+  reference back() { return {this, static_cast<size_type>(size() - 1U)}; }
+
+  iterator begin() { return {this, 0U}; }
+  iterator end() { return {this, size()}; }
+  const_iterator begin() const { return {this, 0U}; }
+  const_iterator end() const { return {this, size()}; }
+
+  friend iterator begin(basic_soa_vector& v) { return v.begin(); }
+  friend iterator end(basic_soa_vector& v) { return v.end(); }
+  friend const_iterator begin(basic_soa_vector const& v) { return v.begin(); }
+  friend const_iterator end(basic_soa_vector const& v) { return v.end(); }
+
+  size_type size() const noexcept { return column<0U>().size(); }
+  bool empty() const noexcept { return column<0U>().empty(); }
+
+  template <typename Fn>
+  static void for_each_column(Fn&& fn) {
+    for_each_column(std::forward<Fn>(fn),
+                    std::make_index_sequence<NUM_FIELDS>());
+  }
+
+  template <typename Fn, std::size_t... I>
+  static void for_each_column(Fn&& fn, std::index_sequence<I...>) {
+    (fn(std::integral_constant<std::size_t, I>{}), ...);
+  }
+
+  columns_t columns_;
+};
+
+namespace raw {
+
+template <typename T>
+using soa_vector = basic_soa_vector<T, vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename T>
+using soa_vector = basic_soa_vector<T, vector>;
+
+}  // namespace offset
+
+}  // namespace cista
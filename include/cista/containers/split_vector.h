@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cista/containers/row_reference.h"
+#include "cista/containers/tuple.h"
+#include "cista/containers/vector.h"
+#include "cista/reflection/to_tuple.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+namespace detail {
+
+template <std::size_t N, std::size_t... Hot>
+constexpr std::array<std::size_t, N - sizeof...(Hot)> cold_fields() {
+  auto cold = std::array<std::size_t, N - sizeof...(Hot)>{};
+  auto j = std::size_t{0U};
+  for (auto i = std::size_t{0U}; i != N; ++i) {
+    if (((i != Hot) && ...)) {
+      cold[j++] = i;
+    }
+  }
+  return cold;
+}
+
+template <std::size_t N>
+constexpr std::size_t position(std::array<std::size_t, N> const& a,
+                               std::size_t const x) {
+  for (auto i = std::size_t{0U}; i != N; ++i) {
+    if (a[i] == x) {
+      return i;
+    }
+  }
+  return N;
+}
+
+template <typename T, typename ColdSeq, std::size_t... Hot>
+struct split_fields;
+
+template <typename T, std::size_t... J, std::size_t... Hot>
+struct split_fields<T, std::index_sequence<J...>, Hot...> {
+  static constexpr auto const N = std::tuple_size_v<fields_t<T>>;
+  static constexpr auto const HOT = std::array<std::size_t, sizeof...(Hot)>{
+      Hot...};
+  static constexpr auto const COLD = cold_fields<N, Hot...>();
+
+  using hot_t = tuple<field_t<T, Hot>...>;
+  using cold_t = tuple<field_t<T, COLD[J]>...>;
+};
+
+}  // namespace detail
+
+// Vector of reflectable structs `T` with hot/cold splitting: the members
+// with the indices `HotFields...` are stored contiguously (one `tuple` per
+// element in `hot_`), all other members in the parallel vector `cold_`.
+// Scans over hot members only touch `hot_`.
+//
+//   struct trip { std::uint32_t id_; data::string name_; std::uint16_t t_; };
+//   auto v = data::split_vector<trip, 0U, 2U>{};  // id_ and t_ are hot
+//   v.push_back(trip{...});
+//   v[i].get<0U>();  // id_ (from `hot_`)
+//   trip t = v[i];   // gathers all members
+template <typename T, template <typename> typename Vec,
+          std::size_t... HotFields>
+struct basic_split_vector {
+  static constexpr auto const NUM_FIELDS =
+      std::tuple_size_v<detail::fields_t<T>>;
+
+  static_assert(sizeof...(HotFields) != 0U, "split_vector: no hot fields");
+  static_assert(sizeof...(HotFields) < NUM_FIELDS,
+                "split_vector: no cold fields");
+  static_assert(((HotFields < NUM_FIELDS) && ...),
+                "split_vector: field index out of range");
+
+  using split_t = detail::split_fields<
+      T, std::make_index_sequence<NUM_FIELDS - sizeof...(HotFields)>,
+      HotFields...>;
+  using hot_t = typename split_t::hot_t;
+  using cold_t = typename split_t::cold_t;
+  using hot_vec_t = Vec<hot_t>;
+  using cold_vec_t = Vec<cold_t>;
+  using size_type = typename hot_vec_t::size_type;
+  using value_type = T;
+
+  template <std::size_t I>
+  static constexpr bool is_hot() noexcept {
+    return ((I == HotFields) || ...);
+  }
+
+  using reference = row_reference<basic_split_vector, false>;
+  using const_reference = row_reference<basic_split_vector, true>;
+  using iterator = row_iterator<basic_split_vector, false>;
+  using const_iterator = row_iterator<basic_split_vector, true>;
+
+  // Member `I` of element `i`.
+  template <std::size_t I>
+  auto& get(size_type const i) {
+    if constexpr (is_hot<I>()) {
+      return cista::get<detail::position(split_t::HOT, I)>(hot_[i]);
+    } else {
+      return cista::get<detail::position(split_t::COLD, I)>(cold_[i]);
+    }
+  }
+
+  template <std::size_t I>
+  auto const& get(size_type const i) const {
+    if constexpr (is_hot<I>()) {
+      return cista::get<detail::position(split_t::HOT, I)>(hot_[i]);
+    } else {
+      return cista::get<detail::position(split_t::COLD, I)>(cold_[i]);
+    }
+  }
+
+  // Gathers all members of element `i`.
+  T get(size_type const i) const {
+    auto t = T{};
+    auto fields = to_tuple(t);
+    copy_fields(fields, i, std::make_index_sequence<NUM_FIELDS>());
+    return t;
+  }
+
+  void set(size_type const i, T const& t) {
+    auto const fields = to_tuple(t);
+    assign_fields(fields, i, std::make_index_sequence<NUM_FIELDS>());
+  }
+
+  void push_back(T const& t) {
+    hot_.emplace_back();
+    cold_.emplace_back();
+    set(size() - 1U, t);
+  }
+
+  void reserve(size_type const n) {
+    hot_.reserve(n);
+    cold_.reserve(n);
+  }
+
+  void resize(size_type const n) {
+    hot_.resize(n);
+    cold_.resize(n);
+  }
+
+  void pop_back() {
+    hot_.pop_back();
+    cold_.pop_back();
+  }
+
+  void clear() {
+    hot_.clear();
+    cold_.clear();
+  }
+
+  reference operator[](size_type const i) { return {this, i}; }
+  const_reference operator[](size_type const i) const { return {this, i}; }
+
+  reference at(size_type const i) {
+    verify(i < size(), "split_vector::at: index out of range");
+    return {this, i};
+  }
+
+  const_reference at(size_type const i) const {
+    verify(i < size(), "split_vector::at: index out of range");
+    return {this, i};
+  }
+
+  reference front() { return {this, 0U}; }
+  reference back() { return {this, static_cast<size_type>(size() - 1U)}; }
+
+  iterator begin() { return {this, 0U}; }
+  iterator end() { return {this, size()}; }
+  const_iterator begin() const { return {this, 0U}; }
+  const_iterator end() const { return {this, size()}; }
+
+  friend iterator begin(basic_split_vector& v) { return v.begin(); }
+  friend iterator end(basic_split_vector& v) { return v.end(); }
+  friend const_iterator begin(basic_split_vector const& v) {
+    return v.begin();
+  }
+  friend const_iterator end(basic_split_vector const& v) { return v.end(); }
+
+  size_type size() const noexcept { return hot_.size(); }
+  bool empty() const noexcept { return hot_.empty(); }
+
+  hot_vec_t hot_;
+  cold_vec_t cold_;
+
+private:
+  template <typename Fields, std::size_t... I>
+  void copy_fields(Fields& fields, size_type const i,
+                   std::index_sequence<I...>) const {
+    ((std::get<I>(fields) = get<I>(i)), ...);
+  }
+
+  template <typename Fields, std::size_t... I>
+  void assign_fields(Fields const& fields, size_type const i,
+                     std::index_sequence<I...>) {
+    ((get<I>(i) = std::get<I>(fields)), ...);
+  }
+};
+
+namespace raw {
+
+template <typename T, std::size_t... HotFields>
+using split_vector = basic_split_vector<T, vector, HotFields...>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename T, std::size_t... HotFields>
+using split_vector = basic_split_vector<T, vector, HotFields...>;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <iterator>
+#include <limits>
+
+#include "cista/bit_counting.h"
+#include "cista/containers/vector.h"
+#include "cista/unused_param.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Read-only sorted sequence stored in Eytzinger (BFS) order: the children
+// of node `k` (1-based) are `2k` and `2k + 1`. The first levels of the
+// implicit search tree share a few cache lines and the descendants four
+// levels below a node (for 4 byte values) are adjacent, so a search
+// prefetches them four levels ahead and overlaps its cache misses, unlike
+// binary search where each step waits for the previous miss.
+//
+// Queries answer with the rank (= index in the sorted input) stored next
+// to the keys in `ranks_`, so results can be used to access data stored
+// in input order.
+//
+//   auto s = data::static_search_vector<std::uint32_t>{};
+//   s.build(begin(sorted), end(sorted));
+//   s.lower_bound(x);  // == std::lower_bound(sorted, x) - begin(sorted)
+//
+// Khuong, Morin - "Array Layouts for Comparison-Based Searching" (2017)
+template <typename T, template <typename> typename Vec>
+struct basic_static_search_vector {
+  using value_type = T;
+  using size_type = std::uint32_t;
+
+  // Nodes `k * prefetch_step + [0, prefetch_step)` are the descendants of
+  // `k` that fit into one cache line.
+  static constexpr size_type const prefetch_step =
+      sizeof(T) >= 32U ? 2U
+      : sizeof(T) >= 16U ? 4U
+      : sizeof(T) >= 8U  ? 8U
+                         : 16U;
+
+  // Number of queries `lower_bound_many` searches interleaved.
+  static constexpr auto const batch_size = 16U;
+
+  // Replaces the contents with the values in [first, last), which have to
+  // be sorted (duplicates are allowed).
+  template <typename It>
+  void build(It first, It last) {
+    clear();
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    verify(n < std::numeric_limits<size_type>::max(),
+           "static_search_vector: too many values");
+    layout_.resize(static_cast<size_type>(n));
+    ranks_.resize(static_cast<size_type>(n));
+
+    auto rank = size_type{0U};
+    auto prev = static_cast<T const*>(nullptr);
+    fill(first, 1U, rank, prev);
+  }
+
+  // Rank of the first value that is not less than `x`, size() if none.
+  template <typename Key>
+  size_type lower_bound(Key const& x) const {
+    return node_rank(lower_bound_node(x));
+  }
+
+  // Writes `lower_bound(*it)` for every query in [first, last) to `out`.
+  // Searches `batch_size` queries level by level to overlap their memory
+  // accesses.
+  template <typename It, typename Out>
+  Out lower_bound_many(It first, It last, Out out) const {
+    auto const n = size();
+    auto const values = layout_.data();
+    auto const levels = 64U - leading_zeros(std::uint64_t{n});
+    std::uint64_t k[batch_size];
+    while (first != last) {
+      auto queries = first;
+      auto count = 0U;
+      for (; count != batch_size && first != last; ++count, ++first) {
+        k[count] = 1U;
+      }
+      for (auto level = 0U; level != levels; ++level) {
+        auto q = queries;
+        for (auto i = 0U; i != count; ++i, ++q) {
+          if (k[i] <= n) {
+            prefetch(values, n, k[i]);
+            k[i] = 2U * k[i] + (values[k[i] - 1U] < *q ? 1U : 0U);
+          }
+        }
+      }
+      for (auto i = 0U; i != count; ++i, ++out) {
+        *out = node_rank(result_node(k[i]));
+      }
+    }
+    return out;
+  }
+
+  template <typename Key>
+  bool contains(Key const& x) const {
+    auto const k = lower_bound_node(x);
+    return k != 0U && !(x < layout_[static_cast<size_type>(k - 1U)]);
+  }
+
+  size_type size() const noexcept {
+    return static_cast<size_type>(layout_.size());
+  }
+
+  bool empty() const noexcept { return layout_.empty(); }
+
+  std::size_t size_in_bytes() const noexcept {
+    return layout_.size() * sizeof(T) + ranks_.size() * sizeof(size_type);
+  }
+
+  void clear() {
+    layout_.clear();
+    ranks_.clear();
+  }
+
+  Vec<T> layout_;  // values in Eytzinger order (node k at index k - 1)
+  Vec<size_type> ranks_;  // rank of the value at the same index
+
+private:
+  // In-order traversal of the implicit tree assigns the sorted values.
+  template <typename It>
+  void fill(It& it, std::uint64_t const k, size_type& rank, T const*& prev) {
+    if (k > size()) {
+      return;
+    }
+    fill(it, 2U * k, rank, prev);
+    auto const i = static_cast<size_type>(k - 1U);
+    layout_[i] = *it;
+    ranks_[i] = rank++;
+    verify(prev == nullptr || !(layout_[i] < *prev),
+           "static_search_vector: input not sorted");
+    prev = &layout_[i];
+    ++it;
+    fill(it, 2U * k + 1U, rank, prev);
+  }
+
+  // Node of the first value not less than `x`, 0 if none.
+  template <typename Key>
+  std::uint64_t lower_bound_node(Key const& x) const {
+    auto const n = size();
+    auto const values = layout_.data();
+    auto k = std::uint64_t{1U};
+    while (k <= n) {
+      prefetch(values, n, k);
+      k = 2U * k + (values[k - 1U] < x ? 1U : 0U);
+    }
+    return result_node(k);
+  }
+
+  // `k` encodes the search path (1 = right). The result is the last node
+  // where the search went left: strip the trailing right turns and the
+  // left turn. 0 if the search never went left.
+  static std::uint64_t result_node(std::uint64_t const k) noexcept {
+    return k >> (trailing_zeros(~k) + 1U);
+  }
+
+  size_type node_rank(std::uint64_t const node) const {
+    return node == 0U ? size() : ranks_[static_cast<size_type>(node - 1U)];
+  }
+
+  static void prefetch(T const* values, std::uint64_t const n,
+                       std::uint64_t const k) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(values + std::min(k * prefetch_step, n) - 1U);
+#else
+    CISTA_UNUSED_PARAM(values)
+    CISTA_UNUSED_PARAM(n)
+    CISTA_UNUSED_PARAM(k)
+#endif
+  }
+};
+
+namespace raw {
+
+template <typename T>
+using static_search_vector = basic_static_search_vector<T, vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+template <typename T>
+using static_search_vector = basic_static_search_vector<T, vector>;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -7,6 +7,7 @@
 #include <string>
 #include <string_view>
 
+#include "cista/arena.h"
 #include "cista/containers/ptr.h"
 #include "cista/exception.h"
 #include "cista/type_traits.h"
@@ -59,7 +60,7 @@ struct generic_string {
 
   void reset() noexcept {
     if (!h_.is_short_ && h_.ptr_ != nullptr && h_.self_allocated_) {
-      std::free(data());
+      container_free<Ptr>(data());
     }
     h_ = heap{};
   }
@@ -88,7 +89,7 @@ struct generic_string {
         s_.s_[i] = 0;
       }
     } else {
-      h_.ptr_ = static_cast<char*>(std::malloc(len));
+      h_.ptr_ = static_cast<char*>(container_malloc<Ptr>(len));
       if (h_.ptr_ == nullptr) {
         throw_exception(std::bad_alloc{});
       }
@@ -444,6 +445,12 @@ using string = basic_string<ptr<char const>>;
 using string_view = basic_string_view<ptr<char const>>;
 }  // namespace offset
 
+namespace offset32 {
+using generic_string = generic_string<ptr<char const>>;
+using string = basic_string<ptr<char const>>;
+using string_view = basic_string_view<ptr<char const>>;
+}  // namespace offset32
+
 }  // namespace cista
 
 #if __has_include("fmt/ostream.h")
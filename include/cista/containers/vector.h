@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "cista/allocator.h"
+#include "cista/arena.h"
 #include "cista/containers/ptr.h"
 #include "cista/exception.h"
 #include "cista/is_iterable.h"
@@ -101,7 +102,7 @@ struct basic_vector {
       el.~T();
     }
 
-    std::free(el_);  // NOLINT
+    container_free<Ptr<T>>(el_);
     reset();
   }
 
@@ -315,7 +316,7 @@ struct basic_vector {
 
     auto next_size = next_power_of_two(new_size);
     auto num_bytes = static_cast<std::size_t>(next_size) * sizeof(T);
-    auto mem_buf = static_cast<T*>(std::malloc(num_bytes));  // NOLINT
+    auto mem_buf = static_cast<T*>(container_malloc<Ptr<T>>(num_bytes));
     if (mem_buf == nullptr) {
       throw_exception(std::bad_alloc());
     }
@@ -335,10 +336,10 @@ struct basic_vector {
       }
     }
 
-    auto free_me = el_;
+    T* free_me = el_;
     el_ = mem_buf;
     if (self_allocated_) {
-      std::free(free_me);  // NOLINT
+      container_free<Ptr<T>>(free_me);
     }
 
     self_allocated_ = true;
@@ -553,6 +554,19 @@ auto to_indexed_vec(Container const& c)
 
 }  // namespace offset
 
+namespace offset32 {
+
+template <typename T>
+using vector = basic_vector<T, ptr>;
+
+template <typename T>
+using indexed_vector = basic_vector<T, ptr, true>;
+
+template <typename Key, typename Value>
+using vector_map = basic_vector<Value, ptr, false, Key>;
+
+}  // namespace offset32
+
 #undef CISTA_TO_VEC
 
 }  // namespace cista
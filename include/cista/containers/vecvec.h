@@ -50,6 +50,8 @@ struct basic_vecvec {
 
     bool empty() const { return begin() == end(); }
 
+    // O(size of all following buckets): use `vecvec_builder` to fill
+    // buckets in arbitrary order.
     template <typename Args>
     void push_back(Args&& args) {
       map_->data_.insert(std::next(std::begin(map_->data_), bucket_end_idx()),
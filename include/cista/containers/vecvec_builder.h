@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cinttypes>
+#include <utility>
+#include <vector>
+
+#include "cista/containers/vecvec.h"
+#include "cista/strong.h"
+#include "cista/verify.h"
+
+namespace cista {
+
+// Collects appends to the buckets of a `basic_vecvec` in any order in
+// amortized O(1) and builds the compact `basic_vecvec` layout in one
+// linear pass (stable counting sort by bucket): values of a bucket keep
+// the order in which they were added.
+//
+//   auto b = data::vecvec_builder<key, V>{};
+//   b.push_back(key{7}, v1);
+//   b.push_back(key{2}, v2);
+//   b.push_back(key{7}, v3);
+//   data::vecvec<key, V> vv = b.build();  // vv[key{7}] == {v1, v3}
+template <typename Key, typename DataVec, typename IndexVec>
+struct basic_vecvec_builder {
+  using vecvec_t = basic_vecvec<Key, DataVec, IndexVec>;
+  using data_value_type = typename DataVec::value_type;
+  using index_value_type = typename IndexVec::value_type;
+
+  void push_back(Key const k, data_value_type const& x) {
+    add_key(k);
+    values_.push_back(x);
+  }
+
+  void push_back(Key const k, data_value_type&& x) {
+    add_key(k);
+    values_.push_back(std::move(x));
+  }
+
+  template <typename... Args>
+  data_value_type& emplace_back(Key const k, Args&&... args) {
+    add_key(k);
+    return values_.emplace_back(std::forward<Args>(args)...);
+  }
+
+  // Sets the number of buckets (to get empty buckets at the end).
+  void resize(std::size_t const num_buckets) {
+    verify(num_buckets >= sizes_.size(),
+           "vecvec_builder::resize: buckets not empty");
+    sizes_.resize(num_buckets, index_value_type{0U});
+  }
+
+  void reserve(std::size_t const num_values) {
+    keys_.reserve(num_values);
+    values_.reserve(num_values);
+  }
+
+  std::size_t size() const noexcept { return sizes_.size(); }
+  std::size_t data_size() const noexcept { return values_.size(); }
+
+  index_value_type bucket_size(Key const k) const {
+    return to_idx(k) < sizes_.size() ? sizes_[to_idx(k)]
+                                     : index_value_type{0U};
+  }
+
+  // Moves all values to a new `basic_vecvec` and clears the builder.
+  vecvec_t build() {
+    auto v = vecvec_t{};
+    if (sizes_.empty()) {
+      return v;
+    }
+
+    v.bucket_starts_.reserve(
+        static_cast<typename IndexVec::size_type>(sizes_.size() + 1U));
+
+    // Bucket sizes -> bucket starts. `sizes_[i]` becomes the write position.
+    auto start = index_value_type{0U};
+    v.bucket_starts_.emplace_back(start);
+    for (auto& s : sizes_) {
+      auto const size = s;
+      s = start;
+      start = static_cast<index_value_type>(start + size);
+      v.bucket_starts_.emplace_back(start);
+    }
+
+    v.data_.resize(static_cast<typename DataVec::size_type>(values_.size()));
+    for (auto i = std::size_t{0U}; i != values_.size(); ++i) {
+      v.data_[sizes_[keys_[i]]++] = std::move(values_[i]);
+    }
+
+    clear();
+    return v;
+  }
+
+  void clear() {
+    keys_.clear();
+    values_.clear();
+    sizes_.clear();
+  }
+
+private:
+  void add_key(Key const k) {
+    auto const i = static_cast<std::size_t>(to_idx(k));
+    if (i >= sizes_.size()) {
+      sizes_.resize(i + 1U, index_value_type{0U});
+    }
+    ++sizes_[i];
+    keys_.push_back(static_cast<index_value_type>(i));
+  }
+
+  std::vector<index_value_type> keys_;
+  std::vector<data_value_type> values_;
+  std::vector<index_value_type> sizes_;
+};
+
+namespace offset {
+
+template <typename K, typename V, typename SizeType = base_t<K>>
+using vecvec_builder = basic_vecvec_builder<K, vector<V>, vector<SizeType>>;
+
+}  // namespace offset
+
+namespace raw {
+
+template <typename K, typename V, typename SizeType = base_t<K>>
+using vecvec_builder = basic_vecvec_builder<K, vector<V>, vector<SizeType>>;
+
+}  // namespace raw
+
+}  // namespace cista
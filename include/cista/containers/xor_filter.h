@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cinttypes>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "cista/containers/vector.h"
+#include "cista/exception.h"
+#include "cista/hash.h"
+
+namespace cista {
+
+// Static xor filter with 8 bit fingerprints over 64 bit key hashes: a key
+// is (probably) contained if the xor of its three table entries (one in
+// each third of the table) equals its fingerprint. Uses ~9.9 bits per key
+// with ~0.4% false positives; a lookup reads three bytes.
+//
+// A default constructed (not built) filter answers `contains` with true.
+//
+// Graf, Lemire - "Xor Filters: Faster and Smaller Than Bloom and Cuckoo
+// Filters": https://arxiv.org/abs/1912.08258
+template <template <typename> typename Vec>
+struct basic_xor_filter {
+  static constexpr auto const MAX_SEED_ATTEMPTS = 64U;
+
+  // Replaces the contents with the keys in [first, last) (`get_hash(*it)`).
+  // Throws `std::runtime_error` if no seed works (practically impossible).
+  template <typename It, typename GetHash>
+  void build(It first, It last, GetHash&& get_hash) {
+    auto hashes = std::vector<hash_t>{};
+    hashes.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    for (auto it = first; it != last; ++it) {
+      hashes.push_back(get_hash(*it));
+    }
+    std::sort(begin(hashes), end(hashes));
+    hashes.erase(std::unique(begin(hashes), end(hashes)), end(hashes));
+    if (hashes.size() > std::numeric_limits<std::uint32_t>::max() / 2U) {
+      throw_exception(std::length_error{"xor_filter: too many keys"});
+    }
+
+    block_length_ =
+        static_cast<std::uint32_t>((32U + hashes.size() * 123U / 100U) / 3U);
+    for (auto attempt = 0U; attempt != MAX_SEED_ATTEMPTS; ++attempt) {
+      seed_ = hash_mix(BASE_HASH + attempt);
+      if (try_build(hashes)) {
+        return;
+      }
+    }
+    clear();
+    throw_exception(std::runtime_error{"xor_filter: build failed"});
+  }
+
+  bool contains(hash_t const h) const noexcept {
+    if (fingerprints_.empty()) {
+      return true;
+    }
+    auto const x = mix(h);
+    return fingerprint(x) == (fingerprints_[position(x, 0U)] ^
+                              fingerprints_[position(x, 1U)] ^
+                              fingerprints_[position(x, 2U)]);
+  }
+
+  std::size_t size_in_bytes() const noexcept { return fingerprints_.size(); }
+
+  void clear() {
+    fingerprints_.clear();
+    block_length_ = 0U;
+    seed_ = 0U;
+  }
+
+  Vec<std::uint8_t> fingerprints_;
+  std::uint32_t block_length_{0U};
+  hash_t seed_{0U};
+
+private:
+  std::uint64_t mix(hash_t const h) const noexcept {
+    return hash_mix(h ^ seed_);
+  }
+
+  static constexpr std::uint8_t fingerprint(std::uint64_t const x) noexcept {
+    return static_cast<std::uint8_t>(x ^ (x >> 32U));
+  }
+
+  // Position in the `i`-th third of the table.
+  std::uint32_t position(std::uint64_t const x,
+                         unsigned const i) const noexcept {
+    auto const r = i == 0U ? x : (x << (21U * i)) | (x >> (64U - 21U * i));
+    return static_cast<std::uint32_t>(((r >> 32U) * block_length_) >> 32U) +
+           i * block_length_;
+  }
+
+  bool try_build(std::vector<hash_t> const& hashes) {
+    struct peeled {
+      std::uint64_t x_;
+      std::uint32_t pos_;
+    };
+
+    // Per slot: xor of the mixed hashes and count of keys mapped to it.
+    auto const size = std::size_t{3U} * block_length_;
+    auto masks = std::vector<std::uint64_t>(size, 0U);
+    auto counts = std::vector<std::uint32_t>(size, 0U);
+    for (auto const h : hashes) {
+      auto const x = mix(h);
+      for (auto i = 0U; i != 3U; ++i) {
+        masks[position(x, i)] ^= x;
+        ++counts[position(x, i)];
+      }
+    }
+
+    // Peel keys that are alone in a slot.
+    auto queue = std::vector<std::uint32_t>{};
+    for (auto i = 0U; i != size; ++i) {
+      if (counts[i] == 1U) {
+        queue.push_back(i);
+      }
+    }
+    auto stack = std::vector<peeled>{};
+    stack.reserve(hashes.size());
+    while (!queue.empty()) {
+      auto const slot = queue.back();
+      queue.pop_back();
+      if (counts[slot] != 1U) {
+        continue;
+      }
+      auto const x = masks[slot];
+      stack.push_back({x, slot});
+      for (auto i = 0U; i != 3U; ++i) {
+        auto const p = position(x, i);
+        masks[p] ^= x;
+        if (--counts[p] == 1U) {
+          queue.push_back(p);
+        }
+      }
+    }
+    if (stack.size() != hashes.size()) {
+      return false;
+    }
+
+    // Assign in reverse peeling order: the slot of each key is the only
+    // one of its three slots not used by keys assigned before.
+    fingerprints_.clear();
+    fingerprints_.resize(
+        static_cast<typename Vec<std::uint8_t>::size_type>(size));
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+      fingerprints_[it->pos_] = static_cast<std::uint8_t>(
+          fingerprint(it->x_) ^ fingerprints_[position(it->x_, 0U)] ^
+          fingerprints_[position(it->x_, 1U)] ^
+          fingerprints_[position(it->x_, 2U)]);
+    }
+    return true;
+  }
+};
+
+namespace raw {
+
+using xor_filter = basic_xor_filter<vector>;
+
+}  // namespace raw
+
+namespace offset {
+
+using xor_filter = basic_xor_filter<vector>;
+
+}  // namespace offset
+
+}  // namespace cista
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <type_traits>
 
 #include "cista/containers/pair.h"
 #include "cista/decay.h"
+#include "cista/is_bytewise_comparable.h"
 #include "cista/is_iterable.h"
 #include "cista/reflection/to_tuple.h"
 
@@ -20,6 +22,17 @@ constexpr bool tuple_equal_impl(F&& is_equal, Tuple&& a, Tuple&& b,
           ...);
 }
 
+template <typename A, typename B, typename = void>
+struct is_same_bytewise_range : std::false_type {};
+
+template <typename A, typename B>
+struct is_same_bytewise_range<
+    A, B,
+    std::enable_if_t<is_contiguous_bytewise_range_v<A> &&
+                     is_contiguous_bytewise_range_v<B>>>
+    : std::is_same<decay_t<decltype(*std::declval<A const&>().data())>,
+                   decay_t<decltype(*std::declval<B const&>().data())>> {};
+
 }  // namespace detail
 
 template <class F, class Tuple>
@@ -50,7 +63,15 @@ struct equal_to {
   constexpr bool operator()(T const& a, T1 const& b) const {
     using Type = decay_t<T>;
     using Type1 = decay_t<T1>;
-    if constexpr (is_iterable_v<Type> && is_iterable_v<Type1>) {
+    if constexpr (std::is_same_v<Type, Type1> && !std::is_scalar_v<Type> &&
+                  is_bytewise_comparable_v<Type>) {
+      return std::memcmp(&a, &b, sizeof(Type)) == 0;
+    } else if constexpr (detail::is_same_bytewise_range<Type, Type1>::value) {
+      return a.size() == b.size() &&
+             (a.size() == 0U ||
+              std::memcmp(a.data(), b.data(),
+                          a.size() * sizeof(*a.data())) == 0);
+    } else if constexpr (is_iterable_v<Type> && is_iterable_v<Type1>) {
       using std::begin;
       using std::end;
       auto const eq = std::equal(
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cinttypes>
+#include <cstring>
 #include <string_view>
 
+#include "cista/rapidhash.h"
+
 namespace cista {
 
 #if defined(CISTA_XXH3)
@@ -26,6 +29,11 @@ inline hash_t hash(std::string_view s, hash_t h = BASE_HASH) {
   return XXH3_64bits_withSeed(s.data(), s.size(), h);
 }
 
+inline hash_t hash_bytes(void const* data, std::size_t const size,
+                         hash_t const h = BASE_HASH) noexcept {
+  return XXH3_64bits_withSeed(data, size, h);
+}
+
 template <std::size_t N>
 constexpr hash_t hash(const char (&str)[N], hash_t const h = BASE_HASH) {
   return XXH3_64bits_withSeed(str, N - 1, h);
@@ -57,6 +65,11 @@ inline hash_t hash(std::string_view s, hash_t h = BASE_HASH) {
   return wyhash::wyhash(s.data(), s.size(), h, wyhash::_wyp);
 }
 
+inline hash_t hash_bytes(void const* data, std::size_t const size,
+                         hash_t const h = BASE_HASH) noexcept {
+  return wyhash::wyhash(data, size, h, wyhash::_wyp);
+}
+
 template <std::size_t N>
 constexpr hash_t hash(const char (&str)[N],
                       hash_t const h = BASE_HASH) noexcept {
@@ -91,6 +104,11 @@ inline hash_t hash(std::string_view s, hash_t h = BASE_HASH) {
   return wyhash::FastestHash(s.data(), s.size(), h);
 }
 
+inline hash_t hash_bytes(void const* data, std::size_t const size,
+                         hash_t const h = BASE_HASH) noexcept {
+  return wyhash::FastestHash(data, size, h);
+}
+
 template <std::size_t N>
 constexpr hash_t hash(const char (&str)[N],
                       hash_t const h = BASE_HASH) noexcept {
@@ -103,6 +121,49 @@ constexpr std::uint64_t hash(T const& buf,
   return buf.size() == 0U ? h : wyhash::FastestHash(&buf[0U], buf.size(), h);
 }
 
+#elif defined(CISTA_RAPIDHASH)
+
+// constexpr: usable for `static_type_hash` and compile time keys as well as
+// for runtime hashing.
+
+using hash_t = std::uint64_t;
+
+constexpr auto const BASE_HASH = rapidhash_detail::SEED;
+
+template <typename... Args>
+constexpr hash_t hash_combine(hash_t h, Args... val) noexcept {
+  auto rh = [&](auto arg) noexcept {
+    h = rapidhash_u64(h, static_cast<hash_t>(arg));
+  };
+  ((rh(val)), ...);
+  return h;
+}
+
+constexpr hash_t hash(std::string_view s,
+                      hash_t const h = BASE_HASH) noexcept {
+  return rapidhash(s.data(), s.size(), h);
+}
+
+template <std::size_t N>
+constexpr hash_t hash(const char (&str)[N],
+                      hash_t const h = BASE_HASH) noexcept {
+  return rapidhash(str, N - 1U, h);
+}
+
+inline hash_t hash_bytes(void const* data, std::size_t const size,
+                         hash_t const h = BASE_HASH) noexcept {
+  return rapidhash(static_cast<std::uint8_t const*>(data), size, h);
+}
+
+template <typename T>
+constexpr std::uint64_t hash(T const& buf,
+                             hash_t const h = BASE_HASH) noexcept {
+  return buf.size() == 0U
+             ? h
+             : rapidhash(reinterpret_cast<char const*>(&buf[0U]),
+                         buf.size(), h);
+}
+
 #else  // defined(CISTA_FNV1A)
 
 // Algorithm: 64bit FNV-1a
@@ -136,6 +197,13 @@ constexpr hash_t hash(const char (&str)[N],
   return hash(std::string_view{str, N - 1U}, h);
 }
 
+// Runtime only (hash map keys, not persisted type hashes): rapidhash
+// instead of byte-wise FNV-1a.
+inline hash_t hash_bytes(void const* data, std::size_t const size,
+                         hash_t const h = BASE_HASH) noexcept {
+  return rapidhash(static_cast<std::uint8_t const*>(data), size, h);
+}
+
 template <typename T>
 constexpr std::uint64_t hash(T const& buf,
                              hash_t const h = BASE_HASH) noexcept {
@@ -148,4 +216,14 @@ constexpr std::uint64_t hash(T const& buf,
 
 #endif
 
+// Avalanche step (murmur3 fmix64): every input bit affects every output bit.
+constexpr std::uint64_t hash_mix(std::uint64_t h) noexcept {
+  h ^= h >> 33U;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33U;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33U;
+  return h;
+}
+
 }  // namespace cista
@@ -2,18 +2,22 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "cista/containers/cstring.h"
 #include "cista/containers/offset_ptr.h"
 #include "cista/containers/pair.h"
 #include "cista/containers/string.h"
 #include "cista/decay.h"
+#include "cista/endian/conversion.h"
 #include "cista/hash.h"
+#include "cista/is_bytewise_comparable.h"
 #include "cista/is_iterable.h"
 #include "cista/reflection/for_each_field.h"
 #include "cista/type_traits.h"
@@ -22,13 +26,6 @@ namespace cista {
 
 namespace detail {
 
-template <typename T, typename = void>
-struct has_hash : std::false_type {};
-
-template <typename T>
-struct has_hash<T, std::void_t<decltype(std::declval<T>().hash())>>
-    : std::true_type {};
-
 template <typename T, typename = void>
 struct has_std_hash : std::false_type {};
 
@@ -37,10 +34,49 @@ struct has_std_hash<
     T, std::void_t<decltype(std::declval<std::hash<T>>()(std::declval<T>()))>>
     : std::true_type {};
 
-}  // namespace detail
+// Appends the little-endian byte image of a bytewise comparable value
+// (members in declaration order, no padding) to `out`.
+template <typename T>
+void write_little_endian(T const& el, std::uint8_t*& out) noexcept {
+  using Type = decay_t<T>;
+  if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>) {
+#if defined(CISTA_BIG_ENDIAN)
+    auto const x = endian_swap(el);
+#else
+    auto const x = el;
+#endif
+    std::memcpy(out, &x, sizeof(x));
+    out += sizeof(x);
+  } else if constexpr (std::is_array_v<Type> || is_std_array<Type>::value) {
+    for (auto const& x : el) {
+      write_little_endian(x, out);
+    }
+  } else if constexpr (is_strong_v<Type>) {
+    write_little_endian(el.v_, out);
+  } else {
+    for_each_field(el, [&](auto const& f) { write_little_endian(f, out); });
+  }
+}
 
+// Hashes the little-endian image of `data[0..n)` so the hash is the same on
+// every host. Hash maps serialized for the other byte order (endian
+// conversion) find their keys. Little-endian hosts hash the memory as is.
 template <typename T>
-inline constexpr bool has_hash_v = detail::has_hash<T>::value;
+hash_t hash_little_endian(T const* data, std::size_t const n,
+                          hash_t const seed) {
+#if defined(CISTA_BIG_ENDIAN)
+  auto buf = std::vector<std::uint8_t>(n * sizeof(T));
+  auto out = buf.data();
+  for (auto i = std::size_t{0U}; i != n; ++i) {
+    write_little_endian(data[i], out);
+  }
+  return hash_bytes(buf.data(), buf.size(), seed);
+#else
+  return hash_bytes(data, n * sizeof(T), seed);
+#endif
+}
+
+}  // namespace detail
 
 template <typename T>
 inline constexpr bool has_std_hash_v = detail::has_std_hash<T>::value;
@@ -91,15 +127,18 @@ struct hashing {
     } else if constexpr (is_pointer_v<Type>) {
       return hash_combine(seed, reinterpret_cast<intptr_t>(ptr_cast(el)));
     } else if constexpr (is_char_array_v<Type>) {
-      return hash(std::string_view{el, sizeof(el) - 1U}, seed);
+      return hash_bytes(el, sizeof(el) - 1U, seed);
     } else if constexpr (is_string_like_v<Type>) {
       using std::begin;
       using std::end;
-      return el.size() == 0U
-                 ? seed
-                 : hash(std::string_view{&(*begin(el)), el.size()}, seed);
+      return el.size() == 0U ? seed
+                             : hash_bytes(&(*begin(el)), el.size(), seed);
     } else if constexpr (std::is_scalar_v<Type>) {
       return hash_combine(seed, el);
+    } else if constexpr (is_bytewise_comparable_v<Type>) {
+      return detail::hash_little_endian(&el, 1U, seed);
+    } else if constexpr (is_contiguous_bytewise_range_v<Type>) {
+      return detail::hash_little_endian(el.data(), el.size(), seed);
     } else if constexpr (is_iterable_v<Type>) {
       auto h = seed;
       for (auto const& v : el) {
@@ -172,7 +211,7 @@ struct hashing<std::tuple<Args...>> {
 template <>
 struct hashing<char const*> {
   hash_t operator()(char const* el, hash_t const seed = BASE_HASH) {
-    return hash(std::string_view{el}, seed);
+    return hash_bytes(el, std::strlen(el), seed);
   }
 };
 
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cista/decay.h"
+#include "cista/reflection/to_tuple.h"
+#include "cista/strong.h"
+
+namespace cista {
+
+// Opt-out for types where bitwise equality is wrong even though their
+// members are integers (e.g. a custom `operator==` that ignores a field):
+//   template <>
+//   struct cista::disable_bytewise_comparison<my_type> : std::true_type {};
+// Disables the `memcmp` equality / ordering and bulk hashing fast paths.
+template <typename T>
+struct disable_bytewise_comparison : std::false_type {};
+
+namespace detail {
+
+template <typename T, typename = void>
+struct has_hash : std::false_type {};
+
+template <typename T>
+struct has_hash<T, std::void_t<decltype(std::declval<T>().hash())>>
+    : std::true_type {};
+
+template <typename T>
+struct is_std_array : std::false_type {};
+
+template <typename T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_bytewise_comparable();
+
+template <typename Tuple>
+struct all_bytewise_comparable;
+
+template <typename... Fields>
+struct all_bytewise_comparable<std::tuple<Fields...>>
+    : std::bool_constant<(is_bytewise_comparable<decay_t<Fields>>() &&
+                          ...)> {};
+
+template <typename T>
+constexpr bool is_bytewise_comparable() {
+  if constexpr (disable_bytewise_comparison<T>::value) {
+    return false;
+  } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+    return true;
+  } else if constexpr (std::is_array_v<T>) {
+    return is_bytewise_comparable<std::remove_cv_t<std::remove_extent_t<T>>>();
+  } else if constexpr (!std::has_unique_object_representations_v<T> ||
+                       has_hash<T>::value) {
+    return false;
+  } else if constexpr (is_std_array<T>::value) {
+    return is_bytewise_comparable<typename T::value_type>();
+  } else if constexpr (is_strong_v<T>) {
+    return is_bytewise_comparable<typename T::value_t>();
+  } else if constexpr (to_tuple_works_v<T> && !has_cista_members_v<T>) {
+    return all_bytewise_comparable<decltype(to_tuple(std::declval<T&>()))>::
+        value;
+  } else {
+    return false;
+  }
+}
+
+template <typename T>
+constexpr bool is_big_endian_orderable();
+
+template <typename Tuple>
+struct all_big_endian_orderable;
+
+template <typename... Fields>
+struct all_big_endian_orderable<std::tuple<Fields...>>
+    : std::bool_constant<(is_big_endian_orderable<decay_t<Fields>>() &&
+                          ...)> {};
+
+template <typename T>
+constexpr bool is_big_endian_orderable() {
+  if constexpr (!is_bytewise_comparable<T>()) {
+    return false;
+  } else if constexpr (std::is_enum_v<T>) {
+    return is_big_endian_orderable<std::underlying_type_t<T>>();
+  } else if constexpr (std::is_integral_v<T>) {
+    return std::is_unsigned_v<T> && !std::is_same_v<T, bool> &&
+           sizeof(T) <= sizeof(std::uint64_t);
+  } else if constexpr (std::is_array_v<T>) {
+    return is_big_endian_orderable<
+        std::remove_cv_t<std::remove_extent_t<T>>>();
+  } else if constexpr (is_std_array<T>::value) {
+    return is_big_endian_orderable<typename T::value_type>();
+  } else if constexpr (is_strong_v<T>) {
+    return is_big_endian_orderable<typename T::value_t>();
+  } else {
+    return all_big_endian_orderable<decltype(to_tuple(
+        std::declval<T&>()))>::value;
+  }
+}
+
+}  // namespace detail
+
+template <typename T>
+inline constexpr bool has_hash_v = detail::has_hash<T>::value;
+
+// True if two values of `T` are equal iff their object representations
+// (bytes) are equal: integers, enums and arrays / aggregates thereof without
+// padding. Floating point (0.0 == -0.0, NaN != NaN), raw and offset
+// pointers (position dependent) and types with a custom `hash()` are
+// excluded.
+template <typename T>
+inline constexpr bool is_bytewise_comparable_v =
+    detail::is_bytewise_comparable<decay_t<T>>();
+
+namespace detail {
+
+template <typename T, typename = void>
+struct is_contiguous_bytewise_range : std::false_type {};
+
+template <typename T>
+struct is_contiguous_bytewise_range<
+    T, std::void_t<decltype(std::declval<T const&>().data()),
+                   decltype(std::declval<T const&>().size())>>
+    : std::bool_constant<is_bytewise_comparable_v<
+          std::remove_pointer_t<decltype(std::declval<T const&>().data())>>> {
+};
+
+}  // namespace detail
+
+// True if `T` is `is_bytewise_comparable_v` and only consists of unsigned
+// integers: with every member converted to big-endian, `memcmp` order
+// equals the member-wise order (`to_tuple(a) < to_tuple(b)`).
+template <typename T>
+inline constexpr bool is_big_endian_orderable_v =
+    detail::is_big_endian_orderable<decay_t<T>>();
+
+// Containers storing `is_bytewise_comparable_v` elements in one contiguous
+// block (`data()`, `size()`), e.g. `vector<int>` or `array<T, N>`.
+template <typename T>
+inline constexpr bool is_contiguous_bytewise_range_v =
+    detail::is_contiguous_bytewise_range<decay_t<T>>::value;
+
+}  // namespace cista
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cinttypes>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cista {
+
+// Ranges smaller than this are not worth spawning a thread for.
+constexpr auto const MIN_PARALLEL_CHUNK_SIZE = std::size_t{1U} << 14U;
+
+inline std::size_t parallel_max_threads() noexcept {
+  return std::max(
+      std::size_t{1U},
+      static_cast<std::size_t>(std::thread::hardware_concurrency()));
+}
+
+inline std::size_t parallel_num_chunks(std::size_t const n) noexcept {
+  return std::clamp(n / MIN_PARALLEL_CHUNK_SIZE, std::size_t{1U},
+                    parallel_max_threads());
+}
+
+// Splits [0, n) into `num_chunks` contiguous chunks of (almost) equal size
+// and calls `fn(chunk_idx, from, to)` for each of them on its own thread.
+// The chunk boundaries only depend on `n` and `num_chunks`, so several
+// passes over the same range with the same chunk count see the same split
+// (required for per-thread histograms + prefix sums).
+// `fn` must not throw.
+template <typename Fn>
+void parallel_for_chunks(std::size_t const n, std::size_t const num_chunks,
+                         Fn&& fn) {
+  auto const chunk_from = [&](std::size_t const chunk) {
+    return n / num_chunks * chunk + std::min(chunk, n % num_chunks);
+  };
+
+  if (num_chunks <= 1U) {
+    fn(std::size_t{0U}, std::size_t{0U}, n);
+    return;
+  }
+
+  auto threads = std::vector<std::thread>{};
+  threads.reserve(num_chunks - 1U);
+  for (auto chunk = std::size_t{1U}; chunk != num_chunks; ++chunk) {
+    threads.emplace_back([&, chunk]() {
+      fn(chunk, chunk_from(chunk), chunk_from(chunk + 1U));
+    });
+  }
+  fn(std::size_t{0U}, std::size_t{0U}, chunk_from(1U));
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+template <typename Fn>
+void parallel_for_chunks(std::size_t const n, Fn&& fn) {
+  parallel_for_chunks(n, parallel_num_chunks(n), std::forward<Fn>(fn));
+}
+
+// Calls `fn(i)` for every i in [0, n), distributed over all hardware threads.
+template <typename Fn>
+void parallel_for(std::size_t const n, Fn&& fn) {
+  parallel_for_chunks(
+      n, [&](std::size_t, std::size_t const from, std::size_t const to) {
+        for (auto i = from; i != to; ++i) {
+          fn(i);
+        }
+      });
+}
+
+}  // namespace cista
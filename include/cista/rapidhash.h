@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+// Algorithm: rapidhash V1 (wyhash successor)
+// Source: https://github.com/Nicoshev/rapidhash
+//
+// Fully constexpr: reads go through byte loads (compiled to single
+// unaligned loads by GCC / Clang / MSVC) and the 64x64->128 bit multiply
+// has a portable fallback. This makes the same function usable for
+// compile time type hashes and runtime hashing.
+
+namespace cista {
+
+namespace rapidhash_detail {
+
+constexpr auto const SEED = 0xBDD89AA982704029ULL;
+constexpr std::uint64_t const SECRET[3] = {
+    0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL, 0x4B33A62ED433D4A3ULL};
+
+constexpr void mum(std::uint64_t& a, std::uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+  auto const r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<std::uint64_t>(r);
+  b = static_cast<std::uint64_t>(r >> 64U);
+#else
+  auto const ha = a >> 32U, hb = b >> 32U;
+  auto const la = a & 0xFFFFFFFFULL, lb = b & 0xFFFFFFFFULL;
+  auto const rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  auto const t = rl + (rm0 << 32U);
+  auto const c = static_cast<std::uint64_t>(t < rl);
+  auto const lo = t + (rm1 << 32U);
+  auto const hi =
+      rh + (rm0 >> 32U) + (rm1 >> 32U) + c + static_cast<std::uint64_t>(lo < t);
+  a = lo;
+  b = hi;
+#endif
+}
+
+constexpr std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+  mum(a, b);
+  return a ^ b;
+}
+
+template <typename Char>
+constexpr std::uint64_t byte(Char const* p, std::size_t const i) noexcept {
+  return static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[i]));
+}
+
+// Written out (no loop) so the compiler merges the byte loads into one load.
+template <typename Char>
+constexpr std::uint64_t read8(Char const* p) noexcept {
+  return byte(p, 0U) | (byte(p, 1U) << 8U) | (byte(p, 2U) << 16U) |
+         (byte(p, 3U) << 24U) | (byte(p, 4U) << 32U) | (byte(p, 5U) << 40U) |
+         (byte(p, 6U) << 48U) | (byte(p, 7U) << 56U);
+}
+
+template <typename Char>
+constexpr std::uint64_t read4(Char const* p) noexcept {
+  return byte(p, 0U) | (byte(p, 1U) << 8U) | (byte(p, 2U) << 16U) |
+         (byte(p, 3U) << 24U);
+}
+
+template <typename Char>
+constexpr std::uint64_t read_small(Char const* p,
+                                   std::size_t const k) noexcept {
+  return (byte(p, 0U) << 56U) | (byte(p, k >> 1U) << 32U) | byte(p, k - 1U);
+}
+
+}  // namespace rapidhash_detail
+
+// `Char` is any byte-sized type (`char`, `unsigned char`, `std::uint8_t`).
+template <typename Char>
+constexpr std::uint64_t rapidhash(
+    Char const* p, std::size_t const len,
+    std::uint64_t seed = rapidhash_detail::SEED) noexcept {
+  using namespace rapidhash_detail;
+  static_assert(sizeof(Char) == 1U);
+
+  seed ^= mix(seed ^ SECRET[0], SECRET[1]) ^ len;
+  auto a = std::uint64_t{0U}, b = std::uint64_t{0U};
+  if (len <= 16U) {
+    if (len >= 4U) {
+      auto const plast = p + len - 4U;
+      auto const delta = (len & 24U) >> (len >> 3U);
+      a = (read4(p) << 32U) | read4(plast);
+      b = (read4(p + delta) << 32U) | read4(plast - delta);
+    } else if (len > 0U) {
+      a = read_small(p, len);
+    }
+  } else {
+    auto i = len;
+    if (i > 48U) {
+      auto see1 = seed, see2 = seed;
+      do {
+        seed = mix(read8(p) ^ SECRET[0], read8(p + 8U) ^ seed);
+        see1 = mix(read8(p + 16U) ^ SECRET[1], read8(p + 24U) ^ see1);
+        see2 = mix(read8(p + 32U) ^ SECRET[2], read8(p + 40U) ^ see2);
+        p += 48U;
+        i -= 48U;
+      } while (i >= 48U);
+      seed ^= see1 ^ see2;
+    }
+    if (i > 16U) {
+      seed = mix(read8(p) ^ SECRET[2], read8(p + 8U) ^ seed ^ SECRET[1]);
+      if (i > 32U) {
+        seed = mix(read8(p + 16U) ^ SECRET[2], read8(p + 24U) ^ seed);
+      }
+    }
+    a = read8(p + i - 16U);
+    b = read8(p + i - 8U);
+  }
+  a ^= SECRET[1];
+  b ^= seed;
+  mum(a, b);
+  return mix(a ^ SECRET[0] ^ len, b ^ SECRET[1]);
+}
+
+// Single 64 bit value (e.g. `hash_combine`): one multiply-mix.
+constexpr std::uint64_t rapidhash_u64(std::uint64_t const seed,
+                                      std::uint64_t const v) noexcept {
+  using namespace rapidhash_detail;
+  return mix(seed ^ v ^ SECRET[0], v ^ SECRET[1]) ^ seed;
+}
+
+}  // namespace cista
@@ -1,59 +1,129 @@
 #pragma once
 
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "cista/decay.h"
+#include "cista/endian/conversion.h"
+#include "cista/is_bytewise_comparable.h"
 #include "cista/reflection/to_tuple.h"
+#include "cista/strong.h"
+
+namespace cista {
+
+namespace detail {
+
+// Converts every member of an `is_big_endian_orderable_v` value to
+// big-endian (in place).
+template <typename T>
+void to_big_endian(T& t) noexcept {
+  if constexpr (std::is_enum_v<T>) {
+    using int_t = std::underlying_type_t<T>;
+    t = static_cast<T>(endian_swap(static_cast<int_t>(t)));
+  } else if constexpr (std::is_integral_v<T>) {
+    t = endian_swap(t);
+  } else if constexpr (std::is_array_v<T> || is_std_array<T>::value) {
+    for (auto& x : t) {
+      to_big_endian(x);
+    }
+  } else if constexpr (is_strong_v<T>) {
+    to_big_endian(t.v_);
+  } else {
+    std::apply([](auto&... fields) { (to_big_endian(fields), ...); },
+               to_tuple(t));
+  }
+}
+
+}  // namespace detail
+
+// Member-wise comparison used by CISTA_COMPARABLE / CISTA_FRIEND_COMPARABLE.
+// Padding-free integer structs test equality with a single `memcmp` (see
+// `is_bytewise_comparable_v`). Structs of unsigned integers are ordered by
+// one `memcmp` of their big-endian representations (see
+// `is_big_endian_orderable_v`), everything else member-wise.
+template <typename A, typename B>
+bool reflection_equal(A const& a, B const& b) {
+  if constexpr (std::is_same_v<decay_t<A>, decay_t<B>> &&
+                is_bytewise_comparable_v<A>) {
+    return std::memcmp(&a, &b, sizeof(A)) == 0;
+  } else {
+    return to_tuple(a) == to_tuple(b);
+  }
+}
+
+template <typename A, typename B>
+bool reflection_less(A const& a, B const& b) {
+  if constexpr (std::is_same_v<decay_t<A>, decay_t<B>> &&
+                is_big_endian_orderable_v<A>) {
+#if defined(CISTA_BIG_ENDIAN)
+    return std::memcmp(&a, &b, sizeof(A)) < 0;
+#else
+    auto x = a;
+    auto y = b;
+    detail::to_big_endian(x);
+    detail::to_big_endian(y);
+    return std::memcmp(&x, &y, sizeof(A)) < 0;
+#endif
+  } else {
+    return to_tuple(a) < to_tuple(b);
+  }
+}
+
+}  // namespace cista
 
 #define CISTA_COMPARABLE()                               \
   template <typename T>                                  \
   bool operator==(T&& b) const {                         \
-    return cista::to_tuple(*this) == cista::to_tuple(b); \
+    return cista::reflection_equal(*this, b);            \
   }                                                      \
                                                          \
   template <typename T>                                  \
   bool operator!=(T&& b) const {                         \
-    return cista::to_tuple(*this) != cista::to_tuple(b); \
+    return !cista::reflection_equal(*this, b);           \
   }                                                      \
                                                          \
   template <typename T>                                  \
   bool operator<(T&& b) const {                          \
-    return cista::to_tuple(*this) < cista::to_tuple(b);  \
+    return cista::reflection_less(*this, b);             \
   }                                                      \
                                                          \
   template <typename T>                                  \
   bool operator<=(T&& b) const {                         \
-    return cista::to_tuple(*this) <= cista::to_tuple(b); \
+    return !cista::reflection_less(b, *this);            \
   }                                                      \
                                                          \
   template <typename T>                                  \
   bool operator>(T&& b) const {                          \
-    return cista::to_tuple(*this) > cista::to_tuple(b);  \
+    return cista::reflection_less(b, *this);             \
   }                                                      \
                                                          \
   template <typename T>                                  \
   bool operator>=(T&& b) const {                         \
-    return cista::to_tuple(*this) >= cista::to_tuple(b); \
+    return !cista::reflection_less(*this, b);            \
   }
 
 #define CISTA_FRIEND_COMPARABLE(class_name)                          \
   friend bool operator==(class_name const& a, class_name const& b) { \
-    return cista::to_tuple(a) == cista::to_tuple(b);                 \
+    return cista::reflection_equal(a, b);                            \
   }                                                                  \
                                                                      \
   friend bool operator!=(class_name const& a, class_name const& b) { \
-    return cista::to_tuple(a) != cista::to_tuple(b);                 \
+    return !cista::reflection_equal(a, b);                           \
   }                                                                  \
                                                                      \
   friend bool operator<(class_name const& a, class_name const& b) {  \
-    return cista::to_tuple(a) < cista::to_tuple(b);                  \
+    return cista::reflection_less(a, b);                             \
   }                                                                  \
                                                                      \
   friend bool operator<=(class_name const& a, class_name const& b) { \
-    return cista::to_tuple(a) <= cista::to_tuple(b);                 \
+    return !cista::reflection_less(b, a);                            \
   }                                                                  \
                                                                      \
   friend bool operator>(class_name const& a, class_name const& b) {  \
-    return cista::to_tuple(a) > cista::to_tuple(b);                  \
+    return cista::reflection_less(b, a);                             \
   }                                                                  \
                                                                      \
   friend bool operator>=(class_name const& a, class_name const& b) { \
-    return cista::to_tuple(a) >= cista::to_tuple(b);                 \
+    return !cista::reflection_less(a, b);                            \
   }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <limits>
 #include <map>
 #include <numeric>
@@ -16,6 +18,7 @@
 #include "cista/mode.h"
 #include "cista/offset_t.h"
 #include "cista/reflection/for_each_field.h"
+#include "cista/serialization_layout.h"
 #include "cista/serialized_size.h"
 #include "cista/strong.h"
 #include "cista/targets/buf.h"
@@ -55,9 +58,11 @@ offset_t member_offset(T const* t, Member T::*m) {
 // =============================================================================
 // SERIALIZE
 // -----------------------------------------------------------------------------
+template <typename Ctx>
 struct pending_offset {
   void const* origin_ptr_;
   offset_t pos_;
+  bool (Ctx::*resolve_)(void const*, offset_t, bool);  // with ptr `OffsetT`
 };
 
 struct vector_range {
@@ -78,12 +83,29 @@ struct vector_range {
   std::size_t size_;
 };
 
+struct deferred_block {
+  std::uint64_t priority_;
+  std::size_t seq_;
+  void const* origin_;
+  std::size_t size_, alignment_;
+  offset_t ptr_pos_;
+  std::function<void(offset_t)> on_written_;
+};
+
 template <typename Target, mode Mode>
 struct serialization_context {
   static constexpr auto const MODE = Mode;
 
   explicit serialization_context(Target& t) : t_{t} {}
 
+  serialization_context(Target& t, layout_policy const& policy,
+                        layout_stats* stats)
+      : t_{t}, policy_{policy}, stats_{stats} {
+    if (stats_ != nullptr) {
+      end_ = static_cast<offset_t>(t_.size());
+    }
+  }
+
   static bool compare(std::pair<void const*, vector_range> const& a,
                       std::pair<void const*, vector_range> const& b) noexcept {
     return a.first < b.first;
@@ -91,7 +113,125 @@ struct serialization_context {
 
   offset_t write(void const* ptr, std::size_t const size,
                  std::size_t const alignment = 0) {
-    return t_.write(ptr, size, alignment);
+    auto const start = t_.write(ptr, size, alignment);
+    if (stats_ != nullptr) {
+      stats_->padding_bytes_ += static_cast<std::size_t>(start - end_);
+      end_ = start + static_cast<offset_t>(size);
+    }
+    return start;
+  }
+
+  // Writes an out-of-line block of a container (pointer to it stored at
+  // `ptr_pos`) and calls `on_written(start)`. Depending on the layout
+  // policy, the block is written immediately or later (deferred).
+  template <typename Fn>
+  void write_block(void const* origin, std::size_t const size,
+                   std::size_t const alignment, offset_t const ptr_pos,
+                   Fn&& on_written) {
+    switch (policy_.layout_) {
+      case layout::DFS:
+        on_written(write_block_now(origin, size, alignment, ptr_pos));
+        break;
+
+      case layout::CHILDREN_ADJACENT:
+        adjacent_.emplace_back(
+            [start = write_block_now(origin, size, alignment, ptr_pos),
+             f = std::forward<Fn>(on_written)]() mutable { f(start); });
+        break;
+
+      default:
+        deferred_.emplace_back(deferred_block{
+            block_priority(origin, alignment), seq_++, origin, size,
+            alignment, ptr_pos, std::forward<Fn>(on_written)});
+        std::push_heap(begin(deferred_), end(deferred_), compare_deferred);
+        break;
+    }
+  }
+
+  offset_t write_block_now(void const* origin, std::size_t const size,
+                           std::size_t const alignment,
+                           offset_t const ptr_pos) {
+    auto const start = write(origin, size, alignment);
+    if (stats_ != nullptr) {
+      auto const page_size = static_cast<offset_t>(policy_.page_size_);
+      ++stats_->blocks_;
+      stats_->block_bytes_ += size;
+      if (ptr_pos != NULLPTR_OFFSET &&
+          ptr_pos / page_size != start / page_size) {
+        ++stats_->page_crossings_;
+      }
+      if (policy_.profile_ == nullptr || policy_.profile_->empty() ||
+          policy_.profile_->find(origin) != policy_.profile_->end()) {
+        touched_.emplace_back(start, size);
+      }
+    }
+    return start;
+  }
+
+  // Writes all deferred blocks (and the blocks they reach).
+  void flush_blocks() {
+    if (policy_.layout_ == layout::CHILDREN_ADJACENT) {
+      flush_adjacent();
+      return;
+    }
+    while (!deferred_.empty()) {
+      std::pop_heap(begin(deferred_), end(deferred_), compare_deferred);
+      auto b = std::move(deferred_.back());
+      deferred_.pop_back();
+      b.on_written_(write_block_now(b.origin_, b.size_, b.alignment_,
+                                    b.ptr_pos_));
+    }
+  }
+
+  void flush_adjacent() {
+    auto children = std::move(adjacent_);
+    adjacent_.clear();
+    for (auto& recurse : children) {
+      recurse();
+      flush_adjacent();
+    }
+  }
+
+  void finish_stats() {
+    if (stats_ == nullptr) {
+      return;
+    }
+    auto const page_size = policy_.page_size_;
+    auto pages = std::vector<std::size_t>{};
+    for (auto const& [start, size] : touched_) {
+      auto const from = static_cast<std::size_t>(start);
+      auto const to = from + std::max(size, std::size_t{1U}) - 1U;
+      for (auto p = from / page_size; p <= to / page_size; ++p) {
+        pages.emplace_back(p);
+      }
+    }
+    std::sort(begin(pages), end(pages));
+    stats_->touched_pages_ = static_cast<std::size_t>(
+        std::distance(begin(pages), std::unique(begin(pages), end(pages))));
+    stats_->pages_ =
+        (static_cast<std::size_t>(end_) + page_size - 1U) / page_size;
+  }
+
+  std::uint64_t block_priority(void const* origin,
+                               std::size_t const alignment) const {
+    switch (policy_.layout_) {
+      case layout::HOT_FIRST: {
+        if (policy_.profile_ == nullptr) {
+          return 0U;
+        }
+        auto const it = policy_.profile_->find(origin);
+        return it == policy_.profile_->end() ? 0U : it->second;
+      }
+      case layout::SIZE_CLASS: return std::max(alignment, std::size_t{1U});
+      default: return 0U;
+    }
+  }
+
+  // Max heap: highest priority first, FIFO (= breadth first) among equals.
+  static bool compare_deferred(deferred_block const& a,
+                               deferred_block const& b) noexcept {
+    return a.priority_ < b.priority_ ||
+           (a.priority_ == b.priority_ && a.seq_ > b.seq_);
   }
 
   template <typename T>
@@ -99,34 +239,51 @@ struct serialization_context {
     t_.write(static_cast<std::size_t>(pos), val);
   }
 
-  template <typename T>
-  bool resolve_pointer(offset_ptr<T> const& ptr, offset_t const pos,
-                       bool const add_pending = true) {
-    return resolve_pointer(ptr.get(), pos, add_pending);
+  // Writes a pointer stored as `OffsetT` at `pos` that points to `target`
+  // (or `NULLPTR_OFFSET`). Narrow offsets are verified to fit.
+  template <typename OffsetT>
+  void write_offset(offset_t const pos, offset_t const target) {
+    write(pos, convert_endian<MODE>(
+                   target == NULLPTR_OFFSET
+                       ? std::numeric_limits<OffsetT>::min()
+                       : narrow_offset<OffsetT>(target - pos)));
   }
 
   template <typename Ptr>
+  void write_ptr(offset_t const pos, offset_t const target) {
+    write_offset<ptr_offset_t<Ptr>>(pos, target);
+  }
+
+  template <typename T, typename OffsetT>
+  bool resolve_pointer(offset_ptr<T, OffsetT> const& ptr, offset_t const pos,
+                       bool const add_pending = true) {
+    return resolve_pointer<OffsetT>(ptr.get(), pos, add_pending);
+  }
+
+  template <typename OffsetT = offset_t, typename Ptr>
   bool resolve_pointer(Ptr ptr, offset_t const pos,
                        bool const add_pending = true) {
     if (std::is_same_v<decay_t<remove_pointer_t<Ptr>>, void> && add_pending) {
-      write(pos, convert_endian<MODE>(NULLPTR_OFFSET));
+      write_offset<OffsetT>(pos, NULLPTR_OFFSET);
       return true;
     }
     if (ptr == nullptr) {
-      write(pos, convert_endian<MODE>(NULLPTR_OFFSET));
+      write_offset<OffsetT>(pos, NULLPTR_OFFSET);
       return true;
     }
     if (auto const it = offsets_.find(ptr_cast(ptr)); it != end(offsets_)) {
-      write(pos, convert_endian<MODE>(it->second - pos));
+      write_offset<OffsetT>(pos, it->second);
       return true;
     }
     if (auto const offset = resolve_vector_range_ptr(ptr); offset.has_value()) {
-      write(pos, convert_endian<MODE>(*offset - pos));
+      write_offset<OffsetT>(pos, *offset);
       return true;
     }
     if (add_pending) {
-      write(pos, convert_endian<MODE>(NULLPTR_OFFSET));
-      pending_.emplace_back(pending_offset{ptr_cast(ptr), pos});
+      write_offset<OffsetT>(pos, NULLPTR_OFFSET);
+      pending_.emplace_back(pending_offset<serialization_context>{
+          ptr_cast(ptr), pos,
+          &serialization_context::resolve_pointer<OffsetT, void const*>});
       return true;
     }
     return false;
@@ -153,8 +310,16 @@ struct serialization_context {
 
   cista::raw::hash_map<void const*, offset_t> offsets_;
   std::map<void const*, vector_range> vector_ranges_;
-  std::vector<pending_offset> pending_;
+  std::vector<pending_offset<serialization_context>> pending_;
   Target& t_;
+
+  layout_policy policy_;
+  layout_stats* stats_{nullptr};
+  offset_t end_{0};
+  std::size_t seq_{0U};
+  std::vector<deferred_block> deferred_;
+  std::vector<std::function<void()>> adjacent_;
+  std::vector<std::pair<offset_t, std::size_t>> touched_;
 };
 
 template <typename Ctx, typename T>
@@ -192,35 +357,33 @@ void serialize(Ctx& c,
   using Type = basic_vector<T, Ptr, Indexed, TemplateSizeType>;
 
   auto const size = serialized_size<T>() * origin->used_size_;
-  auto const start = origin->empty()
-                         ? NULLPTR_OFFSET
-                         : c.write(static_cast<T const*>(origin->el_), size,
-                                   std::alignment_of_v<T>);
-
-  c.write(pos + cista_member_offset(Type, el_),
-          convert_endian<Ctx::MODE>(
-              start == NULLPTR_OFFSET
-                  ? start
-                  : start - cista_member_offset(Type, el_) - pos));
+  auto const ptr_pos = pos + cista_member_offset(Type, el_);
+
   c.write(pos + cista_member_offset(Type, allocated_size_),
           convert_endian<Ctx::MODE>(origin->used_size_));
   c.write(pos + cista_member_offset(Type, used_size_),
           convert_endian<Ctx::MODE>(origin->used_size_));
   c.write(pos + cista_member_offset(Type, self_allocated_), false);
 
-  if constexpr (Indexed) {
-    if (origin->el_ != nullptr) {
-      c.vector_ranges_.emplace(origin->el_, vector_range{start, size});
-    }
+  if (origin->empty()) {
+    c.template write_ptr<Ptr<T>>(ptr_pos, NULLPTR_OFFSET);
+    return;
   }
 
-  if (origin->el_ != nullptr) {
-    auto i = 0U;
-    for (auto it = start; it != start + static_cast<offset_t>(size);
-         it += serialized_size<T>()) {
-      serialize(c, static_cast<T const*>(origin->el_ + i++), it);
-    }
-  }
+  auto const el = static_cast<T const*>(origin->el_);
+  c.write_block(el, size, std::alignment_of_v<T>, ptr_pos,
+                [&c, el, size, ptr_pos](offset_t const start) {
+                  c.template write_ptr<Ptr<T>>(ptr_pos, start);
+                  if constexpr (Indexed) {
+                    c.vector_ranges_.emplace(el, vector_range{start, size});
+                  }
+                  auto i = 0U;
+                  for (auto it = start;
+                       it != start + static_cast<offset_t>(size);
+                       it += serialized_size<T>()) {
+                    serialize(c, el + i++, it);
+                  }
+                });
 }
 
 template <typename Ctx, typename Ptr>
@@ -231,17 +394,20 @@ void serialize(Ctx& c, generic_string<Ptr> const* origin, offset_t const pos) {
     return;
   }
 
-  auto const start = (origin->h_.ptr_ == nullptr)
-                         ? NULLPTR_OFFSET
-                         : c.write(origin->data(), origin->size());
-  c.write(pos + cista_member_offset(Type, h_.ptr_),
-          convert_endian<Ctx::MODE>(
-              start == NULLPTR_OFFSET
-                  ? start
-                  : start - cista_member_offset(Type, h_.ptr_) - pos));
+  auto const ptr_pos = pos + cista_member_offset(Type, h_.ptr_);
   c.write(pos + cista_member_offset(Type, h_.size_),
           convert_endian<Ctx::MODE>(origin->h_.size_));
   c.write(pos + cista_member_offset(Type, h_.self_allocated_), false);
+
+  if (origin->h_.ptr_ == nullptr) {
+    c.template write_ptr<Ptr>(ptr_pos, NULLPTR_OFFSET);
+    return;
+  }
+
+  c.write_block(origin->data(), origin->size(), 0U, ptr_pos,
+                [&c, ptr_pos](offset_t const start) {
+                  c.template write_ptr<Ptr>(ptr_pos, start);
+                });
 }
 
 template <typename Ctx, typename T, typename SizeType,
@@ -268,25 +434,24 @@ void serialize(Ctx& c, generic_cstring<Ptr> const* origin, offset_t const pos) {
     return;
   }
 
-  const auto* data = origin->data();
-  auto size = origin->size();
-  std::string buf;
-  if (!origin->is_owning()) {
-    buf = origin->str();
-    data = buf.data();
-    size = buf.size();
-  }
-  auto capacity = size + 1;
-
-  auto const start = c.write(data, capacity);
-  c.write(pos + cista_member_offset(Type, h_.ptr_),
-          convert_endian<Ctx::MODE>(start - cista_member_offset(Type, h_.ptr_) -
-                                    pos));
+  auto const ptr_pos = pos + cista_member_offset(Type, h_.ptr_);
   c.write(pos + cista_member_offset(Type, h_.size_),
           convert_endian<Ctx::MODE>(origin->h_.size_));
   c.write(pos + cista_member_offset(Type, h_.self_allocated_), false);
   c.write(pos + cista_member_offset(Type, h_.minus_one_),
           static_cast<char>(-1));
+
+  auto const on_written = [&c, ptr_pos](offset_t const start) {
+    c.template write_ptr<Ptr>(ptr_pos, start);
+  };
+  if (origin->is_owning()) {
+    c.write_block(origin->data(), origin->size() + 1U, 0U, ptr_pos,
+                  on_written);
+  } else {
+    // Copy with terminating zero only lives until the end of this function.
+    auto const buf = origin->str();
+    on_written(c.write_block_now(buf.data(), buf.size() + 1U, 0U, ptr_pos));
+  }
 }
 
 template <typename Ctx, typename Ptr>
@@ -310,22 +475,21 @@ void serialize(Ctx& c, basic_unique_ptr<T, Ptr> const* origin,
                offset_t const pos) {
   using Type = basic_unique_ptr<T, Ptr>;
 
-  auto const start =
-      origin->el_ == nullptr
-          ? NULLPTR_OFFSET
-          : c.write(origin->el_, serialized_size<T>(), std::alignment_of_v<T>);
-
-  c.write(pos + cista_member_offset(Type, el_),
-          convert_endian<Ctx::MODE>(
-              start == NULLPTR_OFFSET
-                  ? start
-                  : start - cista_member_offset(Type, el_) - pos));
+  auto const ptr_pos = pos + cista_member_offset(Type, el_);
   c.write(pos + cista_member_offset(Type, self_allocated_), false);
 
-  if (origin->el_ != nullptr) {
-    c.offsets_[origin->el_] = start;
-    serialize(c, ptr_cast(origin->el_), start);
+  if (origin->el_ == nullptr) {
+    c.template write_ptr<Ptr>(ptr_pos, NULLPTR_OFFSET);
+    return;
   }
+
+  auto const el = ptr_cast(origin->el_);
+  c.write_block(el, serialized_size<T>(), std::alignment_of_v<T>, ptr_pos,
+                [&c, el, ptr_pos](offset_t const start) {
+                  c.template write_ptr<Ptr>(ptr_pos, start);
+                  c.offsets_[el] = start;
+                  serialize(c, el, start);
+                });
 }
 
 template <typename Ctx, typename T, template <typename> typename Ptr,
@@ -334,34 +498,10 @@ void serialize(Ctx& c,
                hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq> const* origin,
                offset_t const pos) {
   using Type = hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq>;
+  using ctrl_t = typename Type::ctrl_t;
 
-  auto const start =
-      origin->entries_ == nullptr
-          ? NULLPTR_OFFSET
-          : c.write(origin->entries_,
-                    static_cast<std::size_t>(
-                        origin->capacity_ * serialized_size<T>() +
-                        (origin->capacity_ + 1 + Type::WIDTH) *
-                            sizeof(typename Type::ctrl_t)),
-                    std::alignment_of_v<T>);
-  auto const ctrl_start =
-      start == NULLPTR_OFFSET
-          ? c.write(Type::empty_group(), 16U * sizeof(typename Type::ctrl_t),
-                    std::alignment_of_v<typename Type::ctrl_t>)
-          : start +
-                static_cast<offset_t>(origin->capacity_ * serialized_size<T>());
-
-  c.write(pos + cista_member_offset(Type, entries_),
-          convert_endian<Ctx::MODE>(
-              start == NULLPTR_OFFSET
-                  ? start
-                  : start - cista_member_offset(Type, entries_) - pos));
-  c.write(pos + cista_member_offset(Type, ctrl_),
-          convert_endian<Ctx::MODE>(
-              ctrl_start == NULLPTR_OFFSET
-                  ? ctrl_start
-                  : ctrl_start - cista_member_offset(Type, ctrl_) - pos));
-
+  auto const entries_pos = pos + cista_member_offset(Type, entries_);
+  auto const ctrl_pos = pos + cista_member_offset(Type, ctrl_);
   c.write(pos + cista_member_offset(Type, self_allocated_), false);
 
   c.write(pos + cista_member_offset(Type, size_),
@@ -370,18 +510,39 @@ void serialize(Ctx& c,
           convert_endian<Ctx::MODE>(origin->capacity_));
   c.write(pos + cista_member_offset(Type, growth_left_),
           convert_endian<Ctx::MODE>(origin->growth_left_));
-
-  if (origin->entries_ != nullptr) {
-    auto i = 0u;
-    for (auto it = start;
-         it != start + static_cast<offset_t>(origin->capacity_ *
-                                             serialized_size<T>());
-         it += serialized_size<T>(), ++i) {
-      if (Type::is_full(origin->ctrl_[i])) {
-        serialize(c, static_cast<T*>(origin->entries_ + i), it);
-      }
-    }
+  c.write(pos + cista_member_offset(Type, seed_),
+          convert_endian<Ctx::MODE>(origin->seed_));
+
+  if (origin->entries_ == nullptr) {
+    c.write_block(Type::empty_group(), 16U * sizeof(ctrl_t),
+                  std::alignment_of_v<ctrl_t>, ctrl_pos,
+                  [&c, entries_pos, ctrl_pos](offset_t const ctrl_start) {
+                    c.template write_ptr<Ptr<T>>(entries_pos, NULLPTR_OFFSET);
+                    c.template write_ptr<Ptr<ctrl_t>>(ctrl_pos, ctrl_start);
+                  });
+    return;
   }
+
+  auto const entries = static_cast<T const*>(origin->entries_);
+  auto const ctrl = static_cast<ctrl_t const*>(origin->ctrl_);
+  auto const capacity = static_cast<std::size_t>(origin->capacity_);
+  auto const entries_size = capacity * serialized_size<T>();
+  c.write_block(
+      entries,
+      entries_size + (capacity + 1U + Type::WIDTH) * sizeof(ctrl_t),
+      std::alignment_of_v<T>, entries_pos,
+      [&c, entries, ctrl, capacity, entries_size, entries_pos,
+       ctrl_pos](offset_t const start) {
+        c.template write_ptr<Ptr<T>>(entries_pos, start);
+        c.template write_ptr<Ptr<ctrl_t>>(
+            ctrl_pos, start + static_cast<offset_t>(entries_size));
+        for (auto i = std::size_t{0U}; i != capacity; ++i) {
+          if (Type::is_full(ctrl[i])) {
+            serialize(c, entries + i,
+                      start + static_cast<offset_t>(i * serialized_size<T>()));
+          }
+        }
+      });
 }
 
 template <typename Ctx, typename Rep, typename Period>
@@ -483,9 +644,9 @@ constexpr offset_t data_start(mode const m) noexcept {
   return start;
 }
 
-template <mode const Mode = mode::NONE, typename Target, typename T>
-void serialize(Target& t, T& value) {
-  serialization_context<Target, Mode> c{t};
+template <typename Ctx, typename T>
+void serialize_value(Ctx& c, T& value) {
+  constexpr auto const Mode = Ctx::MODE;
 
   if constexpr (is_mode_enabled(Mode, mode::WITH_VERSION) ||
                 is_mode_enabled(Mode, mode::WITH_STATIC_VERSION)) {
@@ -510,11 +671,13 @@ void serialize(Target& t, T& value) {
   }
 
   serialize(c, &value,
-            c.write(&value, serialized_size<T>(),
-                    std::alignment_of_v<decay_t<decltype(value)>>));
+            c.write_block_now(&value, serialized_size<T>(),
+                              std::alignment_of_v<decay_t<decltype(value)>>,
+                              NULLPTR_OFFSET));
+  c.flush_blocks();
 
   for (auto& p : c.pending_) {
-    if (!c.resolve_pointer(p.origin_ptr_, p.pos_, false)) {
+    if (!(c.*p.resolve_)(p.origin_ptr_, p.pos_, false)) {
       printf("warning: dangling pointer at %" PRI_O " (origin=%p)\n", p.pos_,
              p.origin_ptr_);
     }
@@ -525,6 +688,23 @@ void serialize(Target& t, T& value) {
         c.checksum(integrity_offset + static_cast<offset_t>(sizeof(hash_t)));
     c.write(integrity_offset, convert_endian<Mode>(csum));
   }
+
+  c.finish_stats();
+}
+
+template <mode const Mode = mode::NONE, typename Target, typename T>
+void serialize(Target& t, T& value) {
+  serialization_context<Target, Mode> c{t};
+  serialize_value(c, value);
+}
+
+// Serializes with the given block order and reports its statistics.
+template <mode const Mode = mode::NONE, typename Target, typename T>
+layout_stats serialize(Target& t, T& value, layout_policy const& policy) {
+  auto stats = layout_stats{};
+  serialization_context<Target, Mode> c{t, policy, &stats};
+  serialize_value(c, value);
+  return stats;
 }
 
 template <mode const Mode = mode::NONE, typename T>
@@ -605,11 +785,12 @@ struct deserialization_context {
     }
   }
 
-  template <typename T>
-  void check_ptr(offset_ptr<T> const& el,
+  template <typename T, typename OffsetT>
+  void check_ptr(offset_ptr<T, OffsetT> const& el,
                  std::size_t const size = type_size<T>()) const {
     if (el != nullptr) {
-      checked_addition(el.offset_, reinterpret_cast<offset_t>(&el));
+      checked_addition(static_cast<offset_t>(el.offset_),
+                       reinterpret_cast<offset_t>(&el));
       check_ptr(el.get(), size);
     }
   }
@@ -764,18 +945,18 @@ void recurse(Ctx&, std::pair<A, B>* el, Fn&& fn) {
 }
 
 // --- OFFSET_PTR<T> ---
-template <typename Ctx, typename T>
-void convert_endian_and_ptr(Ctx const& c, offset_ptr<T>* el) {
+template <typename Ctx, typename T, typename OffsetT>
+void convert_endian_and_ptr(Ctx const& c, offset_ptr<T, OffsetT>* el) {
   c.convert_endian(el->offset_);
 }
 
-template <typename Ctx, typename T>
-void check_state(Ctx const& c, offset_ptr<T>* el) {
+template <typename Ctx, typename T, typename OffsetT>
+void check_state(Ctx const& c, offset_ptr<T, OffsetT>* el) {
   c.check_ptr(*el);
 }
 
-template <typename Ctx, typename T, typename Fn>
-void recurse(Ctx& c, offset_ptr<T>* el, Fn&& fn) {
+template <typename Ctx, typename T, typename OffsetT, typename Fn>
+void recurse(Ctx& c, offset_ptr<T, OffsetT>* el, Fn&& fn) {
   if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
     if (*el != nullptr && c.add_checked(el)) {
       fn(static_cast<T*>(*el));
@@ -912,6 +1093,7 @@ void convert_endian_and_ptr(
   c.convert_endian(el->size_);
   c.convert_endian(el->capacity_);
   c.convert_endian(el->growth_left_);
+  c.convert_endian(el->seed_);
 }
 
 template <typename Ctx, typename T, template <typename> typename Ptr,
@@ -954,29 +1136,45 @@ void check_state(Ctx const& c,
             "hash storage: ctrl bytes must be empty or deleted or full");
 
   using st_t = typename Type::size_type;
-  auto [total_empty, total_full, total_deleted, total_growth_left] =
-      std::accumulate(
-          ptr_cast(el->ctrl_), ptr_cast(el->ctrl_) + el->capacity_,
-          std::tuple{st_t{0U}, st_t{0U}, st_t{0U}, st_t{0}},
-          [&](std::tuple<st_t, st_t, st_t, st_t> const acc,
-              typename Type::ctrl_t const& ctrl) {
-            auto const [empty, full, deleted, growth_left] = acc;
-            return std::tuple{
-                Type::is_empty(ctrl) ? empty + 1 : empty,
-                Type::is_full(ctrl) ? full + 1 : full,
-                Type::is_deleted(ctrl) ? deleted + 1 : deleted,
-                (Type::is_empty(ctrl) && el->was_never_full(static_cast<st_t>(
-                                             &ctrl - el->ctrl_))
-                     ? growth_left + 1
-                     : growth_left)};
-          });
+  auto [total_empty, total_full, total_deleted] = std::accumulate(
+      ptr_cast(el->ctrl_), ptr_cast(el->ctrl_) + el->capacity_,
+      std::tuple{st_t{0U}, st_t{0U}, st_t{0U}},
+      [&](std::tuple<st_t, st_t, st_t> const acc,
+          typename Type::ctrl_t const& ctrl) {
+        auto const [empty, full, deleted] = acc;
+        return std::tuple{Type::is_empty(ctrl) ? empty + 1 : empty,
+                          Type::is_full(ctrl) ? full + 1 : full,
+                          Type::is_deleted(ctrl) ? deleted + 1 : deleted};
+      });
 
   c.require(el->size_ == total_full, "hash storage: size");
   c.require(total_empty + total_full + total_deleted == el->capacity_,
             "hash storage: empty + full + deleted = capacity");
-  c.require(std::min(Type::capacity_to_growth(el->capacity_) - el->size_,
-                     total_growth_left) <= el->growth_left_,
+
+  // Tombstones do not give back growth: growth_left = growth - full - deleted.
+  // A larger value would allow inserts to fill the last empty slot.
+  auto const growth = Type::capacity_to_growth(el->capacity_);
+  c.require(total_full + total_deleted <= growth &&
+                el->growth_left_ <= growth - total_full - total_deleted,
             "hash storage: growth left");
+
+  // Keys that can be hashed without following pointers (not checked yet):
+  // every full slot has to carry the h2 bits of its (seeded) hash. Hashing
+  // all keys touches every entry (e.g. pages of a mmap'd map), so this is
+  // only done with `mode::DEEP_CHECK`.
+  using key_t = typename Type::key_type;
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::DEEP_CHECK) &&
+                is_mode_disabled(Ctx::MODE, mode::_PHASE_II) &&
+                std::is_scalar_v<key_t> && !std::is_pointer_v<key_t>) {
+    for (auto i = st_t{0U}; i != el->capacity_; ++i) {
+      if (Type::is_full(el->ctrl_[i])) {
+        auto key = static_cast<key_t>(GetKey{}(el->entries_[i]));
+        c.convert_endian(key);
+        c.require(el->ctrl_[i] == Type::h2(el->compute_hash(key)),
+                  "hash storage: ctrl byte does not match seeded hash");
+      }
+    }
+  }
 }
 
 template <typename Ctx, typename T, template <typename> typename Ptr,
@@ -989,12 +1187,517 @@ void recurse(Ctx&, hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq>* el,
   }
 }
 
+// --- PERFECT_HASH_MAP<K, V> ---
+template <typename Ctx, typename K, typename V,
+          template <typename> typename Vec, typename Hash, typename Eq>
+void convert_endian_and_ptr(Ctx const& c,
+                            basic_perfect_hash_map<K, V, Vec, Hash, Eq>* el) {
+  deserialize(c, &el->entries_);
+  deserialize(c, &el->shards_);
+  deserialize(c, &el->pilots_);
+  deserialize(c, &el->free_slots_);
+  c.convert_endian(el->seed_);
+}
+
+template <typename Ctx, typename K, typename V,
+          template <typename> typename Vec, typename Hash, typename Eq>
+void check_state(Ctx const& c,
+                 basic_perfect_hash_map<K, V, Vec, Hash, Eq>* el) {
+  using Type = decay_t<remove_pointer_t<decltype(el)>>;
+
+  if (el->shards_.empty()) {
+    c.require(el->entries_.empty() && el->pilots_.empty() &&
+                  el->free_slots_.empty(),
+              "perfect hash map: no shards => no entries");
+    return;
+  }
+
+  auto const& shards = el->shards_;
+  c.require(shards.size() >= 2U, "perfect hash map: shard count");
+  c.require(shards.front().entry_start_ == 0U &&
+                shards.front().bucket_start_ == 0U &&
+                shards.front().free_start_ == 0U,
+            "perfect hash map: first shard start");
+  for (auto i = 1U; i < shards.size(); ++i) {
+    auto const& a = shards[i - 1U];
+    auto const& b = shards[i];
+    c.require(a.entry_start_ <= b.entry_start_,
+              "perfect hash map: shard entry starts monotonic");
+    c.require(a.bucket_start_ < b.bucket_start_,
+              "perfect hash map: shard without buckets");
+
+    auto const shard_size = b.entry_start_ - a.entry_start_;
+    c.require(a.free_start_ <= b.free_start_ &&
+                  b.free_start_ - a.free_start_ ==
+                      Type::table_size(shard_size) - shard_size,
+              "perfect hash map: free slot count");
+    if (b.free_start_ <= el->free_slots_.size()) {
+      c.require(std::all_of(el->free_slots_.begin() + a.free_start_,
+                            el->free_slots_.begin() + b.free_start_,
+                            [&](auto const slot) { return slot < shard_size; }),
+                "perfect hash map: free slot out of shard");
+    }
+  }
+  c.require(shards.back().entry_start_ == el->entries_.size(),
+            "perfect hash map: entry count");
+  c.require(shards.back().bucket_start_ == el->pilots_.size(),
+            "perfect hash map: pilot count");
+  c.require(shards.back().free_start_ == el->free_slots_.size(),
+            "perfect hash map: free slot count");
+}
+
+template <typename Ctx, typename K, typename V,
+          template <typename> typename Vec, typename Hash, typename Eq,
+          typename Fn>
+void recurse(Ctx&, basic_perfect_hash_map<K, V, Vec, Hash, Eq>* el,
+             Fn&& fn) {
+  // The first pass deserializes the members in `convert_endian_and_ptr`
+  // (`check_state` reads them). The deep check revisits them here.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->entries_);
+    fn(&el->shards_);
+    fn(&el->pilots_);
+    fn(&el->free_slots_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
 // --- BITSET<SIZE> ---
 template <typename Ctx, std::size_t Size, typename Fn>
 void recurse(Ctx&, bitset<Size>* el, Fn&& fn) {
   fn(&el->blocks_);
 }
 
+// --- PACKED_VECTOR<T> ---
+template <typename Ctx, typename T, typename Vec, unsigned Bits>
+void convert_endian_and_ptr(Ctx const& c,
+                            basic_packed_vector<T, Vec, Bits>* el) {
+  deserialize(c, &el->blocks_);
+  c.convert_endian(el->size_);
+}
+
+template <typename Ctx, typename T, typename Vec, unsigned Bits>
+void check_state(Ctx const& c, basic_packed_vector<T, Vec, Bits>* el) {
+  using packed_vector_t = basic_packed_vector<T, Vec, Bits>;
+  c.require(el->bits_ <= sizeof(T) * 8U &&
+                (packed_vector_t::is_dynamic || el->bits_ == Bits),
+            "packed_vector width");
+  c.require(el->blocks_.size() ==
+                packed_vector_t::num_blocks(el->size_, el->bits_),
+            "packed_vector size");
+}
+
+template <typename Ctx, typename T, typename Vec, unsigned Bits, typename Fn>
+void recurse(Ctx&, basic_packed_vector<T, Vec, Bits>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->blocks_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- COMPRESSED_INDEX<T> ---
+template <typename Ctx, typename T, template <typename> typename Vec>
+void convert_endian_and_ptr(Ctx const& c, basic_compressed_index<T, Vec>* el) {
+  deserialize(c, &el->anchors_);
+  deserialize(c, &el->frames_);
+  deserialize(c, &el->deltas_);
+  c.convert_endian(el->size_);
+}
+
+template <typename Ctx, typename T, template <typename> typename Vec>
+void check_state(Ctx const& c, basic_compressed_index<T, Vec>* el) {
+  using index_t = basic_compressed_index<T, Vec>;
+  auto const n = std::uint64_t{el->size_};
+  auto const blocks = (n + index_t::block_size - 1U) / index_t::block_size;
+  c.require(el->anchors_.size() == blocks && el->frames_.size() == blocks,
+            "compressed_index blocks");
+  for (auto b = std::uint64_t{0U}; b != blocks; ++b) {
+    auto const frame = el->frames_[static_cast<typename index_t::size_type>(b)];
+    auto const width = index_t::frame_width(frame);
+    auto const count = std::min(std::uint64_t{index_t::block_size},
+                                n - b * index_t::block_size);
+    c.require(width <= sizeof(T) * 8U, "compressed_index width");
+    c.require(index_t::frame_offset(frame) <= (std::uint64_t{1U} << 50U) &&
+                  index_t::num_words(index_t::frame_offset(frame) +
+                                     count * width) <= el->deltas_.size(),
+              "compressed_index frame");
+  }
+}
+
+template <typename Ctx, typename T, template <typename> typename Vec,
+          typename Fn>
+void recurse(Ctx&, basic_compressed_index<T, Vec>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->anchors_);
+    fn(&el->frames_);
+    fn(&el->deltas_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- RANK_SELECT ---
+template <typename Ctx, template <typename> typename Vec>
+void convert_endian_and_ptr(Ctx const& c, basic_rank_select<Vec>* el) {
+  deserialize(c, &el->l0_);
+  deserialize(c, &el->l1_);
+  deserialize(c, &el->select1_);
+  deserialize(c, &el->select0_);
+  c.convert_endian(el->size_);
+  c.convert_endian(el->ones_);
+}
+
+template <typename Ctx, template <typename> typename Vec>
+void check_state(Ctx const& c, basic_rank_select<Vec>* el) {
+  using rs_t = basic_rank_select<Vec>;
+  auto const blocks = (el->size_ + rs_t::block_bits - 1U) / rs_t::block_bits;
+  auto const regions = (el->size_ + rs_t::region_bits - 1U) / rs_t::region_bits;
+  auto const samples = [](std::uint64_t const n) {
+    return (n + rs_t::sample_rate - 1U) / rs_t::sample_rate;
+  };
+  c.require(el->ones_ <= el->size_ && el->l1_.size() == blocks &&
+                el->l0_.size() == regions &&
+                el->select1_.size() == samples(el->ones_) &&
+                el->select0_.size() == samples(el->size_ - el->ones_),
+            "rank_select size");
+  c.require(std::all_of(el->select1_.begin(), el->select1_.end(),
+                        [&](auto const b) { return b < blocks; }) &&
+                std::all_of(el->select0_.begin(), el->select0_.end(),
+                            [&](auto const b) { return b < blocks; }),
+            "rank_select samples");
+
+  // Counts: every block holds at most `block_bits` ones, at least as many
+  // as its first three sub-blocks, and the block ranks add up to `ones_`.
+  auto const blocks_per_region = rs_t::region_bits / rs_t::block_bits;
+  for (auto b = std::uint64_t{0U}; b != blocks; ++b) {
+    auto const entry =
+        el->l1_[static_cast<typename Vec<std::uint64_t>::size_type>(b)];
+    auto sub_blocks = std::uint64_t{0U};
+    for (auto s = 0U; s != 3U; ++s) {
+      auto const ones = (entry >> (32U + 10U * s)) & 0x3FFU;
+      c.require(ones <= rs_t::sub_block_bits, "rank_select sub-block count");
+      sub_blocks += ones;
+    }
+    c.require(b % blocks_per_region != 0U || (entry & 0xFFFFFFFFU) == 0U,
+              "rank_select region start");
+    auto const rank = el->block_rank1(b);
+    auto const next = b + 1U == blocks ? el->ones_ : el->block_rank1(b + 1U);
+    auto const bits =
+        std::min(rs_t::block_bits, el->size_ - b * rs_t::block_bits);
+    c.require(rank <= next && next - rank <= bits &&
+                  sub_blocks <= next - rank,
+              "rank_select block count");
+  }
+}
+
+template <typename Ctx, template <typename> typename Vec, typename Fn>
+void recurse(Ctx&, basic_rank_select<Vec>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->l0_);
+    fn(&el->l1_);
+    fn(&el->select1_);
+    fn(&el->select0_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- ROARING ---
+template <typename Ctx, template <typename> typename Vec>
+void convert_endian_and_ptr(Ctx const& c, basic_roaring<Vec>* el) {
+  deserialize(c, &el->containers_);
+  deserialize(c, &el->values_);
+  deserialize(c, &el->bitmaps_);
+  c.convert_endian(el->cardinality_);
+}
+
+template <typename Ctx, template <typename> typename Vec>
+void check_state(Ctx const& c, basic_roaring<Vec>* el) {
+  using roaring_t = basic_roaring<Vec>;
+  using type_t = typename roaring_t::container_type;
+  auto cardinality = std::uint64_t{0U};
+  for (auto i = 0U; i != el->containers_.size(); ++i) {
+    auto const& x = el->containers_[i];
+    auto const end = std::uint64_t{x.offset_} + x.size_;
+    c.require(i == 0U || el->containers_[i - 1U].key_ < x.key_,
+              "roaring keys");
+    switch (x.type_) {
+      case type_t::ARRAY: {
+        c.require(x.size_ != 0U && x.size_ == x.cardinality_ &&
+                      x.size_ <= roaring_t::max_array_size &&
+                      end <= el->values_.size(),
+                  "roaring array");
+        auto const values = el->values_.data() + x.offset_;
+        for (auto j = 1U; j < x.size_; ++j) {
+          c.require(values[j - 1U] < values[j], "roaring array order");
+        }
+        break;
+      }
+      case type_t::BITMAP:
+        c.require(x.size_ == roaring_t::bitmap_words &&
+                      end <= el->bitmaps_.size(),
+                  "roaring bitmap");
+        c.require(x.cardinality_ != 0U &&
+                      words_count(el->bitmaps_.data() + x.offset_,
+                                  roaring_t::bitmap_words) ==
+                          x.cardinality_,
+                  "roaring bitmap cardinality");
+        break;
+      case type_t::RUN: {
+        c.require(x.size_ != 0U && x.size_ % 2U == 0U &&
+                      end <= el->values_.size(),
+                  "roaring run");
+        // Runs (start, length - 1): within 16 bits, ascending and not
+        // overlapping, lengths sum up to the cardinality.
+        auto const values = el->values_.data() + x.offset_;
+        auto run_cardinality = std::uint64_t{0U};
+        for (auto j = 0U; j != x.size_; j += 2U) {
+          auto const last = std::uint32_t{values[j]} + values[j + 1U];
+          c.require(last <= 0xFFFFU &&
+                        (j == 0U || std::uint32_t{values[j - 2U]} +
+                                            values[j - 1U] <
+                                        values[j]),
+                    "roaring run order");
+          run_cardinality += values[j + 1U] + 1U;
+        }
+        c.require(run_cardinality == x.cardinality_, "roaring run cardinality");
+        break;
+      }
+      default: c.require(false, "roaring container type");
+    }
+    cardinality += x.cardinality_;
+  }
+  c.require(cardinality == el->cardinality_, "roaring cardinality");
+}
+
+template <typename Ctx, template <typename> typename Vec, typename Fn>
+void recurse(Ctx&, basic_roaring<Vec>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->containers_);
+    fn(&el->values_);
+    fn(&el->bitmaps_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- BLOOM_FILTER ---
+template <typename Ctx, template <typename> typename Vec>
+void convert_endian_and_ptr(Ctx const& c, basic_bloom_filter<Vec>* el) {
+  deserialize(c, &el->words_);
+}
+
+template <typename Ctx, template <typename> typename Vec>
+void check_state(Ctx const& c, basic_bloom_filter<Vec>* el) {
+  using filter_t = basic_bloom_filter<Vec>;
+  c.require(el->words_.size() % filter_t::block_words == 0U &&
+                el->num_blocks() <= std::numeric_limits<std::uint32_t>::max(),
+            "bloom filter size");
+}
+
+template <typename Ctx, template <typename> typename Vec, typename Fn>
+void recurse(Ctx&, basic_bloom_filter<Vec>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->words_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- XOR_FILTER ---
+template <typename Ctx, template <typename> typename Vec>
+void convert_endian_and_ptr(Ctx const& c, basic_xor_filter<Vec>* el) {
+  deserialize(c, &el->fingerprints_);
+  c.convert_endian(el->block_length_);
+  c.convert_endian(el->seed_);
+}
+
+template <typename Ctx, template <typename> typename Vec>
+void check_state(Ctx const& c, basic_xor_filter<Vec>* el) {
+  auto const size = 3U * std::uint64_t{el->block_length_};
+  c.require(el->fingerprints_.empty() || el->fingerprints_.size() == size,
+            "xor filter size");
+}
+
+template <typename Ctx, template <typename> typename Vec, typename Fn>
+void recurse(Ctx&, basic_xor_filter<Vec>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->fingerprints_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- BTREE ---
+template <typename Ctx, typename T, typename GetKey,
+          template <typename> typename Vec, typename Less>
+void convert_endian_and_ptr(Ctx const& c,
+                            basic_btree<T, GetKey, Vec, Less>* el) {
+  deserialize(c, &el->inner_);
+  deserialize(c, &el->leaves_);
+  c.convert_endian(el->root_);
+  c.convert_endian(el->height_);
+  c.convert_endian(el->size_);
+  c.convert_endian(el->free_leaves_);
+  c.convert_endian(el->free_inner_);
+}
+
+template <typename Ctx, typename T, typename GetKey,
+          template <typename> typename Vec, typename Less>
+void check_state(Ctx const& c, basic_btree<T, GetKey, Vec, Less>* el) {
+  using tree_t = basic_btree<T, GetKey, Vec, Less>;
+  using key_t = typename tree_t::key_type;
+  using size_type = typename tree_t::size_type;
+
+  if (el->leaves_.empty()) {
+    c.require(el->inner_.empty() && el->root_ == 0U && el->height_ == 0U &&
+                  el->size_ == 0U && el->free_leaves_ == tree_t::invalid &&
+                  el->free_inner_ == tree_t::invalid,
+              "btree: no leaves => empty");
+    return;
+  }
+
+  c.require(el->inner_.size() < tree_t::invalid &&
+                el->leaves_.size() < tree_t::invalid,
+            "btree: node count");
+  c.require(el->height_ < tree_t::max_height, "btree: height");
+  c.require(el->root_ < (el->height_ == 0U ? el->leaves_.size()
+                                           : el->inner_.size()),
+            "btree: root");
+
+  // Depth first traversal in key order. Every node has to be reached only
+  // once at its level, keys have to be within the separators of the parent
+  // and leaves have to be chained in traversal order starting at leaf 0.
+  struct frame {
+    size_type node_, height_;
+    key_t const *lo_, *hi_;
+  };
+  auto const in_bounds = [](frame const& f, key_t const& k) {
+    return (f.lo_ == nullptr || !Less{}(k, *f.lo_)) &&
+           (f.hi_ == nullptr || Less{}(k, *f.hi_));
+  };
+  auto inner_seen = std::vector<bool>(el->inner_.size());
+  auto leaf_seen = std::vector<bool>(el->leaves_.size());
+  auto stack = std::vector<frame>{{el->root_, el->height_, nullptr, nullptr}};
+  auto prev_leaf = tree_t::invalid;
+  auto size = std::uint64_t{0U};
+  while (!stack.empty()) {
+    auto const f = stack.back();
+    stack.pop_back();
+
+    if (f.height_ != 0U) {
+      c.require(f.node_ < el->inner_.size() && !inner_seen[f.node_],
+                "btree: inner node index");
+      inner_seen[f.node_] = true;
+      auto const& n = el->inner_[f.node_];
+      c.require(n.size_ <= tree_t::inner_keys, "btree: inner node size");
+      for (auto i = size_type{0U}; i != n.size_; ++i) {
+        c.require(in_bounds(f, n.keys_[i]) &&
+                      (i == 0U || Less{}(n.keys_[i - 1U], n.keys_[i])),
+                  "btree: inner node keys");
+      }
+      for (auto i = n.size_ + 1U; i != 0U; --i) {
+        stack.push_back({n.children_[i - 1U], f.height_ - 1U,
+                         i == 1U ? f.lo_ : &n.keys_[i - 2U],
+                         i == n.size_ + 1U ? f.hi_ : &n.keys_[i - 1U]});
+      }
+    } else {
+      c.require(f.node_ < el->leaves_.size() && !leaf_seen[f.node_],
+                "btree: leaf index");
+      leaf_seen[f.node_] = true;
+      c.require(prev_leaf == tree_t::invalid
+                    ? f.node_ == 0U
+                    : el->leaves_[prev_leaf].next_ == f.node_,
+                "btree: leaf chain");
+      auto const& l = el->leaves_[f.node_];
+      c.require(l.size_ <= tree_t::leaf_entries, "btree: leaf size");
+      for (auto i = size_type{0U}; i != l.size_; ++i) {
+        auto const& k = GetKey{}(l.entries_[i]);
+        c.require(in_bounds(f, k) &&
+                      (i == 0U || Less{}(GetKey{}(l.entries_[i - 1U]), k)),
+                  "btree: leaf keys");
+      }
+      size += l.size_;
+      prev_leaf = f.node_;
+    }
+  }
+  c.require(el->leaves_[prev_leaf].next_ == tree_t::invalid,
+            "btree: leaf chain end");
+  c.require(size == el->size_, "btree: size");
+
+  // Free lists: only nodes not in the tree, each at most once.
+  for (auto l = el->free_leaves_; l != tree_t::invalid;
+       l = el->leaves_[l].next_) {
+    c.require(l < el->leaves_.size() && !leaf_seen[l], "btree: free leaves");
+    leaf_seen[l] = true;
+  }
+  for (auto n = el->free_inner_; n != tree_t::invalid;
+       n = el->inner_[n].children_[0U]) {
+    c.require(n < el->inner_.size() && !inner_seen[n], "btree: free inner");
+    inner_seen[n] = true;
+  }
+}
+
+template <typename Ctx, typename T, typename GetKey,
+          template <typename> typename Vec, typename Less, typename Fn>
+void recurse(Ctx&, basic_btree<T, GetKey, Vec, Less>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->inner_);
+    fn(&el->leaves_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
+// --- STATIC_SEARCH_VECTOR<T> ---
+template <typename Ctx, typename T, template <typename> typename Vec>
+void convert_endian_and_ptr(Ctx const& c,
+                            basic_static_search_vector<T, Vec>* el) {
+  deserialize(c, &el->layout_);
+  deserialize(c, &el->ranks_);
+}
+
+template <typename Ctx, typename T, template <typename> typename Vec>
+void check_state(Ctx const& c, basic_static_search_vector<T, Vec>* el) {
+  auto const n = el->layout_.size();
+  c.require(el->ranks_.size() == n &&
+                n < std::numeric_limits<std::uint32_t>::max(),
+            "static search vector size");
+  c.require(std::all_of(el->ranks_.begin(), el->ranks_.end(),
+                        [&](auto const r) { return r < n; }),
+            "static search vector rank");
+}
+
+template <typename Ctx, typename T, template <typename> typename Vec,
+          typename Fn>
+void recurse(Ctx&, basic_static_search_vector<T, Vec>* el, Fn&& fn) {
+  // See PERFECT_HASH_MAP: members are deserialized before `check_state`.
+  if constexpr (is_mode_enabled(Ctx::MODE, mode::_PHASE_II)) {
+    fn(&el->layout_);
+    fn(&el->ranks_);
+  } else {
+    CISTA_UNUSED_PARAM(el)
+    CISTA_UNUSED_PARAM(fn)
+  }
+}
+
 // --- ARRAY<T> ---
 template <typename Ctx, typename T, std::size_t Size, typename Fn>
 void recurse(Ctx&, array<T, Size>* el, Fn&& fn) {
@@ -1033,9 +1736,9 @@ void recurse(Ctx&, optional<T>* el, Fn&& fn) {
 }
 
 // --- TUPLE<T...> ---
-template <typename Ctx, typename... T>
-void recurse(Ctx const& c, tuple<T...>* el) {
-  apply([&](auto&&... args) { (deserialize(c, &args), ...); }, *el);
+template <typename Ctx, typename Fn, typename... T>
+void recurse(Ctx&, tuple<T...>* el, Fn&& fn) {
+  ::cista::apply([&](auto&&... args) { (fn(&args), ...); }, *el);
 }
 
 // --- TIMEPOINT ---
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+#include "cista/containers/hash_map.h"
+
+namespace cista {
+
+// Order in which `serialize` places out-of-line blocks (vector / string /
+// hash map / unique_ptr data) behind the root object.
+enum class layout {
+  // Depth first, each block directly followed by its subtree (default).
+  DFS,
+
+  // Level by level: all blocks at depth d before any block at depth d + 1.
+  BFS,
+
+  // All child blocks of a block next to each other, then the subtrees
+  // of these children in order.
+  CHILDREN_ADJACENT,
+
+  // Blocks with the highest count in `layout_policy::profile_` first,
+  // then all others breadth first.
+  HOT_FIRST,
+
+  // Blocks grouped by alignment (largest first) to avoid padding gaps.
+  SIZE_CLASS
+};
+
+// Access counts of blocks, keyed by the in-memory address of the block
+// data (`v.data()`, `s.data()`, `m.entries_`, `p.get()`).
+using access_profile = raw::hash_map<void const*, std::uint64_t>;
+
+struct layout_policy {
+  layout layout_{layout::DFS};
+
+  // Used by HOT_FIRST and to compute `layout_stats::touched_pages_`.
+  access_profile const* profile_{nullptr};
+
+  std::size_t page_size_{4096U};
+};
+
+struct layout_stats {
+  // Number of blocks written (including the root object) and their size.
+  std::size_t blocks_{0U};
+  std::size_t block_bytes_{0U};
+
+  // Bytes lost to alignment gaps between blocks.
+  std::size_t padding_bytes_{0U};
+
+  // Pages spanned by the serialized data.
+  std::size_t pages_{0U};
+
+  // Pages holding at least one profiled block (or any block if there is no
+  // profile): the expected page touches when running the profiled workload
+  // on freshly mmap'd data.
+  std::size_t touched_pages_{0U};
+
+  // Container pointers whose target block starts on a different page.
+  std::size_t page_crossings_{0U};
+};
+
+}  // namespace cista
@@ -116,6 +116,9 @@ constexpr hash_data<NMaxTypes> static_type_hash(
 
   if constexpr (is_pointer_v<Type>) {
     using PointeeType = remove_pointer_t<Type>;
+    if constexpr (is_narrow_ptr_v<Type>) {
+      h = h.combine(hash("offset32"));
+    }
     if constexpr (std::is_same_v<std::remove_const_t<PointeeType>, void>) {
       return h.combine(hash("void*"));
     } else {
@@ -175,6 +178,9 @@ constexpr auto static_type_hash(
     basic_vector<T, Ptr, Indexed, TemplateSizeType> const*,
     hash_data<NMaxTypes> h) noexcept {
   h = h.combine(hash("vector"));
+  if constexpr (is_narrow_ptr_v<Ptr<T>>) {
+    h = h.combine(hash("offset32"));
+  }
   return static_type_hash(null<T>(), h);
 }
 
@@ -190,7 +196,10 @@ template <typename T, template <typename> typename Ptr, typename GetKey,
 constexpr auto static_type_hash(
     hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq> const*,
     hash_data<NMaxTypes> h) noexcept {
-  h = h.combine(hash("hash_storage"));
+  h = h.combine(hash("hash_storage_v2"));
+  if constexpr (is_narrow_ptr_v<Ptr<T>>) {
+    h = h.combine(hash("offset32"));
+  }
   return static_type_hash(null<T>(), h);
 }
 
@@ -213,19 +222,22 @@ constexpr auto static_type_hash(tuple<T...> const*,
 template <typename Ptr, std::size_t NMaxTypes>
 constexpr auto static_type_hash(generic_string<Ptr> const*,
                                 hash_data<NMaxTypes> h) noexcept {
-  return h.combine(hash("string"));
+  h = h.combine(hash("string"));
+  return is_narrow_ptr_v<Ptr> ? h.combine(hash("offset32")) : h;
 }
 
 template <typename Ptr, std::size_t NMaxTypes>
 constexpr auto static_type_hash(basic_string<Ptr> const*,
                                 hash_data<NMaxTypes> h) noexcept {
-  return h.combine(hash("string"));
+  h = h.combine(hash("string"));
+  return is_narrow_ptr_v<Ptr> ? h.combine(hash("offset32")) : h;
 }
 
 template <typename Ptr, std::size_t NMaxTypes>
 constexpr auto static_type_hash(basic_string_view<Ptr> const*,
                                 hash_data<NMaxTypes> h) noexcept {
-  return h.combine(hash("string"));
+  h = h.combine(hash("string"));
+  return is_narrow_ptr_v<Ptr> ? h.combine(hash("offset32")) : h;
 }
 
 template <typename T, std::size_t NMaxTypes>
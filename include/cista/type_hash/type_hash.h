@@ -60,6 +60,9 @@ hash_t type_hash(T const& el, hash_t h,
 
   if constexpr (is_pointer_v<Type>) {
     using PointeeType = remove_pointer_t<Type>;
+    if constexpr (is_narrow_ptr_v<Type>) {
+      h = hash_combine(h, hash("offset32"));
+    }
     if constexpr (std::is_same_v<PointeeType, void>) {
       return hash_combine(h, hash("void*"));
     } else {
@@ -93,6 +96,9 @@ template <typename T, template <typename> typename Ptr, bool Indexed,
 hash_t type_hash(basic_vector<T, Ptr, Indexed, TemplateSizeType> const&,
                  hash_t h, std::map<hash_t, unsigned>& done) noexcept {
   h = hash_combine(h, hash("vector"));
+  if constexpr (is_narrow_ptr_v<Ptr<T>>) {
+    h = hash_combine(h, hash("offset32"));
+  }
   return type_hash(T{}, h, done);
 }
 
@@ -107,7 +113,10 @@ template <typename T, template <typename> typename Ptr, typename GetKey,
           typename GetValue, typename Hash, typename Eq>
 hash_t type_hash(hash_storage<T, Ptr, GetKey, GetValue, Hash, Eq> const&,
                  hash_t h, std::map<hash_t, unsigned>& done) noexcept {
-  h = hash_combine(h, hash("hash_storage"));
+  h = hash_combine(h, hash("hash_storage_v2"));
+  if constexpr (is_narrow_ptr_v<Ptr<T>>) {
+    h = hash_combine(h, hash("offset32"));
+  }
   return type_hash(T{}, h, done);
 }
 
@@ -130,19 +139,22 @@ hash_t type_hash(tuple<T...> const&, hash_t h,
 template <typename Ptr>
 hash_t type_hash(generic_string<Ptr> const&, hash_t h,
                  std::map<hash_t, unsigned>&) noexcept {
-  return hash_combine(h, hash("string"));
+  h = hash_combine(h, hash("string"));
+  return is_narrow_ptr_v<Ptr> ? hash_combine(h, hash("offset32")) : h;
 }
 
 template <typename Ptr>
 hash_t type_hash(basic_string<Ptr> const&, hash_t h,
                  std::map<hash_t, unsigned>&) noexcept {
-  return hash_combine(h, hash("string"));
+  h = hash_combine(h, hash("string"));
+  return is_narrow_ptr_v<Ptr> ? hash_combine(h, hash("offset32")) : h;
 }
 
 template <typename Ptr>
 hash_t type_hash(basic_string_view<Ptr> const&, hash_t h,
                  std::map<hash_t, unsigned>&) noexcept {
-  return hash_combine(h, hash("string"));
+  h = hash_combine(h, hash("string"));
+  return is_narrow_ptr_v<Ptr> ? hash_combine(h, hash("offset32")) : h;
 }
 
 template <typename T>
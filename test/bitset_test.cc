@@ -112,4 +112,34 @@ TEST_CASE("serialize") {
 
   auto const& deserialized = *cista::unchecked_deserialize<bitfield, mode>(buf);
   CHECK(deserialized == bitfield{std::string_view(s)});
-}
\ No newline at end of file
+}
+
+TEST_CASE("bitset word operations") {
+  constexpr auto const size = 300U;
+
+  auto a = cista::bitset<size>{};
+  auto b = cista::bitset<size>{};
+  auto ref_a = std::bitset<size>{};
+  auto ref_b = std::bitset<size>{};
+  for (auto i = 0U; i != size; ++i) {
+    a.set(i, i % 3U == 0U);
+    ref_a.set(i, i % 3U == 0U);
+    b.set(i, i % 7U == 0U);
+    ref_b.set(i, i % 7U == 0U);
+  }
+
+  CHECK(a.and_count(b) == (ref_a & ref_b).count());
+  CHECK(a.any_intersection(b));
+  CHECK((~a).count() == (~ref_a).count());
+  CHECK((~a).and_count(~b) == (~ref_a & ~ref_b).count());
+
+  a.andnot_inplace(b);
+  ref_a &= ~ref_b;
+  CHECK(a.to_string() == ref_a.to_string());
+  CHECK(!a.any_intersection(b));
+
+  auto set_bits = std::string(size, '0');
+  a.for_each_set_bit(
+      [&](std::size_t const i) { set_bits[size - i - 1U] = '1'; });
+  CHECK(set_bits == ref_a.to_string());
+}
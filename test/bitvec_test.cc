@@ -87,3 +87,46 @@ TEST_CASE("bitvec less than") {
   auto const uut_lt = bitvec_lt(uut1, uut2);
   CHECK(ref_lt == uut_lt);
 }
+
+TEST_CASE("bitvec word operations") {
+  auto a = cista::raw::bitvec{};
+  auto b = cista::raw::bitvec{};
+  CHECK(a.count() == 0U);
+  CHECK(a.and_count(b) == 0U);
+  CHECK(!a.any_intersection(b));
+
+  constexpr auto const n = 1000U;  // some full AVX2 vectors + remainder
+  a.resize(n);
+  b.resize(n);
+  auto ref_a = std::vector<bool>(n);
+  auto ref_b = std::vector<bool>(n);
+  for (auto i = 0U; i != n; ++i) {
+    a.set(i, ref_a[i] = (i % 3U == 0U));
+    b.set(i, ref_b[i] = (i % 7U == 0U || i > 990U));
+  }
+
+  auto both = 0U;
+  auto a_only = std::vector<unsigned>{};
+  for (auto i = 0U; i != n; ++i) {
+    both += (ref_a[i] && ref_b[i]) ? 1U : 0U;
+    if (ref_a[i] && !ref_b[i]) {
+      a_only.push_back(i);
+    }
+  }
+
+  CHECK(a.count() == 334U);
+  CHECK(a.and_count(b) == both);
+  CHECK(a.any_intersection(b));
+
+  auto bits = std::vector<unsigned>{};
+  auto c = a;
+  c.andnot_inplace(b);
+  c.for_each_set_bit([&](unsigned const i) { bits.push_back(i); });
+  CHECK(bits == a_only);
+  CHECK(!c.any_intersection(b));
+  CHECK(c.and_count(b) == 0U);
+
+  auto const inv = ~a;  // bits behind size() are set but not counted
+  CHECK(inv.count() == n - 334U);
+  CHECK(inv.and_count(inv) == n - 334U);
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/btree.h"
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+template <typename Tree, typename Map>
+bool equal(Tree const& t, Map const& m) {
+  return t.size() == m.size() &&
+         std::equal(begin(t), end(t), begin(m), end(m), [](auto&& a, auto&& b) {
+           return a.first == b.first && a.second == b.second;
+         });
+}
+
+}  // namespace
+
+TEST_CASE("btree map insert erase find") {
+  auto t = data::btree_map<std::uint32_t, std::uint64_t>{};
+  auto ref = std::map<std::uint32_t, std::uint64_t>{};
+  auto gen = std::mt19937{7U};
+  auto dist = std::uniform_int_distribution<std::uint32_t>{0U, 20'000U};
+
+  CHECK(t.empty());
+  CHECK(t.begin() == t.end());
+  CHECK(t.find(1U) == t.end());
+
+  for (auto i = 0U; i != 50'000U; ++i) {
+    auto const k = dist(gen);
+    if (i % 3U == 2U) {
+      CHECK(t.erase(k) == ref.erase(k));
+    } else {
+      auto const [it, inserted] = t.emplace(k, std::uint64_t{i});
+      auto const ref_inserted = ref.emplace(k, i).second;
+      CHECK(inserted == ref_inserted);
+      CHECK(it->first == k);
+    }
+  }
+  CHECK(t.height() > 1U);
+  CHECK(equal(t, ref));
+
+  for (auto k = 0U; k != 20'010U; ++k) {
+    auto const it = t.lower_bound(k);
+    auto const ref_it = ref.lower_bound(k);
+    CHECK((it == t.end()) == (ref_it == ref.end()));
+    if (ref_it != ref.end()) {
+      CHECK(it->first == ref_it->first);
+    }
+    CHECK(t.contains(k) == (ref.count(k) == 1U));
+  }
+
+  t[3U] = 99U;
+  ref[3U] = 99U;
+  CHECK(t.at(3U) == 99U);
+  CHECK_THROWS(t.at(20'001U));
+  CHECK(equal(t, ref));
+}
+
+TEST_CASE("btree map bulk load range") {
+  auto entries = std::vector<cista::pair<std::uint64_t, std::uint32_t>>{};
+  for (auto i = 0U; i != 10'000U; ++i) {
+    entries.push_back({std::uint64_t{i} * 2U, i});
+  }
+
+  auto t = data::btree_map<std::uint64_t, std::uint32_t>{};
+  t.bulk_load(begin(entries), end(entries));
+  CHECK(t.size() == entries.size());
+  CHECK(std::equal(begin(t), end(t), begin(entries), end(entries)));
+
+  auto const [from, to] = t.range(101U, 201U);
+  auto n = 0U;
+  for (auto it = from; it != to; ++it, ++n) {
+    CHECK(it->first == 102U + 2U * n);
+  }
+  CHECK(n == 50U);
+  CHECK(t.upper_bound(100U)->first == 102U);
+  CHECK(t.upper_bound(19'998U) == t.end());
+
+  // Inserting after bulk loading splits the nodes.
+  t.emplace(std::uint64_t{1U}, 1U);
+  t.emplace(std::uint64_t{100'000U}, 2U);
+  CHECK(t.size() == entries.size() + 2U);
+  CHECK(std::is_sorted(begin(t), end(t), [](auto&& a, auto&& b) {
+    return a.first < b.first;
+  }));
+
+  entries.push_back(entries.front());
+  CHECK_THROWS(t.bulk_load(begin(entries), end(entries)));
+}
+
+TEST_CASE("btree const keys") {
+  auto t = data::btree_map<std::uint32_t, std::uint32_t>{};
+  t.emplace(1U, 2U);
+  auto const it = t.begin();
+  static_assert(!std::is_assignable_v<decltype((it->first)), std::uint32_t>);
+  static_assert(!std::is_assignable_v<decltype(((*it).first)), std::uint32_t>);
+  it->second = 3U;
+  ++(*it).second;
+  CHECK(t.at(1U) == 4U);
+  CHECK(*it == cista::pair<std::uint32_t, std::uint32_t>{1U, 4U});
+
+  auto s = data::btree_set<std::uint32_t>{};
+  s.emplace(1U);
+  static_assert(std::is_same_v<decltype(*s.begin()), std::uint32_t const&>);
+}
+
+TEST_CASE("btree erase unlinks empty leaves") {
+  using map_t = data::btree_map<std::uint32_t, std::uint32_t>;
+
+  auto const num_leaves = [](map_t const& t) {
+    auto n = 0U;
+    for (auto l = t.leaves_.empty() ? map_t::invalid : 0U; l != map_t::invalid;
+         l = t.leaves_[l].next_) {
+      CHECK(t.leaves_[l].size_ != 0U);
+      ++n;
+    }
+    return n;
+  };
+  auto const valid = [](map_t const& t) {
+    auto const buf = cista::serialize(t);
+    return cista::deserialize<map_t>(buf)->size() == t.size();
+  };
+
+  auto t = map_t{};
+  auto ref = std::map<std::uint32_t, std::uint32_t>{};
+  for (auto i = 0U; i != 20'000U; ++i) {
+    t.emplace(i, i);
+    ref.emplace(i, i);
+  }
+  auto const leaves = t.leaves_.size();
+  auto const inner = t.inner_.size();
+
+  // Erase ranges at the front (first leaf), the back and in the middle.
+  for (auto const& [from, to] :
+       {std::pair{0U, 3'000U}, std::pair{17'000U, 20'000U},
+        std::pair{5'000U, 15'000U}}) {
+    for (auto k = from; k != to; ++k) {
+      CHECK(t.erase(k) == 1U);
+      ref.erase(k);
+    }
+    CHECK(equal(t, ref));
+    CHECK(valid(t));
+  }
+  CHECK(num_leaves(t) < leaves / 3U);
+
+  // Freed nodes are reused.
+  for (auto k = 0U; k != 20'000U; ++k) {
+    t.emplace(k, k);
+    ref.emplace(k, k);
+  }
+  CHECK(equal(t, ref));
+  CHECK(valid(t));
+  CHECK(t.leaves_.size() <= leaves + 1U);
+  CHECK(t.inner_.size() <= inner + 1U);
+
+  // Erasing everything from the front shrinks the tree to a single leaf.
+  for (auto k = 0U; k != 19'999U; ++k) {
+    t.erase(k);
+  }
+  CHECK(t.height() == 0U);
+  CHECK(num_leaves(t) == 1U);
+  CHECK(t.begin()->first == 19'999U);
+  CHECK(valid(t));
+  t.erase(19'999U);
+  CHECK(t.empty());
+  CHECK(t.leaves_.empty());
+
+  SUBCASE("free list cycle") {
+    for (auto i = 0U; i != 1000U; ++i) {
+      t.emplace(i, i);
+    }
+    for (auto i = 100U; i != 900U; ++i) {
+      t.erase(i);
+    }
+    auto buf = cista::serialize(t);
+    auto const d = cista::deserialize<map_t>(buf);
+    REQUIRE(d->free_leaves_ != map_t::invalid);
+    d->leaves_[d->free_leaves_].next_ = d->free_leaves_;
+    CHECK_THROWS(cista::deserialize<map_t>(buf));
+  }
+}
+
+TEST_CASE("btree set strings") {
+  auto t = data::btree_set<data::string>{};
+  auto ref = std::set<std::string>{};
+  for (auto i = 0U; i != 2000U; ++i) {
+    auto const s = std::to_string(i * 7919U % 3001U);
+    t.emplace(s);
+    ref.emplace(s);
+  }
+  CHECK(t.size() == ref.size());
+  CHECK(std::equal(begin(t), end(t), begin(ref), end(ref),
+                   [](auto&& a, auto&& b) { return a.view() == b; }));
+  CHECK(t.contains(data::string{"42"}));
+  CHECK(!t.contains(data::string{"x"}));
+}
+
+TEST_CASE("btree serialization") {
+  using map_t = data::btree_map<std::uint32_t, data::string>;
+
+  auto t = map_t{};
+  for (auto i = 0U; i != 5000U; ++i) {
+    t.emplace((i * 7919U) % 5000U, data::string{std::to_string(i)});
+  }
+  for (auto i = 0U; i < 5000U; i += 3U) {
+    t.erase(i);
+  }
+
+  auto buf = cista::serialize(t);
+  auto const d = cista::deserialize<map_t>(buf);
+  CHECK(d->size() == t.size());
+  CHECK(std::equal(begin(t), end(t), begin(*d), end(*d)));
+  CHECK(d->find(4U) != d->end());
+  CHECK(d->find(3U) == d->end());
+
+  auto empty = map_t{};
+  auto empty_buf = cista::serialize(empty);
+  CHECK(cista::deserialize<map_t>(empty_buf)->empty());
+
+  SUBCASE("leaf chain") {
+    d->leaves_[0].next_ = 0U;
+    CHECK_THROWS(cista::deserialize<map_t>(buf));
+  }
+
+  SUBCASE("child index") {
+    d->inner_[d->root_].children_[0] = d->root_;
+    CHECK_THROWS(cista::deserialize<map_t>(buf));
+  }
+
+  SUBCASE("key order") {
+    d->leaves_[0].entries_[0].first = 4999U;
+    CHECK_THROWS(cista::deserialize<map_t>(buf));
+  }
+
+  SUBCASE("size") {
+    d->size_ += 1U;
+    CHECK_THROWS(cista::deserialize<map_t>(buf));
+  }
+}
+
+TEST_CASE("btree deep check") {
+  using namespace cista;
+  using namespace cista::offset;
+
+  struct root {
+    vector<indexed<string>> names_;
+    btree_map<int, ptr<string>> index_;
+    vector<std::uint64_t> junk_;
+  };
+
+  byte_buf buf;
+  {
+    auto r = root{};
+    for (auto i = 0; i != 10; ++i) {
+      r.names_.emplace_back(string{"a long name #" + std::to_string(i)});
+    }
+    for (auto i = 0; i != 10; ++i) {
+      r.index_.emplace(i, &r.names_[static_cast<unsigned>(i)]);
+    }
+    r.junk_.resize(8U, ~std::uint64_t{0U});
+    buf = serialize(r);
+  }
+
+  auto const r = deserialize<root, mode::DEEP_CHECK>(buf);
+  CHECK(*r->index_.at(3) == "a long name #3");
+
+  // Pointees are only checked by the deep check (second pass).
+  r->index_.at(3) = reinterpret_cast<string*>(r->junk_.data());
+  CHECK_NOTHROW(deserialize<root>(buf));
+  CHECK_THROWS(deserialize<root, mode::DEEP_CHECK>(buf));
+}
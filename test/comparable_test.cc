@@ -1,4 +1,8 @@
+#include <array>
+#include <cinttypes>
+#include <random>
 #include <string>
+#include <tuple>
 
 #include "doctest.h"
 
@@ -35,3 +39,97 @@ TEST_CASE("comparable") {
   CHECK(inst1 < inst2);
   CHECK(!(inst1 > inst2));
 }
+
+struct comparable_bytes {
+  CISTA_FRIEND_COMPARABLE(comparable_bytes)
+  std::uint8_t a_;
+  std::array<std::uint8_t, 3> b_;
+};
+
+struct comparable_ints {
+  CISTA_COMPARABLE()
+  std::uint32_t a_;
+  std::int32_t b_;
+};
+
+struct comparable_opt_out {
+  CISTA_COMPARABLE()
+  std::uint32_t a_;
+  std::uint32_t b_;
+};
+
+template <>
+struct cista::disable_bytewise_comparison<comparable_opt_out>
+    : std::true_type {};
+
+TEST_CASE("comparable memcmp") {
+  static_assert(cista::is_bytewise_comparable_v<comparable_bytes>);
+  static_assert(cista::is_bytewise_comparable_v<comparable_ints>);
+  static_assert(!cista::is_bytewise_comparable_v<comparable_a>);
+  static_assert(!cista::is_bytewise_comparable_v<comparable_opt_out>);
+
+  auto const a = comparable_bytes{1U, {2U, 3U, 4U}};
+  auto const b = comparable_bytes{1U, {2U, 4U, 0U}};
+  CHECK(a == a);
+  CHECK(a != b);
+  CHECK(a < b);
+  CHECK(a <= b);
+  CHECK(b > a);
+  CHECK(b >= a);
+  CHECK(!(b < a));
+
+  // Signed members: ordering stays member-wise.
+  static_assert(!cista::is_big_endian_orderable_v<comparable_ints>);
+  auto const c = comparable_ints{0x100U, -1};
+  auto const d = comparable_ints{0x001U, 1};
+  CHECK(c == c);
+  CHECK(c != d);
+  CHECK(d < c);
+  CHECK(c > d);
+  CHECK(comparable_ints{1U, -1} < comparable_ints{1U, 1});
+
+  CHECK(comparable_opt_out{1U, 2U} == comparable_opt_out{1U, 2U});
+  CHECK(comparable_opt_out{1U, 2U} < comparable_opt_out{1U, 3U});
+}
+
+enum class comparable_enum : std::uint16_t { A = 1U, B = 0x100U };
+
+struct comparable_unsigned {
+  CISTA_COMPARABLE()
+  std::uint16_t a_;
+  comparable_enum b_;
+  std::uint32_t c_;
+  std::array<std::uint64_t, 2U> d_;
+};
+
+TEST_CASE("comparable big-endian memcmp ordering") {
+  static_assert(cista::is_big_endian_orderable_v<comparable_unsigned>);
+  static_assert(cista::is_big_endian_orderable_v<comparable_bytes>);
+  static_assert(!cista::is_big_endian_orderable_v<comparable_opt_out>);
+
+  // Byte order differs from value order on little-endian hosts.
+  auto const a = comparable_unsigned{1U, comparable_enum::B, 0x1U, {0U, 0U}};
+  auto const b = comparable_unsigned{1U, comparable_enum::A, 0x100U, {0U, 0U}};
+  CHECK(b < a);
+  CHECK(a > b);
+  CHECK(!(a < a));
+
+  auto gen = std::mt19937_64{42U};
+  auto const random = [&]() {
+    auto const v = gen();
+    return comparable_unsigned{
+        static_cast<std::uint16_t>(v & 0x3U),
+        (v & 0x4U) != 0U ? comparable_enum::A : comparable_enum::B,
+        static_cast<std::uint32_t>((v >> 3U) & 0x1FFU),
+        {(v >> 12U) & 0x3U, v >> 14U}};
+  };
+  auto mismatches = 0U;
+  for (auto i = 0U; i != 10'000U; ++i) {
+    auto const x = random();
+    auto const y = random();
+    auto const expected = std::tie(x.a_, x.b_, x.c_, x.d_) <
+                          std::tie(y.a_, y.b_, y.c_, y.d_);
+    mismatches += (x < y) == expected ? 0U : 1U;
+  }
+  CHECK(mismatches == 0U);
+}
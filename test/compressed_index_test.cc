@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/compressed_index.h"
+#include "cista/containers/nvec.h"
+#include "cista/containers/vecvec.h"
+#include "cista/serialization.h"
+#include "cista/strong.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+data::vector<std::uint32_t> make_starts(std::size_t const n) {
+  auto gen = std::mt19937{42U};
+  auto dist = std::geometric_distribution<std::uint32_t>{0.2};
+  auto v = data::vector<std::uint32_t>{};
+  auto x = std::uint32_t{0U};
+  for (auto i = 0U; i != n; ++i) {
+    v.push_back(x);
+    x += i % 500U == 0U ? 100000U : dist(gen);  // occasional large gap
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST_CASE("compressed_index") {
+  auto const ref = make_starts(10000U);
+  auto idx = data::compressed_index<>{};
+  idx.encode(ref);
+
+  REQUIRE(idx.size() == ref.size());
+  CHECK(idx.size_in_bytes() < ref.size() * sizeof(std::uint32_t) / 2U);
+  CHECK(std::equal(begin(idx), end(idx), begin(ref)));
+  CHECK(idx.back() == ref.back());
+
+  for (auto const& [from, n] :
+       {std::pair{0U, 10000U}, std::pair{63U, 2U}, std::pair{130U, 700U}}) {
+    auto out = std::vector<std::uint32_t>(n);
+    idx.decode(from, n, out.data());
+    CHECK(std::equal(begin(out), end(out), begin(ref) + from));
+  }
+
+  auto zeros = data::compressed_index<>{};
+  for (auto i = 0U; i != 100U; ++i) {
+    zeros.push_back(7U);
+  }
+  CHECK(zeros.size_in_bytes() < 64U);
+  CHECK(std::all_of(begin(zeros), end(zeros),
+                    [](std::uint32_t const x) { return x == 7U; }));
+
+  CHECK_THROWS(idx.push_back(0U));
+  CHECK_THROWS(idx.at(10000U));
+}
+
+TEST_CASE("compressed_index vecvec nvec") {
+  using key = cista::strong<std::uint32_t, struct key_>;
+  using vecvec_t = cista::basic_vecvec<key, data::vector<std::uint32_t>,
+                                       data::compressed_index<>>;
+  using nvec_t = cista::basic_nvec<std::uint32_t, data::vector<std::uint32_t>,
+                                   data::compressed_index<>, 2U>;
+
+  auto v = vecvec_t{};
+  auto n = nvec_t{};
+  for (auto i = 0U; i != 1000U; ++i) {
+    auto bucket = std::vector<std::uint32_t>{};
+    for (auto j = 0U; j != i % 5U; ++j) {
+      bucket.push_back(i * j);
+    }
+    v.emplace_back(bucket);
+    n.emplace_back(std::vector<std::vector<std::uint32_t>>{bucket, bucket});
+  }
+
+  constexpr auto const MODE = cista::mode::WITH_INTEGRITY;
+  auto const v_buf = cista::serialize<MODE>(v);
+  auto const n_buf = cista::serialize<MODE>(n);
+  auto const vd = cista::deserialize<vecvec_t, MODE>(v_buf);
+  auto const nd = cista::deserialize<nvec_t, MODE>(n_buf);
+  REQUIRE(vd->size() == 1000U);
+  REQUIRE(nd->size() == 1000U);
+  for (auto i = 0U; i != 1000U; ++i) {
+    auto const b = vd->at(key{i});
+    REQUIRE(b.size() == i % 5U);
+    REQUIRE(nd->size(i, 1U) == i % 5U);
+    for (auto j = 0U; j != i % 5U; ++j) {
+      CHECK(b[j] == i * j);
+      CHECK(nd->at(i, 1U)[j] == i * j);
+    }
+  }
+}
+
+TEST_CASE("compressed_index serialize corrupt") {
+  auto idx = data::compressed_index<>{};
+  idx.encode(make_starts(1000U));
+  auto buf = cista::serialize(idx);
+  CHECK(*cista::deserialize<data::compressed_index<>>(buf) == idx);
+
+  auto const corrupt = [&](auto&& fn) {
+    auto copy = buf;
+    fn(*reinterpret_cast<data::compressed_index<>*>(copy.data()));
+    return copy;
+  };
+  auto const wide = corrupt([](auto& x) { x.frames_[3] |= 0xFFU; });
+  CHECK_THROWS(cista::deserialize<data::compressed_index<>>(wide));
+  auto const size = corrupt([](auto& x) { x.size_ = 2000U; });
+  CHECK_THROWS(cista::deserialize<data::compressed_index<>>(size));
+}
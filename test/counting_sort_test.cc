@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/counting_sort.h"
+#include "cista/containers/mmap_vec.h"
+#include "cista/strong.h"
+#endif
+
+namespace {
+
+using key = cista::strong<std::uint32_t, struct key_>;
+
+std::vector<std::pair<key, std::uint32_t>> make_pairs(std::size_t const n,
+                                                      std::uint32_t const k) {
+  auto gen = std::mt19937{static_cast<std::uint32_t>(n)};
+  auto dist = std::uniform_int_distribution<std::uint32_t>{0U, k - 1U};
+  auto pairs = std::vector<std::pair<key, std::uint32_t>>(n);
+  for (auto i = 0U; i != n; ++i) {
+    pairs[i] = {key{dist(gen)}, i};
+  }
+  return pairs;
+}
+
+template <typename Bucket>
+bool stable(Bucket const& b) {
+  return std::is_sorted(b.begin(), b.end());
+}
+
+}  // namespace
+
+TEST_CASE("counting sort build vecvec") {
+  for (auto const& [n, k] : {std::pair{0U, 10U}, std::pair{100U, 1000U},
+                            std::pair{200'000U, 7U},
+                            std::pair{200'000U, 5'000U}}) {
+    auto const pairs = make_pairs(n, k);
+
+    auto v = cista::raw::vecvec<key, std::uint32_t>{};
+    cista::build_vecvec(v, pairs, k);
+    REQUIRE(v.size() == k);
+    REQUIRE(v.data_.size() == n);
+
+    auto counts = std::vector<std::size_t>(k);
+    for (auto const& [b, x] : pairs) {
+      ++counts[cista::to_idx(b)];
+    }
+    for (auto i = 0U; i != k; ++i) {
+      auto const bucket = v[key{i}];
+      REQUIRE(bucket.size() == counts[i]);
+      CHECK(stable(bucket));
+      CHECK(std::all_of(bucket.begin(), bucket.end(), [&](std::uint32_t x) {
+        return pairs[x].first == key{i};
+      }));
+    }
+
+    auto m = cista::offset::fws_multimap<std::uint32_t, std::uint32_t>{};
+    cista::build_fws_multimap(
+        m, pairs, k, [](auto const& p) { return p.first; },
+        [](auto const& p) { return p.second; });
+    REQUIRE(m.finished());
+    REQUIRE(m.index_size() == k + 1U);
+    for (auto i = 0U; i != k; ++i) {
+      CHECK(m[i].size() == counts[i]);
+      CHECK(std::equal(m[i].begin(), m[i].end(), v[key{i}].begin()));
+    }
+  }
+
+  auto const invalid = make_pairs(100U, 10U);
+  auto v = cista::raw::vecvec<key, std::uint32_t>{};
+  CHECK_THROWS(cista::build_vecvec(v, invalid, 5U));
+}
+
+TEST_CASE("counting sort build mmap vecvec") {
+  struct edge {
+    std::uint32_t from_, to_;
+  };
+  using idx_t = cista::mmap_vec<std::uint32_t>;
+  using data_t = cista::mmap_vec<std::uint32_t>;
+
+  constexpr auto const INPUT = "counting_sort_input.bin";
+  constexpr auto const DATA = "counting_sort_data.bin";
+  constexpr auto const INDEX = "counting_sort_index.bin";
+  for (auto const file : {INPUT, DATA, INDEX}) {
+    std::remove(file);
+  }
+
+  {
+    auto input = cista::mmap_vec<edge>{cista::mmap{INPUT}};
+    for (auto const& [k, x] : make_pairs(100'000U, 1000U)) {
+      input.push_back(edge{cista::to_idx(k), x});
+    }
+
+    auto v = cista::basic_vecvec<key, data_t, idx_t>{
+        data_t{cista::mmap{DATA}}, idx_t{cista::mmap{INDEX}}};
+    cista::build_vecvec(
+        v, input, 1000U, [](edge const& e) { return e.from_; },
+        [](edge const& e) { return e.to_; });
+    REQUIRE(v.size() == 1000U);
+    REQUIRE(v.data_.size() == 100'000U);
+    for (auto i = 0U; i != 1000U; ++i) {
+      auto const bucket = v[key{i}];
+      CHECK(stable(bucket));
+      CHECK(std::all_of(bucket.begin(), bucket.end(), [&](std::uint32_t x) {
+        return input[x].from_ == i;
+      }));
+    }
+  }
+
+  for (auto const file : {INPUT, DATA, INDEX}) {
+    std::remove(file);
+  }
+}
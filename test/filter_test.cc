@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/bloom_filter.h"
+#include "cista/containers/filtered_hash_map.h"
+#include "cista/containers/xor_filter.h"
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+std::vector<std::uint64_t> make_keys(std::size_t const n,
+                                     std::uint32_t const seed) {
+  auto gen = std::mt19937_64{seed};
+  auto keys = std::vector<std::uint64_t>(n);
+  std::generate(begin(keys), end(keys), gen);
+  return keys;
+}
+
+template <typename Filter>
+double false_positive_rate(Filter const& f,
+                           std::vector<std::uint64_t> const& absent) {
+  auto const n = std::count_if(begin(absent), end(absent),
+                               [&](auto const h) { return f.contains(h); });
+  return static_cast<double>(n) / static_cast<double>(absent.size());
+}
+
+template <typename Filter>
+bool contains_all(Filter const& f, std::vector<std::uint64_t> const& keys) {
+  return std::all_of(begin(keys), end(keys),
+                     [&](auto const h) { return f.contains(h); });
+}
+
+auto const identity = [](std::uint64_t const h) { return h; };
+
+}  // namespace
+
+TEST_CASE("bloom filter") {
+  auto const keys = make_keys(100'000U, 1U);
+  auto const absent = make_keys(100'000U, 2U);
+
+  auto f = data::bloom_filter{};
+  CHECK(f.contains(keys[0]));  // not built: no information
+  CHECK_THROWS(f.insert(keys[0]));
+  f.build(begin(keys), end(keys), identity);
+  CHECK(contains_all(f, keys));
+  CHECK(false_positive_rate(f, absent) < 0.02);
+  CHECK(f.size_in_bytes() <= keys.size() * 10U / 8U + 64U);
+
+  auto buf = cista::serialize(f);
+  auto const d = cista::deserialize<data::bloom_filter>(buf);
+  CHECK(contains_all(*d, keys));
+  CHECK(false_positive_rate(*d, absent) == false_positive_rate(f, absent));
+
+  d->words_.used_size_ -= 1U;  // no longer whole blocks
+  CHECK_THROWS(cista::deserialize<data::bloom_filter>(buf));
+
+  auto empty = data::bloom_filter{};
+  empty.build(begin(absent), begin(absent), identity);
+  CHECK(!empty.contains(keys[0]));
+}
+
+TEST_CASE("xor filter") {
+  auto const keys = make_keys(100'000U, 3U);
+  auto const absent = make_keys(100'000U, 4U);
+
+  auto f = data::xor_filter{};
+  CHECK(f.contains(keys[0]));  // not built: no information
+  f.build(begin(keys), end(keys), identity);
+  CHECK(contains_all(f, keys));
+  CHECK(false_positive_rate(f, absent) < 0.01);
+  CHECK(f.size_in_bytes() < keys.size() * 5U / 4U + 32U);
+
+  auto with_duplicates = keys;
+  with_duplicates.insert(end(with_duplicates), begin(keys), begin(keys) + 10);
+  auto g = data::xor_filter{};
+  g.build(begin(with_duplicates), end(with_duplicates), identity);
+  CHECK(contains_all(g, keys));
+
+  auto buf = cista::serialize(f);
+  auto const d = cista::deserialize<data::xor_filter>(buf);
+  CHECK(contains_all(*d, keys));
+
+  d->block_length_ += 1U;
+  CHECK_THROWS(cista::deserialize<data::xor_filter>(buf));
+}
+
+TEST_CASE("filtered hash map") {
+  auto const test = [](auto m) {
+    using map_t = decltype(m);
+    for (auto i = 0U; i != 1000U; ++i) {
+      m.map_.emplace(data::string{std::to_string(i)}, i);
+    }
+    m.build_filter();
+
+    auto const check = [](map_t const& x) {
+      auto hits = 0U;
+      auto false_positives = 0U;
+      for (auto i = 0U; i != 2000U; ++i) {
+        auto const key = std::to_string(i);
+        auto const it = x.find(std::string_view{key});
+        if (i < 1000U) {
+          hits += it != x.end() && it->second == i ? 1U : 0U;
+        } else {
+          false_positives += x.filter_.contains(
+                                 x.map_.compute_hash(std::string_view{key}))
+                                 ? 1U
+                                 : 0U;
+        }
+      }
+      return hits == 1000U && false_positives < 50U && !x.contains("x") &&
+             x.at(data::string{"7"}) == 7U;
+    };
+
+    CHECK(check(m));
+    CHECK_THROWS(m.at(data::string{"1000"}));
+
+    auto buf = cista::serialize(m);
+    CHECK(check(*cista::deserialize<map_t>(buf)));
+  };
+
+  test(data::filtered_hash_map<data::string, std::uint32_t>{});
+  test(data::filtered_hash_map<data::string, std::uint32_t,
+                               data::xor_filter>{});
+}
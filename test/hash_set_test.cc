@@ -1,3 +1,6 @@
+#include <numeric>
+#include <vector>
+
 #define DOCTEST_CONFIG_NO_EXCEPTIONS
 #include "doctest.h"
 
@@ -6,6 +9,7 @@
 #else
 #include "cista/containers/hash_map.h"
 #include "cista/containers/hash_set.h"
+#include "cista/containers/hash_storage_stats.h"
 #include "cista/hash.h"
 #include "cista/serialization.h"
 #endif
@@ -158,6 +162,171 @@ TEST_CASE("serialize hash_set test") {
   CHECK(*deserialized->find(make_e3()) == make_e3());
 }
 
+TEST_CASE("hash_map build test") {
+  using namespace cista;
+  using namespace cista::offset;
+
+  auto entries = std::vector<pair<int, int>>{};
+  for (auto i = 0; i != 100'000; ++i) {
+    entries.push_back(pair<int, int>{(i * 7919) % 50'000, i});
+  }
+
+  using map_t = hash_map<int, int>;
+
+  auto incremental = map_t{};
+  for (auto const& e : entries) {
+    incremental.emplace(e);
+  }
+
+  auto bulk = map_t{};
+  bulk.build(begin(entries), end(entries));
+
+  CHECK(bulk.size() == 50'000U);
+  CHECK(bulk.size() == incremental.size());
+  CHECK(bulk.capacity() == incremental.capacity());
+  CHECK(bulk == incremental);
+  for (auto const& [key, value] : incremental) {
+    CHECK(bulk.at(key) == value);
+  }
+
+  auto const buf = serialize(bulk);
+  auto const deserialized = deserialize<map_t>(buf);
+  CHECK(*deserialized == incremental);
+
+  // Sized once: no rehash after reserve, stored keys keep their values.
+  auto reserved = map_t{};
+  reserved.reserve(50'000U);
+  reserved.emplace(1, -1);
+  auto const capacity = reserved.capacity();
+  auto const entries_ptr = &*reserved.begin();
+  reserved.build(begin(entries), end(entries));
+  CHECK(reserved.size() == 50'000U);
+  CHECK(reserved.capacity() == capacity);
+  CHECK(reserved.find(1) != reserved.end());
+  CHECK(reserved.at(1) == -1);
+  CHECK(reserved.at(2) == incremental.at(2));
+  CHECK(&*reserved.find(1) == entries_ptr);
+}
+
+TEST_CASE("hash_set build unique keys test") {
+  using namespace cista::raw;
+
+  auto keys = std::vector<std::uint64_t>(25'000U);
+  for (auto i = 0U; i != keys.size(); ++i) {
+    keys[i] = i * 31U;
+  }
+
+  auto uut = hash_set<std::uint64_t>{};
+  uut.emplace(std::uint64_t{1U});
+  uut.build(begin(keys), end(keys), true);
+
+  CHECK(uut.size() == keys.size() + 1U);
+  CHECK(uut.find(std::uint64_t{1U}) != uut.end());
+  for (auto const k : keys) {
+    CHECK(uut.find(k) != uut.end());
+  }
+  CHECK(uut.find(std::uint64_t{2U}) == uut.end());
+
+  uut.build(begin(keys), begin(keys));
+  CHECK(uut.size() == keys.size() + 1U);
+}
+
+TEST_CASE("hash_map seed test") {
+  using namespace cista;
+  using namespace cista::offset;
+
+  using map_t = hash_map<int, int>;
+
+  auto uut = map_t{};
+  for (auto i = 0; i != 1'000; ++i) {
+    uut.emplace(i, 2 * i);
+  }
+  auto const unseeded = uut;
+
+  uut.randomize_seed();
+  CHECK(uut.seed() != 0U);
+  CHECK(uut == unseeded);
+
+  uut.set_seed(42U);
+  CHECK(uut.seed() == 42U);
+  CHECK(uut == unseeded);
+  CHECK(uut.find(1'000) == uut.end());
+
+  auto const buf = serialize(uut);
+  auto const deserialized = deserialize<map_t>(buf);
+  CHECK(deserialized->seed() == 42U);
+  CHECK(*deserialized == unseeded);
+  for (auto i = 0; i != 1'000; ++i) {
+    CHECK(deserialized->at(i) == 2 * i);
+  }
+}
+
+TEST_CASE("hash_map stats test") {
+  using namespace cista;
+  using namespace cista::offset;
+
+  using map_t = hash_map<int, int>;
+
+  auto const empty = get_stats(map_t{});
+  CHECK(empty.capacity_ == 0U);
+  CHECK(empty.max_present_probe_length() == 0U);
+  CHECK(empty.max_absent_probe_length() == 1U);
+
+  auto uut = map_t{};
+  for (auto i = 0; i != 1'000; ++i) {
+    uut.emplace(i, i);
+  }
+  for (auto i = 0; i != 100; ++i) {
+    uut.erase(i);
+  }
+
+  auto const buf = serialize(uut);
+  auto const deserialized = deserialize<map_t>(buf);
+  auto const s = get_stats(*deserialized);
+  CHECK(s.size_ == 900U);
+  CHECK(s.capacity_ == uut.capacity());
+  CHECK(s.full_ == 900U);
+  CHECK(s.empty_ + s.deleted_ + s.full_ == s.capacity_);
+  CHECK(s.capacity_log2_ == 11U);
+  CHECK(s.load_factor() > 0.4);
+
+  CHECK(std::accumulate(begin(s.present_probe_), end(s.present_probe_),
+                        std::size_t{0U}) == 900U);
+  CHECK(std::accumulate(begin(s.absent_probe_), end(s.absent_probe_),
+                        std::size_t{0U}) == s.capacity_ + 1U);
+  CHECK(std::accumulate(begin(s.group_occupancy_), end(s.group_occupancy_),
+                        std::size_t{0U}) == (s.capacity_ + 1U) / 8U);
+  CHECK(s.avg_present_probe_length() >= 1.0);
+  CHECK(s.max_present_probe_length() >= 1U);
+  CHECK(s.avg_absent_probe_length() >= 1.0);
+}
+
+#if defined(CISTA_HASH_STORAGE_STATS)
+TEST_CASE("hash_map counters test") {
+  using map_t = cista::offset::hash_map<int, int>;
+
+  auto const& c = map_t::counters();
+  auto const lookups = c.lookups_.load();
+  auto const hits = c.hits_.load();
+  auto const rehashes = c.rehashes_.load();
+
+  auto uut = map_t{};
+  for (auto i = 0; i != 1'000; ++i) {
+    uut.emplace(i, i);
+  }
+  CHECK(c.rehashes_.load() - rehashes == 11U);
+  CHECK(c.lookups_.load() - lookups == 1'000U);
+  CHECK(c.hits_.load() == hits);
+
+  auto const before = c.lookups_.load();
+  CHECK(uut.find(1) != uut.end());
+  CHECK(uut.find(-1) == uut.end());
+  CHECK(c.lookups_.load() - before == 2U);
+  CHECK(c.hits_.load() - hits == 1U);
+  CHECK(c.groups_probed_.load() >= c.lookups_.load() - lookups);
+}
+#endif
+
 #ifndef _MSC_VER  // MSVC compiler bug :/
 TEST_CASE("string view get") {
   using namespace cista::raw;
@@ -1,9 +1,91 @@
+#include <array>
+#include <cinttypes>
+#include <set>
+#include <string>
+
 #include "doctest.h"
 
 #ifdef SINGLE_HEADER
 #include "cista.h"
 #else
+#include "cista/rapidhash.h"
 #include "cista/type_hash/type_name.h"
 #endif
 
-TEST_CASE("type_hash<int>") { CHECK(cista::type_str<int>() == "int"); }
\ No newline at end of file
+TEST_CASE("type_hash<int>") { CHECK(cista::type_str<int>() == "int"); }
+
+TEST_CASE("constexpr rapidhash") {
+  constexpr auto const h = cista::rapidhash("hello world", 11U, 7U);
+  static_assert(h != cista::rapidhash("hello worle", 11U, 7U));
+  static_assert(h != cista::rapidhash("hello world", 11U, 8U));
+
+  auto const s = std::string{"hello world"};
+  CHECK(h == cista::rapidhash(s.data(), s.size(), 7U));
+  CHECK(h == cista::rapidhash(
+                 reinterpret_cast<std::uint8_t const*>(s.data()), s.size(),
+                 7U));
+
+  // All length branches: small, <= 16, <= 48, > 48.
+  auto const text = std::string(200U, 'x');
+  auto hashes = std::set<std::uint64_t>{};
+  for (auto len = std::size_t{0U}; len != text.size(); ++len) {
+    auto const a = cista::rapidhash(text.data(), len);
+    CHECK(hashes.insert(a).second);
+    auto changed = text.substr(0U, len);
+    if (len != 0U) {
+      changed[len / 2U] = 'y';
+      CHECK(a != cista::rapidhash(changed.data(), len));
+    }
+  }
+}
+
+TEST_CASE("rapidhash known answers") {
+  // Reference values of the upstream rapidhash V1 algorithm (default
+  // secret) for input bytes `(i * 7 + 1) & 0xFF`, covering every length
+  // branch: 0, 1-3, 4-16, 17-48, > 48 (one and several 48 byte rounds).
+  struct known_answer {
+    std::uint64_t seed_;
+    std::size_t len_;
+    std::uint64_t hash_;
+  };
+  constexpr auto const default_seed = 0xBDD89AA982704029ULL;
+  constexpr auto const other_seed = 0x0123456789ABCDEFULL;
+  constexpr known_answer const answers[] = {
+      {default_seed, 0U, 0x5A6EF77074EBC84BULL},
+      {default_seed, 1U, 0xE04E965E17DAA8E3ULL},
+      {default_seed, 3U, 0x8C3EF1B32C9B0283ULL},
+      {default_seed, 4U, 0x4F66F8A33D384F14ULL},
+      {default_seed, 7U, 0xCEDC1985E159C459ULL},
+      {default_seed, 16U, 0xD349599EA8B46DE5ULL},
+      {default_seed, 17U, 0x4CF4F880219E7D2CULL},
+      {default_seed, 33U, 0x410CBCA39F50DF5BULL},
+      {default_seed, 48U, 0xC3869DA3C7268B23ULL},
+      {default_seed, 49U, 0x07DC4F5ECAB56807ULL},
+      {default_seed, 96U, 0xF45C96B66B44F99EULL},
+      {default_seed, 113U, 0xF954B1B3F10E82CBULL},
+      {default_seed, 200U, 0x32F1FEB1B0E5087BULL},
+      {0U, 0U, 0x93228A4DE0EEC5A2ULL},
+      {0U, 2U, 0x48C361348BA859D7ULL},
+      {0U, 8U, 0x1C2142CB3E5DEA18ULL},
+      {0U, 32U, 0x4476759B6FD913CEULL},
+      {0U, 49U, 0xD72676FC38D6E4CBULL},
+      {0U, 113U, 0xF826A9846E21DA81ULL},
+      {0U, 200U, 0xE89426C9FAD220D2ULL},
+      {other_seed, 0U, 0x16D3B0A07D2CEA83ULL},
+      {other_seed, 3U, 0xC1A47A1AA922A81AULL},
+      {other_seed, 16U, 0xD8C42DEF211C5123ULL},
+      {other_seed, 17U, 0x9DD5B72DC9D0EE08ULL},
+      {other_seed, 48U, 0x0FA77D985A2C3239ULL},
+      {other_seed, 96U, 0xC48909949D0DF4C2ULL},
+      {other_seed, 200U, 0x6A3C3284D3096C8DULL}};
+
+  auto input = std::array<std::uint8_t, 200U>{};
+  for (auto i = 0U; i != input.size(); ++i) {
+    input[i] = static_cast<std::uint8_t>(i * 7U + 1U);
+  }
+  for (auto const& a : answers) {
+    CHECK_MESSAGE(cista::rapidhash(input.data(), a.len_, a.seed_) == a.hash_,
+                  "len=", a.len_, " seed=", a.seed_);
+  }
+  CHECK(cista::rapidhash(input.data(), 0U) == answers[0].hash_);
+}
@@ -1,6 +1,8 @@
+#include <array>
 #include <queue>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "doctest.h"
 
@@ -48,9 +50,10 @@ struct my_type {
 TEST_CASE("hashing std::string member") {
   my_type k{3, std::string{"4321"}, std::string{"1234"}};
   CHECK(cista::hashing<my_type>{}(k) ==
-        cista::hash(std::string{"1234"},
-                    cista::hash(std::string{"4321"},
-                                cista::hash_combine(cista::BASE_HASH, 3))));
+        cista::hash_bytes(
+            "1234", 4U,
+            cista::hash_bytes("4321", 4U,
+                              cista::hash_combine(cista::BASE_HASH, 3))));
 }
 
 TEST_CASE("hash() override") {
@@ -62,8 +65,8 @@ TEST_CASE("hash() override") {
 TEST_CASE("automatic hash validation") {
   key k{3U, data::string{"1234"}};
   CHECK(cista::hashing<key>{}(k) ==
-        cista::hash(data::string{"1234"},
-                    cista::hash_combine(cista::BASE_HASH, 3U)));
+        cista::hash_bytes("1234", 4U,
+                          cista::hash_combine(cista::BASE_HASH, 3U)));
 }
 
 TEST_CASE("automatic hashing and equality check") {
@@ -101,4 +104,102 @@ TEST_CASE("automatic hashing and equality check") {
     CHECK(k.at(2).i_ == std::stoi(k.at(2).s_.str()));
     CHECK(k.at(0).i_ == v - 3);
   }
-}
\ No newline at end of file
+}
+
+struct bytewise_key {
+  std::int32_t a_;
+  std::uint16_t b_, c_;
+  std::array<std::uint64_t, 2> d_;
+};
+
+struct padded_key {
+  std::uint8_t a_;
+  std::uint64_t b_;
+};
+
+struct float_key {
+  std::uint32_t a_;
+  float b_;
+};
+
+struct pointer_key {
+  std::uint64_t a_;
+  int* b_;
+};
+
+TEST_CASE("bytewise comparable trait") {
+  CHECK(cista::is_bytewise_comparable_v<bytewise_key>);
+  CHECK(cista::is_bytewise_comparable_v<int[4]>);
+  CHECK(!cista::is_bytewise_comparable_v<padded_key>);
+  CHECK(!cista::is_bytewise_comparable_v<float_key>);
+  CHECK(!cista::is_bytewise_comparable_v<pointer_key>);
+  CHECK(!cista::is_bytewise_comparable_v<hash_override>);
+  CHECK(!cista::is_bytewise_comparable_v<key>);
+
+  CHECK(cista::is_contiguous_bytewise_range_v<data::vector<bytewise_key>>);
+  CHECK(cista::is_contiguous_bytewise_range_v<std::vector<int>>);
+  CHECK(!cista::is_contiguous_bytewise_range_v<data::vector<padded_key>>);
+  CHECK(!cista::is_contiguous_bytewise_range_v<std::set<int>>);
+}
+
+TEST_CASE("bytewise hashing") {
+  // Reference: little-endian image built from the member values, the same
+  // on every host.
+  auto bytes = std::vector<std::uint8_t>{};
+  auto const put = [&](std::uint64_t const x, unsigned const size) {
+    for (auto i = 0U; i != size; ++i) {
+      bytes.push_back(static_cast<std::uint8_t>(x >> (8U * i)));
+    }
+  };
+
+  auto const k = bytewise_key{-2, 0x0102U, 0x0304U, {0x05060708090A0B0CU, 5U}};
+  put(static_cast<std::uint32_t>(-2), 4U);
+  put(0x0102U, 2U);
+  put(0x0304U, 2U);
+  put(0x05060708090A0B0CU, 8U);
+  put(5U, 8U);
+  CHECK(cista::hashing<bytewise_key>{}(k) ==
+        cista::hash_bytes(bytes.data(), bytes.size(), cista::BASE_HASH));
+
+  auto image = std::vector<std::uint8_t>(sizeof(k));
+  auto out = image.data();
+  cista::detail::write_little_endian(k, out);
+  CHECK(image == bytes);
+
+  bytes.clear();
+  for (auto const x : {1U, 0x10203U, 0xFFFFFFFFU}) {
+    put(x, 4U);
+  }
+  auto const u = data::vector<std::uint32_t>{1U, 0x10203U, 0xFFFFFFFFU};
+  CHECK(cista::hashing<data::vector<std::uint32_t>>{}(u) ==
+        cista::hash_bytes(bytes.data(), bytes.size(), cista::BASE_HASH));
+
+  auto const v = data::vector<int>{1, 2, 3};
+  auto const std_v = std::vector<int>{1, 2, 3};
+  CHECK(cista::hashing<data::vector<int>>{}(v) ==
+        cista::hashing<std::vector<int>>{}(std_v));
+
+  auto m = data::hash_map<bytewise_key, int>{};
+  for (auto i = 0; i != 100; ++i) {
+    m.emplace(bytewise_key{i, 0U, 1U, {2U, 3U}}, i);
+  }
+  for (auto i = 0; i != 100; ++i) {
+    CHECK(m.at(bytewise_key{i, 0U, 1U, {2U, 3U}}) == i);
+  }
+}
+
+TEST_CASE("bytewise equality") {
+  auto const eq = cista::equal_to<bytewise_key>{};
+  auto const k = bytewise_key{1, 2U, 3U, {4U, 5U}};
+  CHECK(eq(k, bytewise_key{1, 2U, 3U, {4U, 5U}}));
+  CHECK(!eq(k, bytewise_key{1, 2U, 3U, {4U, 6U}}));
+
+  auto const v_eq = cista::equal_to<data::vector<int>>{};
+  CHECK(v_eq(data::vector<int>{1, 2, 3}, std::vector<int>{1, 2, 3}));
+  CHECK(!v_eq(data::vector<int>{1, 2, 3}, std::vector<int>{1, 2}));
+  CHECK(!v_eq(data::vector<int>{1, 2, 3}, std::vector<int>{1, 2, 4}));
+  CHECK(v_eq(data::vector<int>{}, std::vector<int>{}));
+
+  auto const f_eq = cista::equal_to<float_key>{};
+  CHECK(f_eq(float_key{1U, 0.0F}, float_key{1U, -0.0F}));
+}
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/mmap_hash_map.h"
+#include "cista/mmap.h"
+#include "cista/serialization.h"
+#endif
+
+TEST_CASE("mmap hash_map test") {
+  constexpr auto const FILENAME = "mmap_hash_map.bin";
+  constexpr auto const N = 10'000U;
+  using map_t = cista::mmap_hash_map<std::uint32_t, std::uint64_t>;
+
+  std::remove(FILENAME);
+
+  {
+    auto m = map_t{cista::mmap{FILENAME}};
+    CHECK(m.empty());
+    CHECK(m.find(0U) == m.end());
+    for (auto i = 0U; i != N; ++i) {
+      CHECK(m.emplace(i, std::uint64_t{i} * 3U).second);
+    }
+    CHECK(!m.emplace(7U, 0U).second);
+    CHECK(m.erase(8U) == 1U);
+    m[N] = 42U;
+    CHECK(m.size() == N);
+  }
+
+  {
+    auto m = map_t{cista::mmap{FILENAME, cista::mmap::protection::MODIFY}};
+    CHECK(m.size() == N);
+    CHECK(m.find(8U) == m.end());
+    CHECK(m.at(N) == 42U);
+    for (auto i = 0U; i != N; ++i) {
+      if (i != 8U) {
+        CHECK(m.at(i) == std::uint64_t{i} * 3U);
+      }
+    }
+    m.reserve(4U * N);
+    CHECK(m.capacity() >= 4U * N);
+    CHECK(m.at(9U) == 27U);
+  }
+
+  {
+    auto f = cista::mmap{FILENAME, cista::mmap::protection::READ};
+    auto buf = std::vector<std::uint8_t>{f.begin(), f.end()};
+    auto const deserialized =
+        cista::deserialize<cista::offset::hash_map<std::uint32_t,
+                                                   std::uint64_t>>(
+            buf.data() + map_t::STORAGE_START, buf.data() + buf.size());
+    CHECK(deserialized->size() == N);
+    CHECK(deserialized->at(N) == 42U);
+    CHECK(deserialized->at(9U) == 27U);
+  }
+
+  {
+    auto m = map_t{cista::mmap{FILENAME, cista::mmap::protection::MODIFY}};
+    m.clear();
+    CHECK(m.empty());
+    CHECK(m.emplace(1U, 2U).second);
+    CHECK(m.at(1U) == 2U);
+  }
+
+  // Reopening checks the type and the file size.
+  using other_map_t = cista::mmap_hash_map<std::uint64_t, std::uint64_t>;
+  CHECK_THROWS(
+      other_map_t{cista::mmap{FILENAME, cista::mmap::protection::READ}});
+  {
+    auto f = cista::mmap{FILENAME, cista::mmap::protection::MODIFY};
+    f.resize(f.size() + 1U);
+  }
+  CHECK_THROWS(map_t{cista::mmap{FILENAME, cista::mmap::protection::READ}});
+
+  std::remove(FILENAME);
+}
+
+TEST_CASE("mmap hash_set test") {
+  constexpr auto const FILENAME = "mmap_hash_set.bin";
+  std::remove(FILENAME);
+  {
+    auto s = cista::mmap_hash_set<std::uint64_t>{cista::mmap{FILENAME}};
+    for (auto i = 0U; i != 1000U; ++i) {
+      s.insert(i * i);
+    }
+    CHECK(s.size() == 1000U);
+  }
+  {
+    auto s = cista::mmap_hash_set<std::uint64_t>{
+        cista::mmap{FILENAME, cista::mmap::protection::READ}};
+    CHECK(s.contains(999U * 999U));
+    CHECK(!s.contains(2U));
+  }
+  std::remove(FILENAME);
+}
@@ -5,6 +5,7 @@
 #else
 #include "cista/containers/mutable_fws_multimap.h"
 #include "cista/reflection/comparable.h"
+#include "cista/serialization.h"
 #include "cista/verify.h"
 #endif
 
@@ -385,3 +386,54 @@ TEST_CASE("mutable_fws_multimap_test, get_order_loop") {
     CHECK(get_order_loop(1ULL << i) == i);
   }
 }
+
+TEST_CASE("mutable_fws_multimap_test, freeze_thaw_shrink") {
+  using map_t = mutable_fws_multimap<unsigned, int>;
+
+  auto mm = map_t{};
+  for (auto round = 0; round != 20; ++round) {  // interleaved growth
+    for (auto i = 0U; i != 50U; ++i) {
+      for (auto j = 0U; j != i % 4U; ++j) {
+        mm[i].push_back(static_cast<int>(i * 100U) + round);
+      }
+    }
+  }
+  mm[7U].clear();
+  mm.erase(8U);
+
+  auto const check = [&](auto const& m) {
+    REQUIRE(m.size() == 50U);
+    for (auto i = 0U; i != 50U; ++i) {
+      auto const expected = i == 7U || i == 8U ? 0U : 20U * (i % 4U);
+      REQUIRE(m[i].size() == expected);
+      for (auto j = 0U; j != expected; ++j) {
+        CHECK(m[i][j] == static_cast<int>(i * 100U + j / (i % 4U)));
+      }
+    }
+  };
+
+  auto const element_count = mm.element_count();
+  auto const data_size = mm.data_size();
+
+  auto const frozen = mm.freeze();
+  CHECK(frozen.data_.size() == element_count);
+  check(frozen);
+
+  auto const buf = cista::serialize(frozen);
+  auto const loaded = cista::deserialize<map_t::frozen_t>(buf);
+  check(*loaded);
+
+  auto thawed = map_t{};
+  thawed.thaw(*loaded);
+  CHECK(thawed.element_count() == element_count);
+  check(thawed);
+  thawed[3U].push_back(42);
+  CHECK(thawed[3U].back() == 42);
+
+  mm.shrink_to_fit();
+  CHECK(mm.element_count() == element_count);
+  CHECK(mm.data_size() < data_size);
+  check(mm);
+  mm[1U].push_back(1);
+  CHECK(mm[1U].size() == 21U);
+}
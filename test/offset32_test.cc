@@ -0,0 +1,139 @@
+#include <cinttypes>
+#include <limits>
+#include <string>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/arena.h"
+#include "cista/containers/hash_map.h"
+#include "cista/containers/string.h"
+#include "cista/containers/vector.h"
+#include "cista/serialization.h"
+#include "cista/type_hash/static_type_hash.h"
+#include "cista/type_hash/type_hash.h"
+#endif
+
+namespace data32 = cista::offset32;
+
+namespace {
+
+struct node {
+  std::uint32_t id_;
+  data32::vector<std::uint32_t> edges_;
+  data32::string name_;
+};
+
+struct graph {
+  data32::indexed_vector<node> nodes_;
+  data32::hash_map<data32::string, std::uint32_t> index_;
+  data32::ptr<node> root_;
+};
+
+}  // namespace
+
+TEST_CASE("offset32 sizes") {
+  CHECK(sizeof(data32::ptr<int>) == 4U);
+  CHECK(sizeof(data32::vector<int>) < sizeof(cista::offset::vector<int>));
+  CHECK(sizeof(data32::hash_map<int, int>) <
+        sizeof(cista::offset::hash_map<int, int>));
+}
+
+TEST_CASE("offset32 serialize round trip") {
+  constexpr auto const MODE =
+      cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+
+  cista::byte_buf buf;
+  {
+    auto a = cista::arena{};
+    auto& g = a.create<graph>();
+    for (auto i = 0U; i != 100U; ++i) {
+      auto& n = g.nodes_.emplace_back();
+      n.id_ = i;
+      n.name_ = "node with a long name #" + std::to_string(i);
+      for (auto j = 0U; j != i % 7U; ++j) {
+        n.edges_.push_back((i + j) % 100U);
+      }
+    }
+    for (auto const& n : g.nodes_) {
+      g.index_.emplace(n.name_, n.id_);
+    }
+    g.root_ = &g.nodes_[42];
+    CHECK(a.contains(g.nodes_.data()));
+
+    buf = cista::serialize<MODE>(g);
+  }
+
+  auto const g = cista::deserialize<graph, MODE>(buf);
+  REQUIRE(g->nodes_.size() == 100U);
+  CHECK(g->root_->id_ == 42U);
+  CHECK(g->root_ == &g->nodes_[42]);
+  CHECK(g->index_.size() == 100U);
+  for (auto i = 0U; i != 100U; ++i) {
+    auto const& n = g->nodes_[i];
+    CHECK(n.id_ == i);
+    CHECK(n.edges_.size() == i % 7U);
+    CHECK(n.name_.view() ==
+          "node with a long name #" + std::to_string(i));
+    CHECK(g->index_.at(n.name_) == i);
+  }
+}
+
+TEST_CASE("offset32 type hash") {
+  CHECK(cista::type_hash<data32::vector<int>>() !=
+        cista::type_hash<cista::offset::vector<int>>());
+  CHECK(cista::type_hash<data32::string>() !=
+        cista::type_hash<cista::offset::string>());
+  CHECK(cista::static_type_hash<data32::vector<int>>() !=
+        cista::static_type_hash<cista::offset::vector<int>>());
+}
+
+TEST_CASE("offset32 requires arena") {
+  auto v = data32::vector<int>{};
+  CHECK_THROWS(v.push_back(1));
+
+  auto a = cista::arena{};
+  auto& in_arena = a.create<data32::vector<int>>();
+  in_arena.push_back(1);
+  CHECK(in_arena.size() == 1U);
+
+  // Stack object too far away from the arena.
+  auto p = data32::ptr<int>{};
+  CHECK_THROWS(p = in_arena.data());
+}
+
+TEST_CASE("offset32 narrow offset range") {
+  using limits = std::numeric_limits<std::int16_t>;
+  CHECK(cista::narrow_offset<std::int16_t>(limits::min() + 1) ==
+        limits::min() + 1);
+  CHECK(cista::narrow_offset<std::int16_t>(limits::max()) == limits::max());
+  CHECK_THROWS(cista::narrow_offset<std::int16_t>(limits::min()));
+  CHECK_THROWS(cista::narrow_offset<std::int16_t>(limits::max() + 1));
+}
+
+TEST_CASE("offset32 pending pointer offset width") {
+  struct value {
+    std::uint32_t v_;
+  };
+  struct forward {
+    cista::offset_ptr<value, std::int16_t> ptr_;
+    std::uint16_t after_ptr_;
+    cista::indexed<value> target_;
+  };
+
+  cista::byte_buf buf;
+  {
+    auto f = forward{};
+    f.after_ptr_ = 0xBEEFU;
+    f.target_.v_ = 7U;
+    f.ptr_ = &f.target_;  // target is written after the pointer
+    buf = cista::serialize(f);
+  }
+
+  auto const f = cista::deserialize<forward>(buf);
+  CHECK(f->after_ptr_ == 0xBEEFU);
+  CHECK(f->ptr_ == &f->target_);
+  CHECK(f->ptr_->v_ == 7U);
+}
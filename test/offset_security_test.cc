@@ -1,8 +1,11 @@
+#include <algorithm>
+
 #include "doctest.h"
 
 #ifdef SINGLE_HEADER
 #include "cista.h"
 #else
+#include "cista/containers/hash_map.h"
 #include "cista/serialization.h"
 #endif
 
@@ -155,6 +158,63 @@ inline void test_sec_array_overflow() {
   buf.resize(buf.size() - 1);
   CHECK_THROWS(cista::deserialize<serialize_me>(buf));
 }
+
+inline void test_sec_hash_map_seed() {
+  using serialize_me = data::hash_map<int, int>;
+
+  cista::byte_buf buf;
+
+  {
+    serialize_me obj;
+    obj.set_seed(0xC0FFEEU);
+    for (auto i = 0; i != 100; ++i) {
+      obj.emplace(i, i);
+    }
+    buf = cista::serialize(obj);
+  }  // EOL obj
+
+  auto const el = cista::deserialize<serialize_me>(buf);
+  CHECK(el->seed() == 0xC0FFEEU);
+  CHECK_NOTHROW(
+      cista::deserialize<serialize_me, cista::mode::DEEP_CHECK>(buf));
+  el->seed_ = 0xBADU;
+  CHECK_NOTHROW(cista::deserialize<serialize_me>(buf));  // keys not hashed
+  CHECK_THROWS(cista::deserialize<serialize_me, cista::mode::DEEP_CHECK>(buf));
+}
+
+inline void test_sec_hash_map_growth_left() {
+  using serialize_me = data::hash_map<int, int>;
+
+  cista::byte_buf buf;
+  auto obj_size = std::size_t{0U};
+
+  {
+    serialize_me obj;
+    auto n = 1'000;
+    for (auto i = 0; i != n; ++i) {
+      obj.emplace(i, i);
+    }
+    while (obj.growth_left_ != 0U) {  // fill to the maximum load factor
+      ++n;
+      obj.emplace(n, n);
+    }
+    for (auto i = 0; i <= n; i += 2) {
+      obj.erase(i);  // leaves tombstones in full groups
+    }
+    REQUIRE(std::any_of(
+        obj.ctrl_.get(), obj.ctrl_.get() + obj.capacity_,
+        [](auto const ctrl) { return serialize_me::is_deleted(ctrl); }));
+    obj_size = obj.size();
+    buf = cista::serialize(obj);
+  }  // EOL obj
+
+  serialize_me* el = nullptr;
+  REQUIRE_NOTHROW(el = cista::deserialize<serialize_me>(buf));
+  CHECK(el->size() == obj_size);
+  CHECK(el->at(1) == 1);
+  el->growth_left_ += 1U;
+  CHECK_THROWS(cista::deserialize<serialize_me>(buf));
+}
 }  // namespace
 
 TEST_CASE("sec offset test value overflow") { test_sec_value_overflow(); }
@@ -166,4 +226,8 @@ TEST_CASE("sec offset test unique ptr overflow unset") {
 TEST_CASE("sec offset test unique ptr overflow set") {
   test_sec_unique_ptr_overflow_set();
 }
-TEST_CASE("sec offset test array overflow") { test_sec_array_overflow(); }
\ No newline at end of file
+TEST_CASE("sec offset test array overflow") { test_sec_array_overflow(); }
+TEST_CASE("sec offset test hash map seed") { test_sec_hash_map_seed(); }
+TEST_CASE("sec offset test hash map growth left") {
+  test_sec_hash_map_growth_left();
+}
\ No newline at end of file
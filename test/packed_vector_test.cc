@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/fws_multimap.h"
+#include "cista/containers/packed_vector.h"
+#include "cista/containers/vecvec.h"
+#include "cista/serialization.h"
+#include "cista/strong.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+data::vector<std::uint32_t> make_values(std::size_t const n,
+                                        unsigned const bits) {
+  auto gen = std::mt19937{static_cast<std::uint32_t>(n + bits)};
+  auto dist = std::uniform_int_distribution<std::uint32_t>{
+      0U, static_cast<std::uint32_t>((std::uint64_t{1U} << bits) - 1U)};
+  auto v = data::vector<std::uint32_t>{};
+  for (auto i = 0U; i != n; ++i) {
+    v.push_back(dist(gen));
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST_CASE("packed_vector get set") {
+  auto v = data::packed_vector<11U>{};
+  auto const ref = make_values(1000U, 11U);
+  for (auto const x : ref) {
+    v.push_back(x);
+  }
+  REQUIRE(v.size() == ref.size());
+  CHECK(v.size_in_bytes() < ref.size() * sizeof(std::uint32_t) / 2U);
+  CHECK(std::equal(begin(v), end(v), begin(ref)));
+
+  v[7] = 2047U;
+  ++v[8];
+  CHECK(v[7] == 2047U);
+  CHECK(v[8] == ref[8] + 1U);
+  CHECK(v[6] == ref[6]);
+  CHECK(v[9] == ref[9]);
+
+  v.resize(500U);
+  v.resize(600U);
+  CHECK(v[499] == ref[499]);
+  CHECK(v[500] == 0U);
+  CHECK(v[599] == 0U);
+  CHECK_THROWS(v.at(600U));
+
+  // Too wide values are rejected and do not overwrite their neighbours.
+  auto narrow = data::packed_vector<4U>{};
+  narrow.encode(std::vector<std::uint32_t>{1U, 2U, 3U});
+  CHECK_THROWS(narrow.set(1U, 0xFFU));
+  CHECK_THROWS(narrow[1] = 16U);
+  CHECK_THROWS(narrow.push_back(16U));
+  CHECK(narrow.size() == 3U);
+  CHECK(narrow[0] == 1U);
+  CHECK(narrow[1] == 2U);
+  CHECK(narrow[2] == 3U);
+}
+
+TEST_CASE("packed_vector encode decode") {
+  for (auto const bits : {1U, 11U, 17U, 20U, 32U}) {
+    auto const ref = make_values(1000U, bits);
+
+    auto fixed = data::packed_vector<32U>{};
+    auto dyn = data::dynamic_packed_vector<>{};
+    fixed.encode(ref);
+    dyn.encode(ref);
+    CHECK(dyn.width() <= bits);
+    CHECK(std::equal(begin(dyn), end(dyn), begin(ref)));
+
+    for (auto const& [from, n] : {std::pair{0U, 1000U}, std::pair{3U, 200U},
+                                 std::pair{64U, 64U}, std::pair{999U, 1U}}) {
+      auto out = std::vector<std::uint32_t>(n);
+      dyn.decode(from, n, out.data());
+      CHECK(std::equal(begin(out), end(out), begin(ref) + from));
+      fixed.decode(from, n, out.data());
+      CHECK(std::equal(begin(out), end(out), begin(ref) + from));
+    }
+  }
+}
+
+TEST_CASE("packed_vector dynamic width") {
+  auto v = data::dynamic_packed_vector<>{};
+  v.push_back(0U);
+  CHECK(v.width() == 0U);
+  v.push_back(5U);
+  CHECK(v.width() == 3U);
+  v[0] = 100000U;
+  CHECK(v.width() == 17U);
+  CHECK(v[0] == 100000U);
+  CHECK(v[1] == 5U);
+  v.set_width(32U);
+  CHECK(v[0] == 100000U);
+  CHECK_THROWS(v.set_width(16U));
+
+  auto zeros = data::dynamic_packed_vector<>{};
+  zeros.resize(3U);
+  zeros.push_back(0U);
+  CHECK(zeros.width() == 0U);
+  CHECK(zeros[3] == 0U);
+  zeros.set_width(4U);
+  CHECK(std::all_of(begin(zeros), end(zeros), [](auto x) { return x == 0U; }));
+}
+
+TEST_CASE("packed_vector vecvec index") {
+  using key = cista::strong<std::uint32_t, struct key_>;
+  using vecvec_t = cista::basic_vecvec<key, data::vector<std::uint16_t>,
+                                       data::dynamic_packed_vector<>>;
+
+  auto d = vecvec_t{};
+  for (auto i = 0U; i != 100U; ++i) {
+    auto bucket = data::vector<std::uint16_t>{};
+    for (auto j = 0U; j != i % 7U; ++j) {
+      bucket.push_back(static_cast<std::uint16_t>(i * j));
+    }
+    d.emplace_back(bucket);
+  }
+  d[key{3U}].push_back(std::uint16_t{42U});
+
+  auto m = cista::fws_multimap<data::vector<std::uint16_t>,
+                               data::packed_vector<12U>>{};
+  m.push_back(1U);
+  m.push_back(2U);
+  m.finish_key();
+  m.push_back(3U);
+  m.finish_key();
+  m.finish_map();
+  CHECK(m[0U].size() == 2U);
+  CHECK(m[1U][0U] == 3U);
+
+  constexpr auto const MODE = cista::mode::WITH_INTEGRITY;
+  auto const buf = cista::serialize<MODE>(d);
+  auto const s = cista::deserialize<vecvec_t, MODE>(buf);
+  REQUIRE(s->size() == 100U);
+  CHECK(s->bucket_starts_.width() == 9U);
+  CHECK(s->at(key{3U}).size() == 4U);
+  CHECK(s->at(key{3U}).back() == 42U);
+  for (auto i = 0U; i != 100U; ++i) {
+    auto const b = s->at(key{i});
+    REQUIRE(b.size() == (i % 7U) + (i == 3U ? 1U : 0U));
+    for (auto j = 0U; j != i % 7U; ++j) {
+      CHECK(b[j] == static_cast<std::uint16_t>(i * j));
+    }
+  }
+}
+
+TEST_CASE("packed_vector serialize corrupt") {
+  auto v = data::packed_vector<20U>{};
+  v.encode(make_values(100U, 20U));
+  auto buf = cista::serialize(v);
+  auto const d = cista::deserialize<data::packed_vector<20U>>(buf);
+  CHECK(*d == v);
+
+  reinterpret_cast<data::packed_vector<20U>*>(buf.data())->size_ = 1000U;
+  CHECK_THROWS(cista::deserialize<data::packed_vector<20U>>(buf));
+}
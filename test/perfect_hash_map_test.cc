@@ -0,0 +1,107 @@
+#include <string>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/perfect_hash_map.h"
+#include "cista/containers/string.h"
+#include "cista/serialization.h"
+#endif
+
+TEST_CASE("perfect_hash_map test") {
+  using namespace cista;
+  using map_t = offset::perfect_hash_map<std::uint64_t, std::uint32_t>;
+
+  auto entries = std::vector<pair<std::uint64_t, std::uint32_t>>{};
+  for (auto i = 0U; i != 50'000U; ++i) {
+    entries.push_back({std::uint64_t{i} << 20U, i});
+  }
+
+  auto uut = map_t{};
+  CHECK(uut.empty());
+  CHECK(!uut.contains(std::uint64_t{0U}));
+
+  uut.build(begin(entries), end(entries));
+  CHECK(uut.size() == entries.size());
+  for (auto const& [key, value] : entries) {
+    CHECK(uut.at(key) == value);
+  }
+  CHECK(uut.find(std::uint64_t{1U}) == uut.end());
+  CHECK(!uut.contains(std::uint64_t{50'000U} << 20U));
+
+  auto buf = serialize(uut);
+  auto const deserialized = deserialize<map_t>(buf);
+  CHECK(deserialized->size() == entries.size());
+  for (auto const& [key, value] : entries) {
+    CHECK(deserialized->at(key) == value);
+  }
+  CHECK(!deserialized->contains(std::uint64_t{3U}));
+
+  REQUIRE(!deserialized->free_slots_.empty());
+  deserialized->free_slots_[0] = map_t::SHARD_SIZE * 2U;
+  CHECK_THROWS(deserialize<map_t>(buf));
+}
+
+TEST_CASE("perfect_hash_map string keys test") {
+  using namespace cista;
+  using namespace cista::raw;
+  using map_t = perfect_hash_map<string, int>;
+
+  auto entries = std::vector<pair<string, int>>{};
+  for (auto i = 0; i != 1'000; ++i) {
+    entries.push_back({string{"key_" + std::to_string(i)}, i});
+  }
+
+  auto uut = map_t{};
+  uut.build(begin(entries), end(entries));
+  CHECK(uut.at(std::string_view{"key_999"}) == 999);
+  CHECK(!uut.contains(std::string_view{"key_1000"}));
+
+  auto buf = serialize(uut);
+  auto const deserialized = deserialize<map_t>(buf);
+  for (auto i = 0; i != 1'000; ++i) {
+    CHECK(deserialized->at(std::string{"key_" + std::to_string(i)}) == i);
+  }
+
+  entries.push_back({string{"key_7"}, 7});
+  CHECK_THROWS(uut.build(begin(entries), end(entries)));
+}
+
+TEST_CASE("perfect_hash_map deep check") {
+  using namespace cista;
+  using namespace cista::offset;
+
+  struct root {
+    vector<indexed<string>> names_;
+    perfect_hash_map<int, ptr<string>> index_;
+    vector<std::uint64_t> junk_;
+  };
+
+  byte_buf buf;
+  {
+    auto r = root{};
+    for (auto i = 0; i != 10; ++i) {
+      r.names_.emplace_back(string{"a long name #" + std::to_string(i)});
+    }
+    auto entries = std::vector<pair<int, ptr<string>>>{};
+    for (auto i = 0; i != 10; ++i) {
+      entries.push_back({i, &r.names_[static_cast<unsigned>(i)]});
+    }
+    r.index_.build(begin(entries), end(entries));
+    r.junk_.resize(8U, ~std::uint64_t{0U});
+    buf = serialize(r);
+  }
+
+  auto const r = deserialize<root, mode::DEEP_CHECK>(buf);
+  CHECK(*r->index_.at(3) == "a long name #3");
+
+  // Pointees are only checked by the deep check (second pass).
+  auto const& e = *r->index_.find(3);
+  const_cast<ptr<string>&>(e.second) =
+      reinterpret_cast<string*>(r->junk_.data());
+  CHECK_NOTHROW(deserialize<root>(buf));
+  CHECK_THROWS(deserialize<root, mode::DEEP_CHECK>(buf));
+}
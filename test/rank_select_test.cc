@@ -0,0 +1,113 @@
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/bitvec.h"
+#include "cista/containers/rank_select.h"
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+data::bitvec make_bitvec(std::size_t const n, double const density) {
+  auto gen = std::mt19937{static_cast<std::uint32_t>(n)};
+  auto dist = std::bernoulli_distribution{density};
+  auto bv = data::bitvec{};
+  bv.resize(static_cast<data::bitvec::size_type>(n));
+  for (auto i = 0U; i != n; ++i) {
+    bv.set(i, dist(gen));
+  }
+  return bv;
+}
+
+bool check(data::bitvec const& bv, data::rank_select const& rs) {
+  auto ones = std::size_t{0U};
+  auto zeros = std::size_t{0U};
+  auto next = std::vector<std::size_t>(bv.size() + 1U, bv.size());
+  for (auto i = bv.size(); i != 0U; --i) {
+    next[i - 1U] = bv.test(i - 1U) ? i - 1U : next[i];
+  }
+  for (auto i = 0U; i != bv.size(); ++i) {
+    if (rs.rank1(bv, i) != ones || rs.rank0(bv, i) != zeros ||
+        rs.next_set_bit(bv, i) != next[i]) {
+      return false;
+    }
+    if (bv.test(i)) {
+      if (rs.select1(bv, ones++) != i) {
+        return false;
+      }
+    } else if (rs.select0(bv, zeros++) != i) {
+      return false;
+    }
+  }
+  return rs.rank1(bv, bv.size()) == ones && rs.count() == ones &&
+         rs.next_set_bit(bv, bv.size()) == bv.size();
+}
+
+}  // namespace
+
+TEST_CASE("rank_select") {
+  for (auto const n : {0U, 1U, 63U, 64U, 2048U, 100'037U}) {
+    for (auto const density : {0.0, 0.001, 0.5, 0.999, 1.0}) {
+      auto const bv = make_bitvec(n, density);
+      auto rs = data::rank_select{};
+      rs.build(bv);
+      CHECK(check(bv, rs));
+    }
+  }
+}
+
+TEST_CASE("rank_select overhead") {
+  auto const bv = make_bitvec(1'000'000U, 0.3);
+  auto rs = data::rank_select{};
+  rs.build(bv);
+  CHECK(rs.count() == bv.count());
+  CHECK(rs.size_in_bytes() * 100U < bv.size() / 8U * 5U);
+}
+
+TEST_CASE("rank_select serialize") {
+  struct indexed_bitvec {
+    data::bitvec bv_;
+    data::rank_select rs_;
+  };
+
+  auto x = indexed_bitvec{make_bitvec(50'000U, 0.2), {}};
+  x.rs_.build(x.bv_);
+
+  auto buf = cista::serialize(x);
+  auto const d = cista::deserialize<indexed_bitvec>(buf);
+  CHECK(check(d->bv_, d->rs_));
+
+  d->rs_.ones_ = 60'000U;
+  CHECK_THROWS(cista::deserialize<indexed_bitvec>(buf));
+}
+
+TEST_CASE("rank_select serialize corrupt counts") {
+  struct indexed_bitvec {
+    data::bitvec bv_;
+    data::rank_select rs_;
+  };
+
+  auto x = indexed_bitvec{make_bitvec(50'000U, 0.2), {}};
+  x.rs_.build(x.bv_);
+  auto const buf = cista::serialize(x);
+
+  auto sub_block = buf;
+  auto& l1 = reinterpret_cast<indexed_bitvec*>(sub_block.data())->rs_.l1_;
+  l1[3] |= std::uint64_t{0x3FFU} << 32U;  // 1023 ones in 512 bits
+  CHECK_THROWS(cista::deserialize<indexed_bitvec>(sub_block));
+
+  auto block = buf;
+  reinterpret_cast<indexed_bitvec*>(block.data())->rs_.l1_[5] += 3000U;
+  CHECK_THROWS(cista::deserialize<indexed_bitvec>(block));
+
+  // select() stays within a bit vector that does not match the directory.
+  auto const zeros = make_bitvec(50'000U, 0.0);
+  CHECK(x.rs_.select1(zeros, x.rs_.count() - 1U) == x.rs_.size());
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/roaring.h"
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+// Sparse random values + one dense chunk (bitmap) + one long run.
+std::vector<std::uint32_t> make_values(std::uint32_t const seed) {
+  auto gen = std::mt19937{seed};
+  auto dist = std::uniform_int_distribution<std::uint32_t>{};
+  auto v = std::vector<std::uint32_t>{};
+  for (auto i = 0U; i != 20'000U; ++i) {
+    v.push_back(dist(gen));
+  }
+  for (auto i = 0U; i != 30'000U; ++i) {
+    v.push_back((5U << 16U) | (dist(gen) & 0xFFFFU));
+  }
+  for (auto i = 100U + seed; i != 30'000U; ++i) {
+    v.push_back((9U << 16U) | i);
+  }
+  std::sort(begin(v), end(v));
+  v.erase(std::unique(begin(v), end(v)), end(v));
+  return v;
+}
+
+std::vector<std::uint32_t> to_vector(data::roaring const& r) {
+  auto v = std::vector<std::uint32_t>{};
+  r.for_each([&](std::uint32_t const x) { v.push_back(x); });
+  return v;
+}
+
+bool has_type(data::roaring const& r, data::roaring::container_type t) {
+  return std::any_of(begin(r.containers_), end(r.containers_),
+                     [&](auto const& c) { return c.type_ == t; });
+}
+
+}  // namespace
+
+TEST_CASE("roaring encode") {
+  using type = data::roaring::container_type;
+
+  auto const ref = make_values(1U);
+  auto r = data::roaring{};
+  r.encode(ref);
+  CHECK(r.size() == ref.size());
+  CHECK(r.front() == ref.front());
+  CHECK(r.back() == ref.back());
+  CHECK(to_vector(r) == ref);
+  CHECK(has_type(r, type::ARRAY));
+  CHECK(has_type(r, type::BITMAP));
+  CHECK(has_type(r, type::RUN));
+
+  CHECK(std::all_of(begin(ref), end(ref),
+                    [&](std::uint32_t const x) { return r.contains(x); }));
+  CHECK(std::none_of(begin(ref), end(ref), [&](std::uint32_t const x) {
+    return x != 0U && !std::binary_search(begin(ref), end(ref), x - 1U) &&
+           r.contains(x - 1U);
+  }));
+
+  auto appended = data::roaring{};
+  for (auto const x : ref) {
+    appended.push_back(x);
+  }
+  CHECK_THROWS(appended.push_back(ref.back()));
+  CHECK(appended == r);
+  CHECK(!has_type(appended, type::RUN));
+  CHECK(to_vector(appended) == ref);
+
+  auto const before = appended.size_in_bytes();
+  appended.run_optimize();
+  CHECK(appended.size_in_bytes() < before);
+  CHECK(has_type(appended, type::RUN));
+  CHECK(to_vector(appended) == ref);
+
+
+  auto runs = data::roaring{};
+  runs.encode(std::vector<std::uint32_t>{12U, 10U, 11U});
+  CHECK(has_type(runs, type::RUN));
+  runs.push_back(13U);  // extends the run
+  runs.push_back(20U);  // new run
+  CHECK(runs.values_.size() == 4U);
+  CHECK(to_vector(runs) == std::vector<std::uint32_t>{10U, 11U, 12U, 13U, 20U});
+  CHECK(!runs.contains(14U));
+}
+
+TEST_CASE("roaring set operations") {
+  auto const x = make_values(1U);
+  auto const y = make_values(2U);
+
+  auto a = data::roaring{};
+  auto b = data::roaring{};
+  a.encode(x);
+  b.encode(y);
+
+  auto intersection = std::vector<std::uint32_t>{};
+  std::set_intersection(begin(x), end(x), begin(y), end(y),
+                        std::back_inserter(intersection));
+  auto union_ = std::vector<std::uint32_t>{};
+  std::set_union(begin(x), end(x), begin(y), end(y),
+                 std::back_inserter(union_));
+
+  CHECK(to_vector(a & b) == intersection);
+  CHECK((a & b).size() == intersection.size());
+  CHECK(a.and_count(b) == intersection.size());
+  CHECK(to_vector(a | b) == union_);
+  CHECK((a | b).size() == union_.size());
+  CHECK((a & a) == a);
+  CHECK((a | b) != a);
+}
+
+TEST_CASE("roaring serialize") {
+  auto const ref = make_values(3U);
+  auto r = data::roaring{};
+  r.encode(ref);
+
+  auto buf = cista::serialize(r);
+  auto const d = cista::deserialize<data::roaring>(buf);
+  CHECK(to_vector(*d) == ref);
+  CHECK(d->contains(ref[ref.size() / 2U]));
+  CHECK((*d & r).size() == ref.size());
+
+  auto const find = [&](data::roaring::container_type const t) {
+    return std::find_if(
+        begin(d->containers_), end(d->containers_),
+        [&](auto const& c) { return c.type_ == t && c.cardinality_ >= 2U; });
+  };
+  auto const array = find(data::roaring::container_type::ARRAY);
+  auto const run = find(data::roaring::container_type::RUN);
+  REQUIRE(array != end(d->containers_));
+  REQUIRE(run != end(d->containers_));
+
+  SUBCASE("cardinality") {
+    d->containers_[1U].cardinality_ += 1U;
+    CHECK_THROWS(cista::deserialize<data::roaring>(buf));
+  }
+
+  SUBCASE("empty container") {
+    d->cardinality_ -= array->cardinality_;
+    array->size_ = 0U;
+    array->cardinality_ = 0U;
+    CHECK_THROWS(cista::deserialize<data::roaring>(buf));
+  }
+
+  SUBCASE("array order") {
+    std::swap(d->values_[array->offset_], d->values_[array->offset_ + 1U]);
+    CHECK_THROWS(cista::deserialize<data::roaring>(buf));
+  }
+
+  SUBCASE("run length") {
+    d->values_[run->offset_ + 1U] += 1U;
+    CHECK_THROWS(cista::deserialize<data::roaring>(buf));
+  }
+
+  SUBCASE("run overflow") {
+    auto const length = d->values_[run->offset_ + 1U];
+    d->values_[run->offset_] =
+        static_cast<std::uint16_t>(0xFFFFU - length + 1U);
+    CHECK_THROWS(cista::deserialize<data::roaring>(buf));
+  }
+}
@@ -0,0 +1,147 @@
+#include <string>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+using nested_t = data::vector<data::vector<data::vector<std::uint32_t>>>;
+
+nested_t make_nested() {
+  auto v = nested_t{};
+  for (auto i = 0U; i != 3U; ++i) {
+    auto& a = v.emplace_back();
+    for (auto j = 0U; j != 3U; ++j) {
+      auto& b = a.emplace_back();
+      for (auto k = 0U; k != 3U; ++k) {
+        b.push_back(i * 100U + j * 10U + k);
+      }
+    }
+  }
+  return v;
+}
+
+struct mixed {
+  data::vector<data::pair<data::string, data::vector<std::uint64_t>>> entries_;
+  data::hash_map<std::uint32_t, data::string> names_;
+  data::unique_ptr<data::vector<std::uint64_t>> extra_;
+};
+
+mixed make_mixed() {
+  auto m = mixed{};
+  for (auto i = 0U; i != 50U; ++i) {
+    auto& e = m.entries_.emplace_back();
+    e.first = "a string of odd length " + std::to_string(i);
+    for (auto j = 0U; j != i % 5U + 1U; ++j) {
+      e.second.push_back(i * j);
+    }
+    m.names_.emplace(i, e.first);
+  }
+  m.extra_ = data::make_unique<data::vector<std::uint64_t>>(
+      data::vector<std::uint64_t>{1U, 2U, 3U});
+  return m;
+}
+
+template <typename T>
+std::uintptr_t addr(T const* p) {
+  return reinterpret_cast<std::uintptr_t>(p);
+}
+
+}  // namespace
+
+TEST_CASE("serialization layout round trip") {
+  constexpr auto const MODE = cista::mode::WITH_INTEGRITY;
+
+  auto const original = make_mixed();
+  auto dfs_stats = cista::layout_stats{};
+  for (auto const l : {cista::layout::DFS, cista::layout::BFS,
+                       cista::layout::CHILDREN_ADJACENT,
+                       cista::layout::HOT_FIRST, cista::layout::SIZE_CLASS}) {
+    auto m = make_mixed();
+    auto b = cista::buf{};
+    auto const stats = cista::serialize<MODE>(b, m, cista::layout_policy{l});
+
+    auto const d = cista::deserialize<mixed, MODE>(b.buf_);
+    REQUIRE(d->entries_.size() == original.entries_.size());
+    for (auto i = 0U; i != original.entries_.size(); ++i) {
+      CHECK(d->entries_[i].first == original.entries_[i].first);
+      CHECK(d->entries_[i].second == original.entries_[i].second);
+      CHECK(d->names_.at(i) == original.entries_[i].first);
+    }
+    CHECK(*d->extra_ == *original.extra_);
+
+    CHECK(stats.pages_ == (b.size() + 4095U) / 4096U);
+    CHECK(stats.touched_pages_ == stats.pages_);
+    if (l == cista::layout::DFS) {
+      dfs_stats = stats;
+    } else {
+      CHECK(stats.blocks_ == dfs_stats.blocks_);
+      CHECK(stats.block_bytes_ == dfs_stats.block_bytes_);
+    }
+    if (l == cista::layout::SIZE_CLASS) {
+      CHECK(stats.padding_bytes_ < dfs_stats.padding_bytes_);
+    }
+  }
+}
+
+TEST_CASE("serialization layout order") {
+  auto v = make_nested();
+
+  auto const serialize = [&](cista::layout_policy const& p) {
+    auto b = cista::buf{};
+    cista::serialize(b, v, p);
+    return std::move(b.buf_);
+  };
+
+  {  // BFS: all level 2 blocks before level 3 blocks.
+    auto buf = serialize({cista::layout::BFS});
+    auto const d = cista::deserialize<nested_t>(buf);
+    CHECK(addr((*d)[2].data()) < addr((*d)[0][0].data()));
+    CHECK(addr((*d)[0][0].data()) < addr((*d)[0][1].data()));
+    CHECK(addr((*d)[0][2].data()) < addr((*d)[1][0].data()));
+  }
+
+  {  // Children adjacent: siblings back to back, then their subtrees.
+    auto buf = serialize({cista::layout::CHILDREN_ADJACENT});
+    auto const d = cista::deserialize<nested_t>(buf);
+    CHECK(addr((*d)[0][1].data()) == addr((*d)[0][0].data() + 3U));
+    CHECK(addr((*d)[0][2].data()) == addr((*d)[0][1].data() + 3U));
+    CHECK(addr((*d)[1].data()) == addr((*d)[0].data() + 3U));
+    CHECK(addr((*d)[1][0].data()) > addr((*d)[0][2].data()));
+  }
+
+  {  // DFS: each block followed by its subtree.
+    auto buf = serialize({cista::layout::DFS});
+    auto const d = cista::deserialize<nested_t>(buf);
+    CHECK(addr((*d)[0][0].data()) < addr((*d)[1].data()));
+  }
+
+  {  // Hot first: the profiled path comes first.
+    auto profile = cista::access_profile{};
+    profile[v.data()] = 10U;
+    profile[v[2].data()] = 10U;
+    profile[v[2][1].data()] = 5U;
+
+    auto const policy = cista::layout_policy{cista::layout::HOT_FIRST,
+                                             &profile, 64U};
+    auto b = cista::buf{};
+    auto const stats = cista::serialize(b, v, policy);
+    auto const d = cista::deserialize<nested_t>(b.buf_);
+    CHECK(addr((*d)[2].data()) < addr((*d)[0].data()));
+    CHECK(addr((*d)[2][1].data()) < addr((*d)[0].data()));
+    CHECK(addr((*d)[2][1].data()) < addr((*d)[2][0].data()));
+    CHECK(stats.touched_pages_ < stats.pages_);
+
+    auto dfs = cista::buf{};
+    auto const dfs_stats = cista::serialize(
+        dfs, v, cista::layout_policy{cista::layout::DFS, &profile, 64U});
+    CHECK(stats.touched_pages_ <= dfs_stats.touched_pages_);
+  }
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <numeric>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/soa_vector.h"
+#include "cista/serialization.h"
+#include "cista/type_hash/static_type_hash.h"
+#include "cista/type_hash/type_hash.h"
+#endif
+
+namespace {
+
+template <typename Ctx>
+struct record {
+  std::uint32_t id_;
+  float value_;
+  typename Ctx::string name_;
+};
+
+struct offset_ctx {
+  using string = cista::offset::string;
+};
+
+struct raw_ctx {
+  using string = cista::raw::string;
+};
+
+template <typename Ctx>
+record<Ctx> make_record(std::uint32_t const i) {
+  return {i, static_cast<float>(i) / 2.0F,
+          typename Ctx::string{"a long record name #" + std::to_string(i)}};
+}
+
+}  // namespace
+
+TEST_CASE("soa_vector") {
+  using record_t = record<offset_ctx>;
+  auto v = cista::offset::soa_vector<record_t>{};
+  for (auto i = 0U; i != 1000U; ++i) {
+    v.push_back(make_record<offset_ctx>(i));
+  }
+
+  REQUIRE(v.size() == 1000U);
+  CHECK(v.column<0U>().size() == 1000U);
+
+  auto const& values = v.column<1U>();
+  auto sum = 0.0F;
+  for (auto const* x = values.data(); x != values.data() + values.size();
+       ++x) {
+    sum += *x;
+  }
+  CHECK(sum == doctest::Approx(999.0 * 1000.0 / 4.0));
+
+  CHECK(v[10].get<0U>() == 10U);
+  CHECK(v[10].get<2U>() == "a long record name #10");
+
+  v[10] = make_record<offset_ctx>(5000U);
+  record_t const r = v[10];
+  CHECK(r.id_ == 5000U);
+  CHECK(r.value_ == 2500.0F);
+  CHECK(r.name_ == "a long record name #5000");
+
+  auto ids = 0U;
+  for (auto const row : v) {
+    ids += row.get<0U>() == 5000U ? 1U : 0U;
+  }
+  CHECK(ids == 1U);
+
+  v.pop_back();
+  CHECK(v.size() == 999U);
+  CHECK(v.column<2U>().size() == 999U);
+}
+
+TEST_CASE("soa_vector row assignment and sort") {
+  using record_t = record<offset_ctx>;
+  auto v = cista::offset::soa_vector<record_t>{};
+  for (auto const i : {3U, 1U, 4U, 0U, 2U}) {
+    v.push_back(make_record<offset_ctx>(i));
+  }
+
+  v[0] = v[1];  // copies the row
+  CHECK(v[0].get<0U>() == 1U);
+  CHECK(v[0].get<2U>() == "a long record name #1");
+  CHECK(v[1].get<0U>() == 1U);
+  v[0] = make_record<offset_ctx>(3U);
+
+  using std::swap;
+  swap(v[0], v[1]);
+  CHECK(v[0].get<0U>() == 1U);
+  CHECK(v[1].get<0U>() == 3U);
+
+  std::sort(begin(v), end(v), [](record_t const& a, record_t const& b) {
+    return a.id_ < b.id_;
+  });
+  for (auto i = 0U; i != v.size(); ++i) {
+    CHECK(v[i].get<0U>() == i);
+    CHECK(v[i].get<1U>() == static_cast<float>(i) / 2.0F);
+    CHECK(v[i].get<2U>() == make_record<offset_ctx>(i).name_);
+  }
+  CHECK(begin(v) + 2 == 2 + begin(v));
+  CHECK(end(v) > begin(v));
+  CHECK(begin(v) <= begin(v));
+  CHECK(begin(v) >= begin(v));
+}
+
+TEST_CASE("soa_vector type hash") {
+  using a_t = cista::offset::soa_vector<record<offset_ctx>>;
+  using b_t = cista::offset::vector<record<offset_ctx>>;
+  CHECK(cista::type_hash<a_t>() != cista::type_hash<b_t>());
+  CHECK(cista::static_type_hash<a_t>() != cista::static_type_hash<b_t>());
+}
+
+TEST_CASE("soa_vector serialize offset") {
+  constexpr auto const MODE =
+      cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+  using record_t = record<offset_ctx>;
+  using vec_t = cista::offset::soa_vector<record_t>;
+
+  cista::byte_buf buf;
+  {
+    auto v = vec_t{};
+    for (auto i = 0U; i != 100U; ++i) {
+      v.push_back(make_record<offset_ctx>(i));
+    }
+    buf = cista::serialize<MODE>(v);
+  }
+
+  auto const d = cista::deserialize<vec_t, MODE>(buf);
+  REQUIRE(d->size() == 100U);
+  for (auto i = 0U; i != 100U; ++i) {
+    record_t const r = (*d)[i];
+    CHECK(r.id_ == i);
+    CHECK(r.name_ == make_record<offset_ctx>(i).name_);
+  }
+
+  buf[buf.size() - 1U] ^= 0xFFU;
+  CHECK_THROWS(cista::deserialize<vec_t, MODE>(buf));
+}
+
+TEST_CASE("soa_vector serialize raw") {
+  using record_t = record<raw_ctx>;
+  using vec_t = cista::raw::soa_vector<record_t>;
+
+  cista::byte_buf buf;
+  {
+    auto v = vec_t{};
+    for (auto i = 0U; i != 10U; ++i) {
+      v.push_back(make_record<raw_ctx>(i));
+    }
+    buf = cista::serialize(v);
+  }
+
+  auto const d = cista::deserialize<vec_t>(buf);
+  REQUIRE(d->size() == 10U);
+  CHECK(d->column<0U>()[9] == 9U);
+  CHECK(d->column<2U>()[3] == "a long record name #3");
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <string>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/split_vector.h"
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+namespace {
+
+struct trip {
+  std::uint32_t id_;
+  data::string name_;
+  std::uint16_t departure_;
+  data::vector<std::uint32_t> stops_;
+};
+
+trip make_trip(std::uint32_t const i) {
+  return trip{i, data::string{"trip with a long name " + std::to_string(i)},
+              static_cast<std::uint16_t>(i * 3U),
+              data::vector<std::uint32_t>{i, i + 1U}};
+}
+
+using trips_t = data::split_vector<trip, 0U, 2U>;
+
+}  // namespace
+
+TEST_CASE("split_vector") {
+  auto v = trips_t{};
+  for (auto i = 0U; i != 100U; ++i) {
+    v.push_back(make_trip(i));
+  }
+
+  static_assert(std::is_same_v<trips_t::hot_t,
+                               cista::tuple<std::uint32_t, std::uint16_t>>);
+  CHECK(v.size() == 100U);
+  CHECK(v.hot_.size() == v.cold_.size());
+
+  CHECK(v[42].get<0U>() == 42U);
+  CHECK(v[42].get<1U>() == "trip with a long name 42");
+  CHECK(v[42].get<2U>() == 126U);
+  CHECK(cista::get<1U>(v.hot_[42]) == 126U);
+
+  v[7] = make_trip(1000U);
+  trip const t = v[7];
+  CHECK(t.id_ == 1000U);
+  CHECK(t.name_ == "trip with a long name 1000");
+  CHECK(t.stops_ == data::vector<std::uint32_t>{1000U, 1001U});
+
+  auto n = 0U;
+  for (auto const r : v) {
+    n += r.get<2U>() % 2U == 0U ? 1U : 0U;
+  }
+  CHECK(n == 51U);  // v[7] replaced
+
+  auto const it = std::find_if(begin(v), end(v), [](auto const r) {
+    return r.template get<0U>() == 50U;
+  });
+  CHECK(it - begin(v) == 50);
+
+  CHECK_THROWS(v.at(100U));
+}
+
+TEST_CASE("split_vector serialize") {
+  constexpr auto const MODE =
+      cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+
+  cista::byte_buf buf;
+  {
+    auto v = trips_t{};
+    for (auto i = 0U; i != 100U; ++i) {
+      v.push_back(make_trip(i));
+    }
+    buf = cista::serialize<MODE>(v);
+  }
+
+  auto const d = cista::deserialize<trips_t, MODE>(buf);
+  REQUIRE(d->size() == 100U);
+  for (auto i = 0U; i != 100U; ++i) {
+    trip const t = (*d)[i];
+    auto const expected = make_trip(i);
+    CHECK(t.id_ == expected.id_);
+    CHECK(t.name_ == expected.name_);
+    CHECK(t.departure_ == expected.departure_);
+    CHECK(t.stops_ == expected.stops_);
+  }
+}
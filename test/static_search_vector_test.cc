@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+
+#ifdef SINGLE_HEADER
+#include "cista.h"
+#else
+#include "cista/containers/static_search_vector.h"
+#include "cista/serialization.h"
+#endif
+
+namespace data = cista::offset;
+
+TEST_CASE("static search vector lower_bound") {
+  auto gen = std::mt19937{3U};
+  auto dist = std::uniform_int_distribution<std::uint32_t>{0U, 100'000U};
+
+  for (auto const n : {0U, 1U, 2U, 3U, 15U, 16U, 17U, 1000U, 65'537U}) {
+    auto sorted = std::vector<std::uint32_t>(n);
+    std::generate(begin(sorted), end(sorted), [&]() { return dist(gen); });
+    std::sort(begin(sorted), end(sorted));
+
+    auto s = data::static_search_vector<std::uint32_t>{};
+    s.build(begin(sorted), end(sorted));
+    CHECK(s.size() == n);
+
+    auto queries = std::vector<std::uint32_t>(1000U);
+    std::generate(begin(queries), end(queries), [&]() { return dist(gen); });
+    queries.push_back(0U);
+    queries.push_back(100'001U);
+    if (n != 0U) {
+      queries.push_back(sorted.front());
+      queries.push_back(sorted.back());
+    }
+
+    auto expected = std::vector<std::uint32_t>{};
+    for (auto const q : queries) {
+      auto const it = std::lower_bound(begin(sorted), end(sorted), q);
+      expected.push_back(static_cast<std::uint32_t>(it - begin(sorted)));
+      CHECK(s.lower_bound(q) == expected.back());
+      CHECK(s.contains(q) == std::binary_search(begin(sorted), end(sorted), q));
+    }
+
+    auto batch = std::vector<std::uint32_t>(queries.size());
+    CHECK(s.lower_bound_many(begin(queries), end(queries), begin(batch)) ==
+          end(batch));
+    CHECK(batch == expected);
+  }
+}
+
+TEST_CASE("static search vector serialization") {
+  using search_t = data::static_search_vector<data::string>;
+
+  auto sorted = std::vector<data::string>{};
+  for (auto i = 0U; i != 500U; ++i) {
+    sorted.emplace_back(std::to_string(i));
+  }
+  std::sort(begin(sorted), end(sorted));
+
+  auto s = search_t{};
+  s.build(begin(sorted), end(sorted));
+
+  auto buf = cista::serialize(s);
+  auto const d = cista::deserialize<search_t>(buf);
+  for (auto const& x : sorted) {
+    auto const r = d->lower_bound(x);
+    CHECK(sorted[r] == x);
+  }
+  CHECK(d->lower_bound(data::string{"99a"}) == 500U);
+  CHECK(!d->contains(data::string{"1a"}));
+
+  d->ranks_[7] = 500U;
+  CHECK_THROWS(cista::deserialize<search_t>(buf));
+
+  std::reverse(begin(sorted), end(sorted));
+  CHECK_THROWS(s.build(begin(sorted), end(sorted)));
+}
@@ -249,6 +249,29 @@ TEST_SUITE("tuple") {
     CHECK((std::get<1>(serialized) == 55));
   }
 
+  TEST_CASE("tuple - deserialize pointers") {  // NOLINT
+    using raw_t = cista::tuple<int, cista::raw::vector<std::uint32_t>>;
+    using offset_t = cista::tuple<int, data::vector<std::uint32_t>>;
+
+    std::vector<unsigned char> raw_buf, offset_buf;
+    {
+      raw_t r = {1, {2U, 3U}};
+      raw_buf = cista::serialize(r);
+      offset_t o = {1, {2U, 3U}};
+      offset_buf = cista::serialize(o);
+    }
+
+    auto const& r = *cista::deserialize<raw_t>(raw_buf);
+    CHECK(cista::get<0>(r) == 1);
+    CHECK(cista::get<1>(r).size() == 2U);
+    CHECK(cista::get<1>(r).back() == 3U);
+
+    auto& o = *cista::deserialize<offset_t>(offset_buf);
+    CHECK(cista::get<1>(o).back() == 3U);
+    cista::get<1>(o).used_size_ = 1'000U;
+    CHECK_THROWS(cista::deserialize<offset_t>(offset_buf));
+  }
+
 #ifndef _WIN32
   template <typename... Ts>
   void check_size() {
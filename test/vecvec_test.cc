@@ -1,16 +1,21 @@
 #include <array>
 #include <memory>
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "doctest.h"
 
 #ifdef SINGLE_HEADER
 #include "cista.h"
 #else
+#include "cista/containers/concurrent_paged_vecvec.h"
 #include "cista/containers/mmap_vec.h"
 #include "cista/containers/paged.h"
 #include "cista/containers/paged_vecvec.h"
 #include "cista/containers/vecvec.h"
+#include "cista/containers/vecvec_builder.h"
 #include "cista/strong.h"
 #endif
 
@@ -103,6 +108,39 @@ TEST_CASE("vecvec resize test") {
   }
 }
 
+TEST_CASE("vecvec builder test") {
+  using key = cista::strong<unsigned, struct x_>;
+  using data = cista::raw::vecvec<key, std::string>;
+
+  auto b = cista::raw::vecvec_builder<key, std::string>{};
+  CHECK(b.build().empty());
+
+  for (auto i = 0U; i != 100U; ++i) {
+    b.push_back(key{i % 7U}, std::to_string(i));
+  }
+  b.emplace_back(key{9U}, "x");
+  b.resize(12U);
+  CHECK(b.size() == 12U);
+  CHECK(b.bucket_size(key{0U}) == 15U);
+  CHECK(b.bucket_size(key{8U}) == 0U);
+  CHECK_THROWS(b.resize(3U));
+
+  data const d = b.build();
+  CHECK(b.size() == 0U);
+  REQUIRE(d.size() == 12U);
+  CHECK(d.data_.size() == 101U);
+  for (auto k = 0U; k != 7U; ++k) {
+    auto const bucket = d[key{k}];
+    REQUIRE(bucket.size() == (k < 2U ? 15U : 14U));
+    for (auto j = 0U; j != bucket.size(); ++j) {
+      CHECK(bucket[j] == std::to_string(k + j * 7U));
+    }
+  }
+  CHECK(d[key{7U}].empty());
+  CHECK(d[key{9U}].front() == "x");
+  CHECK(d[key{11U}].empty());
+}
+
 TEST_CASE("vecvec mmap") {
   using key = cista::strong<unsigned, struct x_>;
   using idx_t = cista::mmap_vec<cista::base_t<key>>;
@@ -248,4 +286,166 @@ TEST_CASE("paged_vecvec vector") {
   CHECK_EQ("hellox", d[key{0}].view());
   CHECK_EQ("worldx", d[key{1}].view());
   CHECK_EQ("testx", d[key{2}].view());
-}
\ No newline at end of file
+}
+
+TEST_CASE("paged_vecvec compact") {
+  using key = cista::strong<unsigned, struct x_>;
+  using data_t = cista::paged<cista::raw::vector<std::uint32_t>>;
+  using idx_t = cista::raw::vector<data_t::page_t>;
+  using pvv_t = cista::paged_vecvec<idx_t, data_t, key>;
+
+  auto const fill = [](pvv_t& d) {
+    for (auto i = 0U; i != 100U; ++i) {
+      d.emplace_back(std::vector<std::uint32_t>{i});
+    }
+    for (auto round = 1U; round != 40U; ++round) {  // pages grow and move
+      for (auto i = 0U; i != 100U; i += 1U + i % 3U) {
+        d[key{i}].push_back(i + round);
+      }
+    }
+    d.resize(90U);
+  };
+
+  auto const check = [](pvv_t const& d) {
+    if (d.size() != 90U) {
+      return false;
+    }
+    for (auto i = 0U; i != 90U; ++i) {
+      auto const b = d[key{i}];
+      if (b.size() != (i % 3U == 2U ? 1U : 40U)) {
+        return false;
+      }
+      for (auto j = 0U; j != b.size(); ++j) {
+        if (b[j] != i + j) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+
+  auto d = pvv_t{};
+  fill(d);
+  CHECK(check(d));
+  auto const before = d.paged_.data_.size();
+  d.compact();
+  CHECK(check(d));
+  CHECK(d.paged_.data_.size() < before / 2U);
+
+  d[key{5U}].push_back(45U);  // usable after compaction, 5 % 3 == 2
+  CHECK(d[key{5U}][1U] == 45U);
+
+  auto inc = pvv_t{};
+  fill(inc);
+  auto c = inc.start_compaction();
+  auto steps = 0U;
+  while (!inc.compact_step(c, 64U)) {
+    CHECK(check(inc));
+    ++steps;
+  }
+  CHECK(steps > 10U);
+  CHECK(check(inc));
+  CHECK(inc.paged_.data_.size() < before / 2U);
+}
+
+TEST_CASE("concurrent_paged_vecvec") {
+  using key = cista::strong<unsigned, struct x_>;
+  using data_t = cista::paged<cista::raw::vector<std::uint32_t>>;
+  using idx_t = cista::raw::vector<data_t::page_t>;
+  using pvv_t = cista::paged_vecvec<idx_t, data_t, key>;
+
+  constexpr auto const num_threads = 4U;
+  constexpr auto const num_keys = 1000U;
+
+  auto c = cista::concurrent_paged_vecvec<idx_t, data_t, key>{num_keys};
+  auto threads = std::vector<std::thread>{};
+  for (auto t = 0U; t != num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      auto& w = c.add_writer();
+      for (auto round = 0U; round != 20U; ++round) {
+        for (auto i = t; i < num_keys; i += num_threads) {
+          if (i % 7U == 0U || round == 11U) {
+            continue;  // empty bucket / appended in round 10
+          } else if (round == 10U) {
+            w.append(key{i}, std::vector<std::uint32_t>{i + 10U, i + 11U});
+          } else {
+            w.push_back(key{i}, i + round);
+          }
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto& w = c.add_writer();
+  CHECK_THROWS(w.push_back(key{1U}, 0U));  // owned by another writer
+  CHECK_THROWS(w.push_back(key{num_keys}, 0U));
+
+  auto d = pvv_t{};
+  c.merge(d);
+  REQUIRE(d.size() == num_keys);
+
+  auto const check = [&]() {
+    for (auto i = 0U; i != num_keys; ++i) {
+      auto const b = d[key{i}];
+      if (b.size() != (i % 7U == 0U ? 0U : 20U)) {
+        return false;
+      }
+      for (auto j = 0U; j != b.size(); ++j) {
+        if (b[j] != i + j) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  CHECK(check());
+
+  auto size = std::size_t{0U};
+  for (auto i = 0U; i != num_keys; ++i) {
+    size += d.page(key{i}).capacity_;
+  }
+  CHECK(d.paged_.data_.size() == size);  // no holes
+
+  d[key{7U}].push_back(1U);
+  CHECK(d[key{7U}].size() == 1U);
+  CHECK(check() == false);
+}
+
+TEST_CASE("concurrent_paged_vecvec claim") {
+  using key = cista::strong<unsigned, struct x_>;
+  using data_t = cista::paged<cista::raw::vector<std::uint32_t>>;
+  using idx_t = cista::raw::vector<data_t::page_t>;
+  using pvv_t = cista::paged_vecvec<idx_t, data_t, key>;
+
+  constexpr auto const num_threads = 4U;
+  constexpr auto const num_keys = 10'000U;
+
+  // All writers race for all buckets: every bucket gets exactly one owner.
+  auto c = cista::concurrent_paged_vecvec<idx_t, data_t, key>{num_keys};
+  auto threads = std::vector<std::thread>{};
+  for (auto t = 0U; t != num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      auto& w = c.add_writer();
+      for (auto i = 0U; i != num_keys; ++i) {
+        try {
+          w.push_back(key{i}, t);
+        } catch (...) {
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto d = pvv_t{};
+  c.merge(d);
+  auto ok = true;
+  for (auto i = 0U; i != num_keys; ++i) {
+    ok = ok && d[key{i}].size() == 1U;
+  }
+  CHECK(ok);
+}